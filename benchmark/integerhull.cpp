@@ -0,0 +1,189 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Times IntegerHull against IntegerHullByLatticeScan on convex
+ * polygons with rational vertices whose coordinates grow by powers of ten.
+ * The scan visits every lattice point of the bounding box, so it only runs
+ * while that box holds at most scan_limit of them; where both run, the
+ * hulls must agree, and mismatches are counted.
+ *
+ * Usage: integer_hull_benchmark [max_exponent] [scan_limit]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+
+#include "../geometry/common.h"
+#include "../geometry/point.h"
+#include "../geometry/polygon.h"
+#include "../geometry/hull.h"
+
+_INITIALIZE_EASYLOGGINGPP
+
+using namespace DDAD;
+
+//=============================================================================
+// Inputs
+//=============================================================================
+
+static rational Ratio(const mpz_class& n, const mpz_class& d) {
+    mpq_class q(n, d);
+    q.canonicalize();
+    return rational(q);
+}
+
+//! @brief Uniform integer in [-s, s].
+static mpz_class Uniform(gmp_randclass& rng, const mpz_class& s) {
+    return rng.get_z_range(2*s+1)-s;
+}
+
+static Polygon_2r ToPolygon(const std::vector<Point_2r>& points) {
+    Polygon_2r P;
+    for (const Point_2r& p : ParallelConvexHull<RationalKernel_2>(points, 1)) {
+        P.push_back(p);
+    }
+    return P;
+}
+
+//! @brief Hull of 12 points with denominators 7 and 3 in [-s, s]^2.
+static Polygon_2r Random(gmp_randclass& rng, const mpz_class& s) {
+    std::vector<Point_2r> points;
+    for (int i = 0; i < 12; ++i) {
+        points.push_back(Point_2r(Ratio(Uniform(rng, 7*s), 7),
+                                  Ratio(Uniform(rng, 3*s), 3)));
+    }
+    return ToPolygon(points);
+}
+
+//! @brief A sliver triangle of width about 1 and length about s along a
+//! slope of 355/113, whose lattice points follow a continued fraction.
+static Polygon_2r Sliver(gmp_randclass&, const mpz_class& s) {
+    std::vector<Point_2r> points;
+    points.push_back(Point_2r(Ratio(1, 3), Ratio(1, 5)));
+    points.push_back(Point_2r(Ratio(113*s, 1), Ratio(355*s+1, 2)));
+    points.push_back(Point_2r(Ratio(113*s, 1), Ratio(355*s+3, 2)));
+    points.push_back(Point_2r(Ratio(-1, 4), Ratio(3, 2)));
+    return ToPolygon(points);
+}
+
+//! @brief Hull of 64 points near the circle of radius s, which has many
+//! vertices.
+static Polygon_2r Round(gmp_randclass& rng, const mpz_class& s) {
+    std::vector<Point_2r> points;
+    for (int i = 0; i < 64; ++i) {
+        mpz_class x = Uniform(rng, s);
+        mpz_class y;
+        mpz_sqrt(y.get_mpz_t(), mpz_class(s*s-x*x).get_mpz_t());
+        if (i % 2) {
+            y = -y;
+        }
+        points.push_back(Point_2r(Ratio(2*x+1, 2), Ratio(3*y+1, 3)));
+    }
+    return ToPolygon(points);
+}
+
+//=============================================================================
+// Timing
+//=============================================================================
+
+typedef std::function<Polygon_2r(gmp_randclass&, const mpz_class&)> Family;
+
+//! @brief Roughly the number of lattice points in the bounding box of P.
+static double BoxPoints(const Polygon_2r& P) {
+    double x_min = P[0]->x().get_d(), x_max = x_min;
+    double y_min = P[0]->y().get_d(), y_max = y_min;
+    for (size_t i = 1; i < P.size(); ++i) {
+        x_min = std::min(x_min, P[i]->x().get_d());
+        x_max = std::max(x_max, P[i]->x().get_d());
+        y_min = std::min(y_min, P[i]->y().get_d());
+        y_max = std::max(y_max, P[i]->y().get_d());
+    }
+    return (x_max-x_min+1)*(y_max-y_min+1);
+}
+
+//! @brief Returns f() and sets ms to the time it took.
+template <class Function>
+static auto Time(const Function& f, double& ms) -> decltype(f()) {
+    auto start = std::chrono::steady_clock::now();
+    auto result = f();
+    auto stop = std::chrono::steady_clock::now();
+    ms = std::chrono::duration<double, std::milli>(stop-start).count();
+    return result;
+}
+
+static bool SameVertices(const Polygon_2r& a, const Polygon_2r& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (*a[i] != *b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void Run(const std::string& name, const Family& family,
+                const int max_exponent, const double scan_limit) {
+    gmp_randclass rng(gmp_randinit_default);
+    rng.seed(1);
+    for (int e = 1; e <= max_exponent; ++e) {
+        mpz_class s;
+        mpz_ui_pow_ui(s.get_mpz_t(), 10, e);
+        Polygon_2r P = family(rng, s);
+
+        double ms;
+        Polygon_2r ihull = Time([&]() { return IntegerHull(P); }, ms);
+        std::cout << std::left << std::setw(10) << name << std::right
+                  << std::setw(6) << ("1e"+std::to_string(e))
+                  << std::setw(6) << P.size()
+                  << std::setw(8) << (ihull.size() > 1 ? ihull.size()-1 :
+                                                         ihull.size())
+                  << std::setw(12) << std::fixed << std::setprecision(2)
+                  << ms;
+        if (BoxPoints(P) <= scan_limit) {
+            double scan_ms;
+            Polygon_2r scan = Time([&]() {
+                return IntegerHullByLatticeScan(P);
+            }, scan_ms);
+            std::cout << std::setw(12) << scan_ms
+                      << std::setw(10) << !SameVertices(ihull, scan) << "\n";
+        } else {
+            std::cout << std::setw(12) << "-" << std::setw(10) << "-" << "\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    el::Loggers::reconfigureAllLoggers(el::ConfigurationType::Enabled,
+                                       "false");
+    const int max_exponent = argc > 1 ? std::atoi(argv[1]) : 18;
+    const double scan_limit = argc > 2 ? std::atof(argv[2]) : 1e6;
+
+    std::cout << std::left << std::setw(10) << "polygon" << std::right
+              << std::setw(6) << "size" << std::setw(6) << "n"
+              << std::setw(8) << "m" << std::setw(12) << "wedge ms"
+              << std::setw(12) << "scan ms" << std::setw(10) << "mismatch"
+              << "\n";
+
+    Run("random", Random, max_exponent, scan_limit);
+    Run("sliver", Sliver, max_exponent, scan_limit);
+    Run("round", Round, max_exponent, scan_limit);
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Times the expansion predicates on float points against the rational
+ * path the workbench takes today, i.e. converting to Point_3r first. The
+ * rational side runs with the double filter disabled, so it measures the
+ * cost every filter failure used to pay. Also counts disagreements, which
+ * must be zero.
+ *
+ * Usage: predicate_benchmark [count]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <random>
+
+#include "../geometry/common.h"
+#include "../geometry/point.h"
+#include "../geometry/matrix.h"
+#include "../geometry/predicate.h"
+#include "../geometry/expansion.h"
+
+_INITIALIZE_EASYLOGGINGPP
+
+using namespace DDAD;
+
+static Sign ToSign(const rational& r) {
+    return r > 0 ? SIGN_POSITIVE : (r < 0 ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+static Sign RationalOrient3D(const Point_3r& a, const Point_3r& b,
+                             const Point_3r& c, const Point_3r& d) {
+    return ToSign(Determinant(Matrix_3x3r(
+        a.x()-d.x(), a.y()-d.y(), a.z()-d.z(),
+        b.x()-d.x(), b.y()-d.y(), b.z()-d.z(),
+        c.x()-d.x(), c.y()-d.y(), c.z()-d.z()
+    )));
+}
+
+//! @brief The lifted 4x4 determinant, expanded along the lift column.
+static Sign RationalInSphere(const Point_3r& a, const Point_3r& b,
+                             const Point_3r& c, const Point_3r& d,
+                             const Point_3r& e) {
+    const Point_3r* p[4] = { &a, &b, &c, &d };
+    rational x[4], y[4], z[4], lift[4];
+    for (int i = 0; i < 4; ++i) {
+        x[i] = p[i]->x()-e.x();
+        y[i] = p[i]->y()-e.y();
+        z[i] = p[i]->z()-e.z();
+        lift[i] = x[i]*x[i]+y[i]*y[i]+z[i]*z[i];
+    }
+    rational det = 0;
+    for (int i = 0; i < 4; ++i) {
+        int r[3], k = 0;
+        for (int j = 0; j < 4; ++j) {
+            if (j != i) {
+                r[k++] = j;
+            }
+        }
+        rational minor = Determinant(Matrix_3x3r(
+            x[r[0]], y[r[0]], z[r[0]],
+            x[r[1]], y[r[1]], z[r[1]],
+            x[r[2]], y[r[2]], z[r[2]]
+        ));
+        if (i % 2 == 0) {
+            det -= lift[i]*minor;
+        } else {
+            det += lift[i]*minor;
+        }
+    }
+    return ToSign(det);
+}
+
+//=============================================================================
+// Inputs
+//=============================================================================
+
+struct Inputs {
+    std::vector<Point_3f> points;
+    int arity;
+};
+
+static Point_3f RandomPoint(std::mt19937& rng) {
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    return Point_3f(u(rng), u(rng), u(rng));
+}
+
+//! @brief Moves the last point one ulp in x half of the time, so the inputs
+//! straddle the degenerate configuration.
+static void Nudge(std::mt19937& rng, std::vector<Point_3f>& points) {
+    if (rng() % 2) {
+        Point_3f& p = points.back();
+        p.set_x(std::nextafter(p.x(), 2.0f));
+    }
+}
+
+//! @brief Groups of arity uniformly random points.
+static Inputs Random(const int count, const int arity) {
+    std::mt19937 rng(1);
+    Inputs in = { {}, arity };
+    for (int i = 0; i < count*arity; ++i) {
+        in.points.push_back(RandomPoint(rng));
+    }
+    return in;
+}
+
+/*!
+ * @brief Groups whose last point lies exactly on the line or plane through
+ * the others, or one ulp off it. Coordinates sit on a 2^-12 grid so the
+ * affine combinations are representable.
+ */
+static Inputs Flat(const int count, const int arity) {
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> grid(-4096, 4096);
+    std::uniform_int_distribution<int> step(-3, 3);
+    auto point = [&]() {
+        return Point_3f(std::ldexp(static_cast<float>(grid(rng)), -12),
+                        std::ldexp(static_cast<float>(grid(rng)), -12),
+                        std::ldexp(static_cast<float>(grid(rng)), -12));
+    };
+    Inputs in = { {}, arity };
+    for (int i = 0; i < count; ++i) {
+        Point_3f a = point(), b = point(), c = point();
+        float s = static_cast<float>(step(rng));
+        float u = arity == 4 ? static_cast<float>(step(rng)) : 0.0f;
+        in.points.push_back(a);
+        in.points.push_back(b);
+        if (arity == 4) {
+            in.points.push_back(c);
+        }
+        in.points.push_back(Point_3f(a.x()+s*(b.x()-a.x())+u*(c.x()-a.x()),
+                                     a.y()+s*(b.y()-a.y())+u*(c.y()-a.y()),
+                                     a.z()+s*(b.z()-a.z())+u*(c.z()-a.z())));
+        Nudge(rng, in.points);
+    }
+    return in;
+}
+
+/*!
+ * @brief Groups on a common circle (z = 0) or sphere of radius 5 or 3 about
+ * a random grid center, or one ulp off it. The points are integer solutions
+ * of x^2+y^2 = 25 and x^2+y^2+z^2 = 9, so they are exactly cocircular and
+ * cospherical.
+ */
+static Inputs Round(const int count, const int arity, const bool planar) {
+    static const int kCircle[12][2] = {
+        { 5, 0 }, { -5, 0 }, { 0, 5 }, { 0, -5 }, { 3, 4 }, { -3, 4 },
+        { 3, -4 }, { -3, -4 }, { 4, 3 }, { -4, 3 }, { 4, -3 }, { -4, -3 }
+    };
+    static const int kSphere[12][3] = {
+        { 3, 0, 0 }, { 0, 3, 0 }, { 0, 0, -3 }, { 1, 2, 2 }, { -1, 2, 2 },
+        { 2, -1, 2 }, { 2, 2, -1 }, { -2, -2, 1 }, { 1, -2, -2 },
+        { -2, 1, -2 }, { 2, -2, 1 }, { -1, -2, 2 }
+    };
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> grid(-1000, 1000);
+    Inputs in = { {}, arity };
+    for (int i = 0; i < count; ++i) {
+        float cx = static_cast<float>(grid(rng));
+        float cy = static_cast<float>(grid(rng));
+        float cz = planar ? 0.0f : static_cast<float>(grid(rng));
+        std::vector<int> picks(12);
+        for (int k = 0; k < 12; ++k) {
+            picks[k] = k;
+        }
+        std::shuffle(picks.begin(), picks.end(), rng);
+        for (int k = 0; k < arity; ++k) {
+            int j = picks[k];
+            in.points.push_back(planar ?
+                Point_3f(cx+kCircle[j][0], cy+kCircle[j][1], 0.0f) :
+                Point_3f(cx+kSphere[j][0], cy+kSphere[j][1],
+                         cz+kSphere[j][2]));
+        }
+        Nudge(rng, in.points);
+    }
+    return in;
+}
+
+//=============================================================================
+// Timing
+//=============================================================================
+
+typedef std::function<Sign(const Point_3f*)> FloatPredicate;
+typedef std::function<Sign(const Point_3r*)> RationalPredicate;
+
+template <class Point, class Predicate>
+static double Time(const std::vector<Point>& points, const int arity,
+                   const Predicate& predicate, std::vector<Sign>& signs) {
+    signs.clear();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i+arity <= points.size(); i += arity) {
+        signs.push_back(predicate(&points[i]));
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop-start).count();
+}
+
+static void Run(const std::string& name, const Inputs& in,
+                const FloatPredicate& expansion,
+                const RationalPredicate& exact) {
+    std::vector<Point_3r> rpoints(in.points.begin(), in.points.end());
+    std::vector<Sign> esigns, rsigns;
+
+    Predicate::set_filtering_enabled(false);
+    double rms = Time(rpoints, in.arity, exact, rsigns);
+    Predicate::set_filtering_enabled(true);
+    double ems = Time(in.points, in.arity, expansion, esigns);
+
+    int degenerate = 0, mismatches = 0;
+    for (size_t i = 0; i < esigns.size(); ++i) {
+        degenerate += esigns[i] == SIGN_ZERO;
+        mismatches += esigns[i] != rsigns[i];
+    }
+    std::cout << std::left << std::setw(24) << name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(2) << ems
+              << std::setw(12) << rms
+              << std::setw(10) << std::setprecision(1) << rms/ems << "x"
+              << std::setw(10) << degenerate
+              << std::setw(10) << mismatches << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    el::Loggers::reconfigureAllLoggers(el::ConfigurationType::Enabled,
+                                       "false");
+    const int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    auto orient2d = [](const Point_3f* p) {
+        return Predicate::Orient2DSign(Point_2f(p[0].x(), p[0].y()),
+                                       Point_2f(p[1].x(), p[1].y()),
+                                       Point_2f(p[2].x(), p[2].y()));
+    };
+    auto orient2d_r = [](const Point_3r* p) {
+        return Predicate::Orient2DSign(p[0], p[1], p[2]);
+    };
+    auto incircle = [](const Point_3f* p) {
+        return Predicate::InCircleSign(Point_2f(p[0].x(), p[0].y()),
+                                       Point_2f(p[1].x(), p[1].y()),
+                                       Point_2f(p[2].x(), p[2].y()),
+                                       Point_2f(p[3].x(), p[3].y()));
+    };
+    auto incircle_r = [](const Point_3r* p) {
+        return Predicate::InCircleSign(p[0], p[1], p[2], p[3]);
+    };
+    auto orient3d = [](const Point_3f* p) {
+        return Predicate::Orient3DSign(p[0], p[1], p[2], p[3]);
+    };
+    auto orient3d_r = [](const Point_3r* p) {
+        return RationalOrient3D(p[0], p[1], p[2], p[3]);
+    };
+    auto insphere = [](const Point_3f* p) {
+        return Predicate::InSphereSign(p[0], p[1], p[2], p[3], p[4]);
+    };
+    auto insphere_r = [](const Point_3r* p) {
+        return RationalInSphere(p[0], p[1], p[2], p[3], p[4]);
+    };
+
+    std::cout << std::left << std::setw(24) << "predicate" << std::right
+              << std::setw(12) << "expansion" << std::setw(12) << "rational"
+              << std::setw(11) << "speedup" << std::setw(10) << "zero"
+              << std::setw(10) << "mismatch" << "\n";
+
+    Run("orient2d random", Random(count, 3), orient2d, orient2d_r);
+    Run("orient2d colinear", Flat(count, 3), orient2d, orient2d_r);
+    Run("incircle random", Random(count, 4), incircle, incircle_r);
+    Run("incircle cocircular", Round(count, 4, true), incircle,
+        incircle_r);
+    Run("orient3d random", Random(count, 4), orient3d, orient3d_r);
+    Run("orient3d coplanar", Flat(count, 4), orient3d, orient3d_r);
+    Run("insphere random", Random(count, 5), insphere, insphere_r);
+    Run("insphere cospherical", Round(count, 5, false), insphere,
+        insphere_r);
+
+    return 0;
+}
@@ -0,0 +1,1002 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Randomized self-checks of the exact kernels against references
+ * written here in plain mpz_class and mpq_class:
+ *
+ *   - ModularDeterminant against cofactor expansion, on matrices at and
+ *     next to the Hadamard bound and beyond the prime table;
+ *   - Bareiss determinant, sign, rank and solve over the integers and the
+ *     rationals against Gaussian elimination in mpq_class;
+ *   - HermiteNormalForm and LLLReduce against the defining invariants of
+ *     their outputs, with an exact Gram-Schmidt for LLL;
+ *   - ParallelConvexHullIndices against a serial monotone chain, on
+ *     inputs with duplicate and collinear points;
+ *   - Melkman and OnlineMelkman against the same monotone chain, on simple
+ *     polylines that start with a run of collinear and repeated vertices,
+ *     and OnlineMelkman on point sequences that cross themselves;
+ *   - IntegerHull against IntegerHullByLatticeScan.
+ *
+ * Usage: self_check [rounds] [seed]
+ *
+ * Prints the cases and failures of each check and exits with status 1 if
+ * any failed.
+ */
+
+#include <cstdlib>
+#include <iomanip>
+
+#include "../geometry/common.h"
+#include "../geometry/point.h"
+#include "../geometry/polygon.h"
+#include "../geometry/hull.h"
+#include "../geometry/kernel.h"
+#include "../geometry/modular.h"
+#include "../geometry/bareiss.h"
+#include "../geometry/lattice.h"
+
+_INITIALIZE_EASYLOGGINGPP
+
+using namespace DDAD;
+
+//=============================================================================
+// Checks
+//=============================================================================
+
+struct Check {
+    std::string name;
+    int cases;
+    int failures;
+};
+
+static Check MakeCheck(const std::string& name) {
+    Check check = { name, 0, 0 };
+    return check;
+}
+
+//! @brief Counts a failure and describes the first few of each check.
+static void Expect(Check& check, const bool ok, const std::string& what) {
+    if (!ok && ++check.failures <= 5) {
+        std::cerr << check.name << ": " << what << "\n";
+    }
+}
+
+//=============================================================================
+// References
+//=============================================================================
+
+//! @brief Row-major matrices.
+typedef std::vector<mpz_class> MatrixZ;
+typedef std::vector<mpq_class> MatrixQ;
+
+//! @brief Uniform integer in [-s, s].
+static mpz_class Uniform(gmp_randclass& rng, const mpz_class& s) {
+    return rng.get_z_range(2*s+1)-s;
+}
+
+//! @brief Uniform integer below 2^bits in magnitude.
+static mpz_class UniformBits(gmp_randclass& rng, const int bits) {
+    mpz_class s = (mpz_class(1) << bits)-1;
+    return Uniform(rng, s);
+}
+
+static int UniformInt(gmp_randclass& rng, const int lo, const int hi) {
+    mpz_class r = rng.get_z_range(hi-lo+1);
+    return lo+static_cast<int>(r.get_si());
+}
+
+static mpz_class ToMpz(const integer& x) {
+    return mpz_class(x.get_mpz_t());
+}
+
+static Sign SignOf(const mpz_class& x) {
+    return sgn(x) > 0 ? SIGN_POSITIVE : (sgn(x) < 0 ? SIGN_NEGATIVE :
+                                                      SIGN_ZERO);
+}
+
+static Sign SignOf(const mpq_class& x) {
+    return sgn(x) > 0 ? SIGN_POSITIVE : (sgn(x) < 0 ? SIGN_NEGATIVE :
+                                                      SIGN_ZERO);
+}
+
+//! @brief Column-major copy of the row-major matrix a in the kernel's type.
+template <class T, class U>
+static std::vector<T> ColumnMajor(const std::vector<U>& a, const int rows,
+                                  const int cols) {
+    std::vector<T> out(rows*cols);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            out[j*rows+i] = T(a[i*cols+j]);
+        }
+    }
+    return out;
+}
+
+//! @brief Laplace expansion along the first row.
+static mpz_class CofactorDeterminant(const MatrixZ& a, const int n) {
+    if (n == 0) {
+        return 1;
+    }
+    mpz_class det = 0;
+    MatrixZ minor((n-1)*(n-1));
+    for (int j = 0; j < n; ++j) {
+        if (a[j] == 0) {
+            continue;
+        }
+        for (int r = 1; r < n; ++r) {
+            int m = 0;
+            for (int c = 0; c < n; ++c) {
+                if (c != j) {
+                    minor[(r-1)*(n-1)+m++] = a[r*n+c];
+                }
+            }
+        }
+        mpz_class term = a[j]*CofactorDeterminant(minor, n-1);
+        if (j % 2) {
+            det -= term;
+        } else {
+            det += term;
+        }
+    }
+    return det;
+}
+
+//! @brief Replaces row target by a random combination of two other rows.
+template <class T>
+static void MakeDependent(gmp_randclass& rng, std::vector<T>& a,
+                          const int rows, const int cols, const int target) {
+    int i = UniformInt(rng, 0, rows-1);
+    int k = UniformInt(rng, 0, rows-1);
+    T s = T(UniformBits(rng, 4));
+    T t = T(UniformBits(rng, 4));
+    std::vector<T> row(cols);
+    for (int j = 0; j < cols; ++j) {
+        row[j] = s*a[i*cols+j]+t*a[k*cols+j];
+    }
+    for (int j = 0; j < cols; ++j) {
+        a[target*cols+j] = row[j];
+    }
+    if (i == target && k == target) {
+        for (int j = 0; j < cols; ++j) {
+            a[target*cols+j] = 0;
+        }
+    }
+}
+
+//=============================================================================
+// ModularDeterminant
+//=============================================================================
+
+//! @brief Sylvester's Hadamard matrix of order n, a power of two.
+static MatrixZ Sylvester(const int n) {
+    MatrixZ h(n*n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            int parity = 0;
+            for (int b = i & j; b; b >>= 1) {
+                parity ^= b & 1;
+            }
+            h[i*n+j] = parity ? -1 : 1;
+        }
+    }
+    return h;
+}
+
+static void ExpectDeterminant(Check& check, const MatrixZ& a, const int n) {
+    ++check.cases;
+    mpz_class det = CofactorDeterminant(a, n);
+    std::vector<integer> entries = ColumnMajor<integer>(a, n, n);
+    std::string where = std::to_string(n)+"x"+std::to_string(n)+" with "+
+                        std::to_string(mpz_sizeinbase(det.get_mpz_t(), 2))+
+                        "-bit determinant";
+    Expect(check, ToMpz(ModularDeterminant(entries.data(), n)) == det,
+           "ModularDeterminant of "+where);
+    Expect(check, ModularSignOfDeterminant(entries.data(), n) == SignOf(det),
+           "ModularSignOfDeterminant of "+where);
+    Expect(check, ToMpz(BareissDeterminant(entries.data(), n)) == det,
+           "BareissDeterminant of "+where);
+}
+
+/*!
+ * @brief Matrices at and next to the Hadamard bound, where the number of
+ * primes is decided, random ones of all sizes, singular ones, and entries
+ * beyond the prime table, which fall back to Bareiss.
+ */
+static Check CheckModularDeterminant(gmp_randclass& rng, const int rounds) {
+    Check check = MakeCheck("modular determinant");
+    const int bits[] = { 1, 2, 20, 31, 32, 61, 62, 63, 64, 100, 300 };
+    for (int round = 0; round < rounds; ++round) {
+        for (int n = 2; n <= 8; n *= 2) {
+            int b = bits[UniformInt(rng, 0, sizeof(bits)/sizeof(int)-1)];
+            mpz_class scale = (mpz_class(1) << b)-1;
+            MatrixZ a = Sylvester(n);
+            for (int i = 0; i < n; ++i) {
+                int flip = UniformInt(rng, 0, 1) ? -1 : 1;
+                for (int j = 0; j < n; ++j) {
+                    a[i*n+j] *= flip*scale;
+                }
+            }
+            ExpectDeterminant(check, a, n);
+            a[UniformInt(rng, 0, n*n-1)] -= UniformInt(rng, 0, 1) ? 1 : -1;
+            ExpectDeterminant(check, a, n);
+        }
+        for (int n = 1; n <= 7; ++n) {
+            int b = UniformInt(rng, 1, 200);
+            mpz_class scale = (mpz_class(1) << b)-1;
+            MatrixZ a(n*n), signs(n*n);
+            for (int i = 0; i < n*n; ++i) {
+                a[i] = UniformBits(rng, b);
+                signs[i] = UniformInt(rng, 0, 1) ? scale : mpz_class(-scale);
+            }
+            ExpectDeterminant(check, a, n);
+            ExpectDeterminant(check, signs, n);
+            if (n > 1) {
+                MakeDependent(rng, a, n, n, UniformInt(rng, 0, n-1));
+                ExpectDeterminant(check, a, n);
+            }
+        }
+        if (round % 10 == 0) {
+            int n = UniformInt(rng, 2, 4);
+            MatrixZ a(n*n);
+            for (int i = 0; i < n*n; ++i) {
+                a[i] = UniformBits(rng, UniformInt(rng, 1000, 6000));
+            }
+            ExpectDeterminant(check, a, n);
+        }
+    }
+    return check;
+}
+
+//=============================================================================
+// Bareiss
+//=============================================================================
+
+/*!
+ * @brief Rank of the rows x cols matrix a by Gaussian elimination over the
+ * rationals; det is its determinant if it is square and zero otherwise.
+ */
+static int RationalRank(MatrixQ a, const int rows, const int cols,
+                        mpq_class& det) {
+    det = 1;
+    int rank = 0;
+    for (int col = 0; col < cols && rank < rows; ++col) {
+        int pivot = rank;
+        while (pivot < rows && a[pivot*cols+col] == 0) {
+            ++pivot;
+        }
+        if (pivot == rows) {
+            continue;
+        }
+        if (pivot != rank) {
+            for (int j = 0; j < cols; ++j) {
+                std::swap(a[pivot*cols+j], a[rank*cols+j]);
+            }
+            det = -det;
+        }
+        det *= a[rank*cols+col];
+        for (int i = rank+1; i < rows; ++i) {
+            if (a[i*cols+col] == 0) {
+                continue;
+            }
+            mpq_class f = a[i*cols+col]/a[rank*cols+col];
+            for (int j = col; j < cols; ++j) {
+                a[i*cols+j] -= f*a[rank*cols+j];
+            }
+        }
+        ++rank;
+    }
+    if (rows != cols || rank < rows) {
+        det = 0;
+    }
+    return rank;
+}
+
+//! @brief Solves a*x = b by Gauss-Jordan elimination; false if singular.
+static bool RationalSolve(MatrixQ a, std::vector<mpq_class> b, const int n,
+                          std::vector<mpq_class>& x) {
+    for (int k = 0; k < n; ++k) {
+        int pivot = k;
+        while (pivot < n && a[pivot*n+k] == 0) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            return false;
+        }
+        for (int j = 0; j < n; ++j) {
+            std::swap(a[pivot*n+j], a[k*n+j]);
+        }
+        std::swap(b[pivot], b[k]);
+        for (int i = 0; i < n; ++i) {
+            if (i == k || a[i*n+k] == 0) {
+                continue;
+            }
+            mpq_class f = a[i*n+k]/a[k*n+k];
+            for (int j = k; j < n; ++j) {
+                a[i*n+j] -= f*a[k*n+j];
+            }
+            b[i] -= f*b[k];
+        }
+    }
+    x.resize(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = b[i]/a[i*n+i];
+    }
+    return true;
+}
+
+template <class T>
+static std::vector<mpq_class> ToRational(const std::vector<T>& a) {
+    return std::vector<mpq_class>(a.begin(), a.end());
+}
+
+static std::string Shape(const int rows, const int cols) {
+    return std::to_string(rows)+"x"+std::to_string(cols);
+}
+
+//! @brief Rational matrices, square and rectangular, of full and lower rank.
+static Check CheckBareissRational(gmp_randclass& rng, const int rounds) {
+    Check check = MakeCheck("bareiss over rationals");
+    for (int round = 0; round < rounds; ++round) {
+        int rows = UniformInt(rng, 1, 6);
+        int cols = round % 2 ? rows : UniformInt(rng, 1, 6);
+        MatrixQ a(rows*cols);
+        for (auto& entry : a) {
+            entry = mpq_class(UniformBits(rng, UniformInt(rng, 1, 80)),
+                              1+rng.get_z_bits(UniformInt(rng, 1, 20)));
+            entry.canonicalize();
+        }
+        if (rows > 1 && UniformInt(rng, 0, 2) == 0) {
+            MakeDependent(rng, a, rows, cols, UniformInt(rng, 0, rows-1));
+        }
+        ++check.cases;
+        mpq_class det;
+        int rank = RationalRank(a, rows, cols, det);
+        std::vector<rational> entries = ColumnMajor<rational>(a, rows, cols);
+        Expect(check, BareissRank(entries.data(), rows, cols) == rank,
+               "BareissRank of "+Shape(rows, cols));
+        if (rows != cols) {
+            continue;
+        }
+        const int n = rows;
+        Expect(check, BareissDeterminant(entries.data(), n) == rational(det),
+               "BareissDeterminant of "+Shape(n, n));
+        Expect(check, BareissSignOfDeterminant(entries.data(), n) ==
+                      SignOf(det), "BareissSignOfDeterminant of "+Shape(n, n));
+
+        std::vector<mpq_class> b(n), x;
+        std::vector<rational> rhs(n), solution(n);
+        for (int i = 0; i < n; ++i) {
+            b[i] = mpq_class(UniformBits(rng, 30), 1+rng.get_z_bits(10));
+            b[i].canonicalize();
+            rhs[i] = rational(b[i]);
+        }
+        bool solved = RationalSolve(a, b, n, x);
+        bool ok = BareissSolve(entries.data(), rhs.data(), n,
+                               solution.data());
+        Expect(check, ok == solved, "BareissSolve singularity of "+
+                                    Shape(n, n));
+        for (int i = 0; ok && solved && i < n; ++i) {
+            Expect(check, solution[i] == rational(x[i]),
+                   "BareissSolve of "+Shape(n, n));
+        }
+    }
+    return check;
+}
+
+//! @brief Integer matrices against cofactor expansion and Cramer's rule.
+static Check CheckBareissInteger(gmp_randclass& rng, const int rounds) {
+    Check check = MakeCheck("bareiss over integers");
+    for (int round = 0; round < rounds; ++round) {
+        const int n = UniformInt(rng, 1, 6);
+        MatrixZ a(n*n);
+        for (auto& entry : a) {
+            entry = UniformBits(rng, UniformInt(rng, 1, 100));
+        }
+        if (n > 1 && UniformInt(rng, 0, 3) == 0) {
+            MakeDependent(rng, a, n, n, UniformInt(rng, 0, n-1));
+        }
+        ++check.cases;
+        mpz_class det = CofactorDeterminant(a, n);
+        mpq_class rational_det;
+        int rank = RationalRank(ToRational(a), n, n, rational_det);
+        std::vector<integer> entries = ColumnMajor<integer>(a, n, n);
+        Expect(check, ToMpz(BareissDeterminant(entries.data(), n)) == det,
+               "BareissDeterminant of "+Shape(n, n));
+        Expect(check, BareissSignOfDeterminant(entries.data(), n) ==
+                      SignOf(det), "BareissSignOfDeterminant of "+Shape(n, n));
+        Expect(check, BareissRank(entries.data(), n, n) == rank,
+               "BareissRank of "+Shape(n, n));
+
+        MatrixZ b(n);
+        std::vector<integer> rhs(n), numerators(n);
+        for (int i = 0; i < n; ++i) {
+            b[i] = UniformBits(rng, 40);
+            rhs[i] = integer(b[i]);
+        }
+        std::vector<mpq_class> x;
+        bool solved = RationalSolve(ToRational(a), ToRational(b), n, x);
+        integer denominator;
+        bool ok = BareissSolve(entries.data(), rhs.data(), n,
+                               numerators.data(), denominator);
+        Expect(check, ok == solved, "BareissSolve singularity of "+
+                                    Shape(n, n));
+        if (!ok || !solved) {
+            continue;
+        }
+        mpz_class d = ToMpz(denominator);
+        Expect(check, abs(d) == abs(det), "BareissSolve denominator of "+
+                                          Shape(n, n));
+        for (int i = 0; i < n; ++i) {
+            mpq_class xi(ToMpz(numerators[i]), d);
+            xi.canonicalize();
+            Expect(check, xi == x[i], "BareissSolve of "+Shape(n, n));
+        }
+    }
+    return check;
+}
+
+//=============================================================================
+// Hermite normal form and LLL
+//=============================================================================
+
+//! @brief Row-major copy of the column-major kernel matrix a.
+static MatrixZ RowMajor(const std::vector<integer>& a, const int rows,
+                        const int cols) {
+    MatrixZ out(rows*cols);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            out[i*cols+j] = ToMpz(a[j*rows+i]);
+        }
+    }
+    return out;
+}
+
+static MatrixZ Multiply(const MatrixZ& a, const MatrixZ& b, const int rows,
+                        const int inner, const int cols) {
+    MatrixZ c(rows*cols);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            for (int k = 0; k < inner; ++k) {
+                c[i*cols+j] += a[i*inner+k]*b[k*cols+j];
+            }
+        }
+    }
+    return c;
+}
+
+static bool IsUnimodular(const MatrixZ& u, const int n) {
+    return abs(CofactorDeterminant(u, n)) == 1;
+}
+
+//! @brief Echelon form with positive pivots, entries above each pivot
+//! reduced into [0, pivot) and zero rows last. Returns the nonzero rows.
+static int HermiteRows(const MatrixZ& h, const int rows, const int cols,
+                       bool& ok) {
+    ok = true;
+    int nonzero = 0;
+    int last_pivot = -1;
+    for (int i = 0; i < rows; ++i) {
+        int pivot = 0;
+        while (pivot < cols && h[i*cols+pivot] == 0) {
+            ++pivot;
+        }
+        if (pivot == cols) {
+            continue;
+        }
+        if (nonzero != i || pivot <= last_pivot || h[i*cols+pivot] <= 0) {
+            ok = false;
+        }
+        for (int k = 0; k < i; ++k) {
+            if (h[k*cols+pivot] < 0 ||
+                h[k*cols+pivot] >= h[i*cols+pivot]) {
+                ok = false;
+            }
+        }
+        last_pivot = pivot;
+        ++nonzero;
+    }
+    return nonzero;
+}
+
+static Check CheckHermiteNormalForm(gmp_randclass& rng, const int rounds) {
+    Check check = MakeCheck("hermite normal form");
+    for (int round = 0; round < rounds; ++round) {
+        const int rows = UniformInt(rng, 1, 5);
+        const int cols = UniformInt(rng, 1, 5);
+        MatrixZ a(rows*cols);
+        for (auto& entry : a) {
+            entry = UniformBits(rng, UniformInt(rng, 1, 40));
+        }
+        if (rows > 1 && UniformInt(rng, 0, 2) == 0) {
+            MakeDependent(rng, a, rows, cols, UniformInt(rng, 0, rows-1));
+        }
+        ++check.cases;
+        std::vector<integer> entries = ColumnMajor<integer>(a, rows, cols);
+        std::vector<integer> hnf(rows*cols), transform(rows*rows);
+        HermiteNormalForm(entries.data(), rows, cols, hnf.data(),
+                          transform.data());
+        MatrixZ h = RowMajor(hnf, rows, cols);
+        MatrixZ u = RowMajor(transform, rows, rows);
+        mpq_class det;
+        int rank = RationalRank(ToRational(a), rows, cols, det);
+        bool echelon;
+        int nonzero = HermiteRows(h, rows, cols, echelon);
+
+        std::string where = " of "+Shape(rows, cols);
+        Expect(check, Multiply(u, a, rows, rows, cols) == h, "H != U*A"+where);
+        Expect(check, IsUnimodular(u, rows), "U not unimodular"+where);
+        Expect(check, echelon, "H not in Hermite normal form"+where);
+        Expect(check, nonzero == rank, "H has the wrong rank"+where);
+    }
+    return check;
+}
+
+/*!
+ * @brief Size reduction, |mu(i, j)| <= 1/2, and the Lovasz condition with
+ * delta = 3/4, from an exact Gram-Schmidt orthogonalization of b.
+ */
+static bool IsLLLReduced(const MatrixZ& b, const int rows, const int cols) {
+    MatrixQ star(rows*cols), mu(rows*rows);
+    std::vector<mpq_class> norm(rows);
+    for (int i = 0; i < rows; ++i) {
+        for (int k = 0; k < cols; ++k) {
+            star[i*cols+k] = b[i*cols+k];
+        }
+        for (int j = 0; j < i; ++j) {
+            mpq_class dot = 0;
+            for (int k = 0; k < cols; ++k) {
+                dot += b[i*cols+k]*star[j*cols+k];
+            }
+            mu[i*rows+j] = dot/norm[j];
+            for (int k = 0; k < cols; ++k) {
+                star[i*cols+k] -= mu[i*rows+j]*star[j*cols+k];
+            }
+        }
+        norm[i] = 0;
+        for (int k = 0; k < cols; ++k) {
+            norm[i] += star[i*cols+k]*star[i*cols+k];
+        }
+    }
+    const mpq_class half(1, 2), delta(3, 4);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < i; ++j) {
+            if (abs(mu[i*rows+j]) > half) {
+                return false;
+            }
+        }
+        if (i > 0 && norm[i] < (delta-mu[i*rows+i-1]*mu[i*rows+i-1])*
+                               norm[i-1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! @brief Random bases and knapsack-style bases [I | a], whose reduction
+//! has to find short vectors far from the input.
+static Check CheckLLLReduce(gmp_randclass& rng, const int rounds) {
+    Check check = MakeCheck("lll reduction");
+    for (int round = 0; round < rounds; ++round) {
+        int rows, cols;
+        MatrixZ a;
+        if (round % 2) {
+            rows = UniformInt(rng, 1, 4);
+            cols = UniformInt(rng, rows, 5);
+            a.resize(rows*cols);
+            for (auto& entry : a) {
+                entry = UniformBits(rng, UniformInt(rng, 1, 30));
+            }
+            if (rows > 1 && UniformInt(rng, 0, 4) == 0) {
+                MakeDependent(rng, a, rows, cols,
+                              UniformInt(rng, 0, rows-1));
+            }
+        } else {
+            rows = UniformInt(rng, 2, 4);
+            cols = rows+1;
+            a.assign(rows*cols, 0);
+            for (int i = 0; i < rows; ++i) {
+                a[i*cols+i] = 1;
+                a[i*cols+rows] = UniformBits(rng, UniformInt(rng, 20, 100));
+            }
+        }
+        ++check.cases;
+        mpq_class det;
+        int rank = RationalRank(ToRational(a), rows, cols, det);
+        std::vector<integer> entries = ColumnMajor<integer>(a, rows, cols);
+        std::vector<integer> reduced(rows*cols), transform(rows*rows);
+        bool ok = LLLReduce(entries.data(), rows, cols, reduced.data(),
+                            transform.data());
+
+        std::string where = " of "+Shape(rows, cols);
+        Expect(check, ok == (rank == rows), "LLLReduce independence"+where);
+        if (!ok || rank < rows) {
+            continue;
+        }
+        MatrixZ b = RowMajor(reduced, rows, cols);
+        MatrixZ u = RowMajor(transform, rows, rows);
+        Expect(check, Multiply(u, a, rows, rows, cols) == b, "B != U*A"+where);
+        Expect(check, IsUnimodular(u, rows), "U not unimodular"+where);
+        Expect(check, IsLLLReduced(b, rows, cols), "B not LLL-reduced"+where);
+    }
+    return check;
+}
+
+//=============================================================================
+// ParallelConvexHullIndices
+//=============================================================================
+
+struct PointZ {
+    mpz_class x;
+    mpz_class y;
+};
+
+static bool operator<(const PointZ& a, const PointZ& b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+static bool operator==(const PointZ& a, const PointZ& b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+static mpz_class Cross(const PointZ& o, const PointZ& a, const PointZ& b) {
+    return (a.x-o.x)*(b.y-o.y)-(a.y-o.y)*(b.x-o.x);
+}
+
+/*!
+ * @brief Andrew's monotone chain: strictly convex vertices, counterclockwise
+ * from the lexicographically smallest, each point once.
+ */
+static std::vector<PointZ> MonotoneChainHull(std::vector<PointZ> points) {
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    if (points.size() < 3) {
+        return points;
+    }
+    std::vector<PointZ> hull(2*points.size());
+    size_t k = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        while (k >= 2 && Cross(hull[k-2], hull[k-1], points[i]) <= 0) {
+            --k;
+        }
+        hull[k++] = points[i];
+    }
+    for (size_t i = points.size()-1, lower = k+1; i-- > 0; ) {
+        while (k >= lower && Cross(hull[k-2], hull[k-1], points[i]) <= 0) {
+            --k;
+        }
+        hull[k++] = points[i];
+    }
+    hull.resize(k-1);
+    return hull;
+}
+
+static std::vector<PointZ> RandomPoints(gmp_randclass& rng, const int count,
+                                        const int bits, const int shape) {
+    std::vector<PointZ> points(count);
+    mpz_class s = (mpz_class(1) << bits)-1;
+    for (auto& p : points) {
+        switch (shape) {
+        case 0:
+            p.x = Uniform(rng, s);
+            p.y = Uniform(rng, s);
+            break;
+        case 1: {
+            // near a circle, so that most points are hull vertices
+            p.x = Uniform(rng, s);
+            mpz_sqrt(p.y.get_mpz_t(), mpz_class(s*s-p.x*p.x).get_mpz_t());
+            if (UniformInt(rng, 0, 1)) {
+                p.y = -p.y;
+            }
+            break;
+        }
+        case 2:
+            // on one line, with repeats
+            p.x = Uniform(rng, 8);
+            p.y = 3*p.x+s;
+            break;
+        default:
+            // a small grid, full of repeats and collinear triples
+            p.x = Uniform(rng, 2);
+            p.y = Uniform(rng, 2);
+            break;
+        }
+    }
+    return points;
+}
+
+template <class Kernel, class Convert>
+static bool SameHull(const std::vector<PointZ>& points,
+                     const std::vector<PointZ>& expected,
+                     const size_t threads, Convert convert) {
+    std::vector<typename Kernel::Point_2> converted;
+    for (const PointZ& p : points) {
+        converted.push_back(convert(p));
+    }
+    std::vector<size_t> hull = ParallelConvexHullIndices<Kernel>(
+        converted.data(), converted.size(), threads);
+    if (hull.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < hull.size(); ++i) {
+        if (!(points[hull[i]] == expected[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static Check CheckParallelConvexHull(gmp_randclass& rng, const int rounds) {
+    Check check = MakeCheck("parallel convex hull");
+    const int counts[] = { 1, 2, 3, 5, 20, 300, 5000 };
+    const int bits[] = { 3, 20, 40, 62, 100 };
+    auto to_filtered = [](const PointZ& p) {
+        return Point_2i(integer(p.x), integer(p.y));
+    };
+    auto to_grid = [](const PointZ& p) {
+        return Point_2l(p.x.get_si(), p.y.get_si());
+    };
+    for (int round = 0; round < rounds; ++round) {
+        int count = counts[UniformInt(rng, 0, sizeof(counts)/sizeof(int)-1)];
+        int b = bits[UniformInt(rng, 0, sizeof(bits)/sizeof(int)-1)];
+        int shape = UniformInt(rng, 0, 3);
+        std::vector<PointZ> points = RandomPoints(rng, count, b, shape);
+        std::vector<PointZ> expected = MonotoneChainHull(points);
+        std::string where = " on "+std::to_string(count)+" points of shape "+
+                            std::to_string(shape)+" with "+std::to_string(b)+
+                            " bits";
+        for (size_t threads = 1; threads <= 4; threads += 3) {
+            ++check.cases;
+            Expect(check, SameHull<FilteredKernel_2>(points, expected, threads,
+                                                     to_filtered),
+                   "FilteredKernel_2"+where);
+            if (b <= 40 && shape != 2) {
+                Expect(check, SameHull<IntegerKernel_2<41>>(points, expected,
+                                                            threads, to_grid),
+                       "IntegerKernel_2"+where);
+            }
+        }
+    }
+    return check;
+}
+
+//=============================================================================
+// Melkman
+//=============================================================================
+
+//! @brief Counterclockwise by angle from the positive x axis.
+static bool AngleLess(const PointZ& a, const PointZ& b) {
+    bool a_upper = sgn(a.y) > 0 || (sgn(a.y) == 0 && sgn(a.x) > 0);
+    bool b_upper = sgn(b.y) > 0 || (sgn(b.y) == 0 && sgn(b.x) > 0);
+    if (a_upper != b_upper) {
+        return a_upper;
+    }
+    return sgn(a.x*b.y-a.y*b.x) > 0;
+}
+
+/*!
+ * @brief A simple polyline that starts with a run of collinear vertices,
+ * one of them repeated. Points sorted by angle around the origin form a
+ * star-shaped chain as long as consecutive ones turn left, and the ray from
+ * the origin through its first vertex v meets the chain only at v. The run
+ * walks that ray in to v from 3v, or out to v from the origin.
+ */
+static std::vector<PointZ> CollinearPrefixPolyline(gmp_randclass& rng,
+                                                   const int count,
+                                                   const int bits) {
+    std::vector<PointZ> star;
+    for (PointZ& p : RandomPoints(rng, count, bits, 0)) {
+        if (sgn(p.x) != 0 || sgn(p.y) != 0) {
+            star.push_back({ 2*p.x, 2*p.y });
+        }
+    }
+    std::sort(star.begin(), star.end(), AngleLess);
+    star.erase(std::unique(star.begin(), star.end(),
+        [](const PointZ& a, const PointZ& b) {
+            return !AngleLess(a, b) && !AngleLess(b, a);
+        }), star.end());
+    for (size_t i = 1; i < star.size(); ++i) {
+        if (Cross(PointZ(), star[i-1], star[i]) <= 0) {
+            star.resize(i);
+        }
+    }
+    if (star.empty()) {
+        star.push_back({ 2*Uniform(rng, 8)+1, 2*Uniform(rng, 8) });
+    }
+
+    const PointZ& v = star[0];
+    std::vector<PointZ> polyline;
+    if (UniformInt(rng, 0, 1)) {
+        polyline.push_back({ 3*v.x, 3*v.y });
+        polyline.push_back({ 2*v.x, 2*v.y });
+        polyline.push_back({ 2*v.x, 2*v.y });
+    } else {
+        polyline.push_back(PointZ());
+        polyline.push_back({ v.x/2, v.y/2 });
+        polyline.push_back({ v.x/2, v.y/2 });
+    }
+    polyline.insert(polyline.end(), star.begin(), star.end());
+    return polyline;
+}
+
+//! @brief Whether hull lists the vertices of expected in the same cyclic
+//! order.
+template <class Point, class Convert>
+static bool SameCycle(const std::vector<Point>& hull,
+                      const std::vector<PointZ>& expected, Convert convert) {
+    if (hull.size() != expected.size()) {
+        return false;
+    }
+    size_t start = 0;
+    while (start < hull.size() && !(hull[start] == convert(expected[0]))) {
+        ++start;
+    }
+    if (start == hull.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < hull.size(); ++i) {
+        if (!(hull[(start+i)%hull.size()] == convert(expected[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Kernel, class Convert>
+static bool SameMelkmanHull(const std::vector<PointZ>& polyline,
+                            const std::vector<PointZ>& expected,
+                            Convert convert) {
+    std::vector<typename Kernel::Point_2> P;
+    for (const PointZ& p : polyline) {
+        P.push_back(convert(p));
+    }
+    return SameCycle(Melkman<Kernel>(P), expected, convert);
+}
+
+template <class Kernel, class Convert>
+static bool SameOnlineMelkmanHull(const std::vector<PointZ>& polyline,
+                                  const std::vector<PointZ>& expected,
+                                  Convert convert) {
+    OnlineMelkman<Kernel> melkman;
+    for (const PointZ& p : polyline) {
+        melkman.push_back(convert(p));
+    }
+    return SameCycle(melkman.hull(), expected, convert);
+}
+
+static Check CheckMelkman(gmp_randclass& rng, const int rounds) {
+    Check check = MakeCheck("melkman");
+    auto to_filtered = [](const PointZ& p) {
+        return Point_2i(integer(p.x), integer(p.y));
+    };
+    auto to_grid = [](const PointZ& p) {
+        return Point_2l(p.x.get_si(), p.y.get_si());
+    };
+    for (int round = 0; round < rounds; ++round) {
+        int count = UniformInt(rng, 0, 30);
+        int b = UniformInt(rng, 2, 36);
+        std::vector<PointZ> polyline = CollinearPrefixPolyline(rng, count, b);
+        std::vector<PointZ> expected = MonotoneChainHull(polyline);
+        std::string where = " on "+std::to_string(polyline.size())+
+                            " vertices with a collinear prefix";
+        ++check.cases;
+        Expect(check, SameMelkmanHull<FilteredKernel_2>(polyline, expected,
+                                                        to_filtered),
+               "FilteredKernel_2"+where);
+        Expect(check, SameMelkmanHull<IntegerKernel_2<41>>(polyline,
+                                                           expected, to_grid),
+               "IntegerKernel_2"+where);
+        Expect(check, SameOnlineMelkmanHull<FilteredKernel_2>(polyline,
+                                                              expected,
+                                                              to_filtered),
+               "OnlineMelkman"+where);
+
+        // any order of points is a polyline OnlineMelkman has to take
+        int shape = UniformInt(rng, 0, 3);
+        std::vector<PointZ> track = RandomPoints(rng, count+1, b, shape);
+        ++check.cases;
+        Expect(check, SameOnlineMelkmanHull<FilteredKernel_2>(
+                   track, MonotoneChainHull(track), to_filtered),
+               "OnlineMelkman on "+std::to_string(track.size())+
+               " points of shape "+std::to_string(shape));
+    }
+    return check;
+}
+
+//=============================================================================
+// IntegerHull
+//=============================================================================
+
+static Polygon_2r ToPolygon(const std::vector<Point_2r>& points) {
+    Polygon_2r P;
+    for (const Point_2r& p : ParallelConvexHull<RationalKernel_2>(points, 1)) {
+        P.push_back(p);
+    }
+    return P;
+}
+
+static bool SameVertices(const Polygon_2r& a, const Polygon_2r& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (*a[i] != *b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! @brief Hulls of up to eight points with small denominators, including
+//! degenerate ones and ones without any lattice point.
+static Check CheckIntegerHull(gmp_randclass& rng, const int rounds) {
+    Check check = MakeCheck("integer hull");
+    for (int round = 0; round < rounds; ++round) {
+        mpz_class s = UniformInt(rng, 1, 300);
+        int count = UniformInt(rng, 1, 8);
+        std::vector<Point_2r> points;
+        for (int i = 0; i < count; ++i) {
+            mpz_class d = UniformInt(rng, 1, 12);
+            mpq_class x(Uniform(rng, s*d), d), y(Uniform(rng, s*d), d);
+            x.canonicalize();
+            y.canonicalize();
+            points.push_back(Point_2r(rational(x), rational(y)));
+        }
+        Polygon_2r P = ToPolygon(points);
+        ++check.cases;
+        Expect(check, SameVertices(IntegerHull(P), IntegerHullByLatticeScan(P)),
+               "IntegerHull of a "+std::to_string(P.size())+"-gon within "+
+               s.get_str());
+    }
+    return check;
+}
+
+//=============================================================================
+// Main
+//=============================================================================
+
+int main(int argc, char* argv[]) {
+    el::Loggers::reconfigureAllLoggers(el::ConfigurationType::Enabled,
+                                       "false");
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+    const unsigned long seed = argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+                                        : 1;
+
+    gmp_randclass rng(gmp_randinit_default);
+    rng.seed(seed);
+
+    std::vector<Check> checks;
+    checks.push_back(CheckModularDeterminant(rng, rounds));
+    checks.push_back(CheckBareissRational(rng, 4*rounds));
+    checks.push_back(CheckBareissInteger(rng, 4*rounds));
+    checks.push_back(CheckHermiteNormalForm(rng, 4*rounds));
+    checks.push_back(CheckLLLReduce(rng, 4*rounds));
+    checks.push_back(CheckParallelConvexHull(rng, rounds));
+    checks.push_back(CheckMelkman(rng, 4*rounds));
+    checks.push_back(CheckIntegerHull(rng, 4*rounds));
+
+    std::cout << std::left << std::setw(26) << "check" << std::right
+              << std::setw(8) << "cases" << std::setw(10) << "failures"
+              << "\n";
+    int failures = 0;
+    for (const Check& check : checks) {
+        std::cout << std::left << std::setw(26) << check.name << std::right
+                  << std::setw(8) << check.cases << std::setw(10)
+                  << check.failures << "\n";
+        failures += check.failures;
+    }
+
+    return failures ? 1 : 0;
+}
@@ -38,6 +38,18 @@ AABB_2r::AABB_2r(const PointSet_3r &pointset) {
     max_.set_y(maxy);
 }
 
+//! @brief Scans the x and y arrays separately; points must not be empty.
+AABB_2r::AABB_2r(const PointBufferView_3r& points) {
+    assert(!points.empty());
+    auto x = std::minmax_element(points.data(0), points.data(0)+points.size());
+    auto y = std::minmax_element(points.data(1), points.data(1)+points.size());
+
+    min_.set_x(*x.first);
+    min_.set_y(*y.first);
+    max_.set_x(*x.second);
+    max_.set_y(*y.second);
+}
+
 const Point_2r& AABB_2r::min() const {
     return min_;
 }
@@ -19,6 +19,7 @@
 #include "common.h"
 #include "point.h"
 #include "pointset.h"
+#include "pointbuffer.h"
 
 namespace DDAD {
 
@@ -26,6 +27,7 @@ class AABB_2r {
 public:
     AABB_2r();
     AABB_2r(const PointSet_3r& pointset);
+    AABB_2r(const PointBufferView_3r& points);
 
     const Point_2r& min() const;
     const Point_2r& max() const;
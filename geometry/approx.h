@@ -0,0 +1,123 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Batch conversion of rational coordinates to float, for building
+ * visualization snapshots.
+ *
+ * Coordinates are written packed, N floats per point, so that a snapshot
+ * of a scene is one pass over its points rather than one conversion per
+ * position-change signal. Numerators and denominators that fit in 53 bits
+ * are divided in double, and integers are converted directly; only larger
+ * values go through mpq_get_d. Results are within one float ulp of the
+ * exact value, which is all rendering needs.
+ */
+
+#ifndef GE_APPROX_H
+#define GE_APPROX_H
+
+#include "common.h"
+#include "arithmetic.h"
+#include "point.h"
+#include "pointbuffer.h"
+
+namespace DDAD {
+
+float ApproxFloat(const mpq_class& q);
+float ApproxFloat(const SmallRational& q);
+template <class T>
+float ApproxFloat(const Profiled<T>& q);
+
+//! @brief Writes N coordinates per point to out, point after point.
+template <size_t N>
+void ApproxPoints(const Point<rational, N>* points, const size_t count,
+                  float* out);
+//! @brief As above, for points scattered in memory.
+template <size_t N>
+void ApproxPoints(const Point<rational, N>* const* points, const size_t count,
+                  float* out);
+template <size_t N>
+void ApproxPoints(const PointBufferView<rational, N>& points, float* out);
+
+//=============================================================================
+// Implementation: Batch float approximation
+//=============================================================================
+
+inline float ApproxFloat(const mpq_class& q) {
+    static const mp_limb_t kExact = mp_limb_t(1) << 53;
+    mpz_srcptr num = mpq_numref(q.get_mpq_t());
+    mpz_srcptr den = mpq_denref(q.get_mpq_t());
+    if (mpz_size(num) <= 1 && mpz_size(den) == 1) {
+        mp_limb_t n = mpz_getlimbn(num, 0);
+        mp_limb_t d = mpz_getlimbn(den, 0);
+        float f;
+        if (d == 1) {
+            f = static_cast<float>(n);
+        } else if (n < kExact && d < kExact) {
+            f = static_cast<float>(static_cast<double>(n)/
+                                   static_cast<double>(d));
+        } else {
+            return static_cast<float>(mpq_get_d(q.get_mpq_t()));
+        }
+        return mpz_sgn(num) < 0 ? -f : f;
+    }
+    return static_cast<float>(mpq_get_d(q.get_mpq_t()));
+}
+
+//! @brief get_d already divides inline values in double.
+inline float ApproxFloat(const SmallRational& q) {
+    return static_cast<float>(q.get_d());
+}
+
+template <class T>
+inline float ApproxFloat(const Profiled<T>& q) {
+    return ApproxFloat(q.value());
+}
+
+template <size_t N>
+inline void ApproxPoints(const Point<rational, N>* points, const size_t count,
+                         float* out) {
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t axis = 0; axis < N; ++axis) {
+            *out++ = ApproxFloat(points[i][axis]);
+        }
+    }
+}
+
+template <size_t N>
+inline void ApproxPoints(const Point<rational, N>* const* points,
+                         const size_t count, float* out) {
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t axis = 0; axis < N; ++axis) {
+            *out++ = ApproxFloat((*points[i])[axis]);
+        }
+    }
+}
+
+//! @brief Converts axis by axis, reading each coordinate array in order.
+template <size_t N>
+inline void ApproxPoints(const PointBufferView<rational, N>& points,
+                         float* out) {
+    for (size_t axis = 0; axis < N; ++axis) {
+        const rational* coords = points.data(axis);
+        for (size_t i = 0; i < points.size(); ++i) {
+            out[i*N+axis] = ApproxFloat(coords[i]);
+        }
+    }
+}
+
+} // namespace DDAD
+
+#endif // GE_APPROX_H
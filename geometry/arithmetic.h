@@ -17,20 +17,36 @@
 #define GE_ARITHMETIC_H
 
 #include "common.h"
+#include "smallrational.h"
+#include "profile.h"
+
+#include <type_traits>
 
 namespace DDAD {
 
+// Build with DDAD_PROFILE_ARITHMETIC to record the bit lengths and operation
+// counts of all integer and rational arithmetic; see profile.h. Build with
+// DDAD_SMALL_RATIONAL to evaluate rationals with an inline 64-bit fast path;
+// see smallrational.h.
+#if defined(DDAD_PROFILE_ARITHMETIC)
+typedef Profiled<mpz_class> integer;
+typedef Profiled<mpq_class> rational;
+#elif defined(DDAD_SMALL_RATIONAL)
+typedef mpz_class integer;
+typedef SmallRational rational;
+#else
 typedef mpz_class integer;
 typedef mpq_class rational;
+#endif
 
 //=============================================================================
 // Interfaces
 //=============================================================================
 
-integer Floor(const rational& x);
-integer FloorKeepFraction(const rational& x, rational* out_frac);
-integer Ceil(const rational& x);
-integer CeilKeepFraction(const rational& x, rational* out_frac);
+integer Floor(const mpq_class& x);
+integer FloorKeepFraction(const mpq_class& x, mpq_class* out_frac);
+integer Ceil(const mpq_class& x);
+integer CeilKeepFraction(const mpq_class& x, mpq_class* out_frac);
 
 //=============================================================================
 // Floor/Ceiling
@@ -41,7 +57,7 @@ integer CeilKeepFraction(const rational& x, rational* out_frac);
  * \param r - rational to be rounded.
  * \return nearest integer in the -infinity direction.
  */
-inline integer Floor(const rational& x) {
+inline integer Floor(const mpq_class& x) {
     integer out_int;
 
     // mpz_fdiv_q(q, n, d), n = q*d+r
@@ -57,15 +73,15 @@ inline integer Floor(const rational& x) {
  * \param out_frac - fractional remainder, 0 <= |out_frac| < 1.
  * \return nearest integer in the -infinity direction.
  */
-inline integer FloorKeepFraction(const rational& x, rational* out_frac) {
+inline integer FloorKeepFraction(const mpq_class& x, mpq_class* out_frac) {
     integer out_int;
-    integer out_frac_n;
+    mpz_class out_frac_n;
 
     // mpz_fdiv_qr(q, r, n, d), n = q*d+r
     mpz_fdiv_qr(out_int.get_mpz_t(), out_frac_n.get_mpz_t(), x.get_num_mpz_t(),
                 x.get_den_mpz_t());
 
-    *out_frac = rational(out_frac_n, x.get_den());
+    *out_frac = mpq_class(out_frac_n, x.get_den());
     return out_int;
 }
 
@@ -74,7 +90,7 @@ inline integer FloorKeepFraction(const rational& x, rational* out_frac) {
  * \param r - rational to be rounded.
  * \return nearest integer in the +infinity direction.
  */
-inline integer Ceil(const rational &x) {
+inline integer Ceil(const mpq_class &x) {
     integer out_int;
 
     // mpz_cdiv_q(q, n, d), n = q*d+r
@@ -90,18 +106,115 @@ inline integer Ceil(const rational &x) {
  * \param out_frac - fractional remainder, 0 <= |out_frac| < 1.
  * \return nearest integer in the +infinity direction.
  */
-inline integer CeilKeepFraction(const rational &x, rational *out_frac) {
+inline integer CeilKeepFraction(const mpq_class &x, mpq_class *out_frac) {
     integer out_int;
-    integer out_frac_n;
+    mpz_class out_frac_n;
 
     // mpz_cdiv_qr(q, r, n, d), n = q*d+r
     mpz_cdiv_qr(out_int.get_mpz_t(), out_frac_n.get_mpz_t(), x.get_num_mpz_t(),
                 x.get_den_mpz_t());
 
-    *out_frac = rational(out_frac_n, x.get_den());
+    *out_frac = mpq_class(out_frac_n, x.get_den());
     return out_int;
 }
 
+//=============================================================================
+// Bit-budget integers
+//=============================================================================
+
+#if defined(__SIZEOF_INT128__)
+#define DDAD_HAS_INT128 1
+typedef __int128 int128_t;
+#else
+#define DDAD_HAS_INT128 0
+#endif
+
+//! @brief Largest bit length a machine integer type can hold, sign included.
+#if DDAD_HAS_INT128
+static const int kMaxFixedWidthBits = 128;
+#else
+static const int kMaxFixedWidthBits = 64;
+#endif
+
+//! @brief ceil(log2(N)) for N >= 1.
+template <int N>
+struct CeilLog2 {
+    static const int value = 1+CeilLog2<(N+1)/2>::value;
+};
+
+template <>
+struct CeilLog2<1> {
+    static const int value = 0;
+};
+
+/*!
+ * @brief PredicateBits - bit length, sign included, sufficient to evaluate a
+ * polynomial predicate exactly.
+ *
+ * The predicate is assumed to be a sum of Terms monomials, each a product of
+ * Degree differences of inputs with |x| < 2^InputBits. Every difference
+ * needs InputBits+1 bits, every product Degree*(InputBits+1), and the sum
+ * ceil(log2(Terms)) more. For OrientationPQR (Degree 2, Terms 2) this is
+ * 2*InputBits+4.
+ */
+template <int InputBits, int Degree, int Terms>
+struct PredicateBits {
+    static_assert(InputBits > 0 && Degree > 0 && Terms > 0,
+                  "PredicateBits: parameters must be positive");
+    static const int value = Degree*(InputBits+1)+CeilLog2<Terms>::value+1;
+};
+
+/*!
+ * @brief BitBudgetInteger - the cheapest integer type holding Bits bits,
+ * sign included: int32_t, int64_t, int128_t where the compiler provides it,
+ * and integer (mpz_class) otherwise.
+ */
+template <int Bits>
+struct BitBudgetInteger {
+    typedef typename std::conditional<(Bits <= 32), int32_t,
+            typename std::conditional<(Bits <= 64), int64_t,
+#if DDAD_HAS_INT128
+            typename std::conditional<(Bits <= 128), int128_t,
+            integer>::type
+#else
+            integer
+#endif
+            >::type>::type type;
+};
+
+/*!
+ * @brief FixedWidthInteger - like BitBudgetInteger, but refuses to fall back
+ * to integer. Instantiating it with a budget no machine type can hold is a
+ * compile error.
+ */
+template <int Bits>
+struct FixedWidthInteger {
+    static_assert(Bits <= kMaxFixedWidthBits,
+                  "FixedWidthInteger: bit budget exceeds the widest machine "
+                  "integer; use BitBudgetInteger or integer");
+    typedef typename BitBudgetInteger<Bits>::type type;
+};
+
+/*!
+ * @brief ToInt64 - converts an integer with |x| < 2^63 to int64_t. Unlike
+ * mpz_get_si this does not depend on the width of long.
+ */
+inline int64_t ToInt64(const integer& x) {
+    assert(mpz_sizeinbase(x.get_mpz_t(), 2) <= 63);
+    uint64_t m = static_cast<uint64_t>(mpz_getlimbn(x.get_mpz_t(), 0));
+#if GMP_LIMB_BITS < 64
+    m |= static_cast<uint64_t>(mpz_getlimbn(x.get_mpz_t(), 1)) << 32;
+#endif
+    return mpz_sgn(x.get_mpz_t()) < 0 ? -static_cast<int64_t>(m)
+                                      : static_cast<int64_t>(m);
+}
+
+//! @brief IntegerFits - true if |x| < 2^bits.
+inline bool IntegerFits(const integer& x, const int bits) {
+    return mpz_sgn(x.get_mpz_t()) == 0 ||
+           static_cast<int>(mpz_sizeinbase(x.get_mpz_t(), 2)) <= bits;
+}
+
 /*
 class Integer {
 public:
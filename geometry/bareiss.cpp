@@ -0,0 +1,274 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "bareiss.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Implementation: Fraction-free elimination
+//=============================================================================
+
+static Sign ToSign(const integer& x) {
+    int s = sgn(x);
+    return s > 0 ? SIGN_POSITIVE : (s < 0 ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+/*!
+ * @brief Brings the first pivot_cols columns of the row-major rows x cols
+ * matrix a to echelon form in place, updating the remaining columns along.
+ * A column without a pivot is skipped, or ends the elimination if
+ * full_rank is set. Returns the number of pivots; negate is set if an odd
+ * number of row swaps took place.
+ */
+static int Eliminate(std::vector<integer>& a, const int rows, const int cols,
+                     const int pivot_cols, const bool full_rank,
+                     bool& negate) {
+    DDAD_PROFILE_SITE("Bareiss::Eliminate");
+    integer previous(1);
+    int rank = 0;
+    negate = false;
+    for (int c = 0; c < pivot_cols && rank < rows; ++c) {
+        int pivot = rank;
+        while (pivot < rows && sgn(a[pivot*cols+c]) == 0) {
+            ++pivot;
+        }
+        if (pivot == rows) {
+            if (full_rank) {
+                return rank;
+            }
+            continue;
+        }
+        if (pivot != rank) {
+            for (int j = c; j < cols; ++j) {
+                std::swap(a[rank*cols+j], a[pivot*cols+j]);
+            }
+            negate = !negate;
+        }
+
+        mpz_srcptr p = a[rank*cols+c].get_mpz_t();
+        for (int i = rank+1; i < rows; ++i) {
+            mpz_srcptr f = a[i*cols+c].get_mpz_t();
+            for (int j = c+1; j < cols; ++j) {
+                mpz_ptr e = a[i*cols+j].get_mpz_t();
+                mpz_mul(e, e, p);
+                mpz_submul(e, f, a[rank*cols+j].get_mpz_t());
+                if (rank > 0) {
+                    mpz_divexact(e, e, previous.get_mpz_t());
+                }
+            }
+            a[i*cols+c] = 0;
+        }
+        previous = a[rank*cols+c];
+        ++rank;
+    }
+    return rank;
+}
+
+//! @brief Copies the column-major entries into a row-major work matrix of
+//! the transpose, which has the same determinant and rank.
+static std::vector<integer> Transposed(const integer* entries, const int rows,
+                                       const int cols) {
+    return std::vector<integer>(entries, entries+rows*cols);
+}
+
+/*!
+ * @brief Row-major integer matrix with the rows of the column-major rows x
+ * cols matrix in entries, each scaled by the lcm of its denominators. The
+ * optional rhs is scaled along and appended as the last column. Returns the
+ * product of the scales in scale, if given.
+ */
+static std::vector<integer> ClearDenominators(const rational* entries,
+                                              const rational* rhs,
+                                              const int rows, const int cols,
+                                              integer* scale) {
+    const int width = rhs ? cols+1 : cols;
+    std::vector<integer> a(rows*width);
+    integer lcm, factor;
+    if (scale) {
+        *scale = 1;
+    }
+    for (int i = 0; i < rows; ++i) {
+        lcm = 1;
+        for (int j = 0; j < width; ++j) {
+            const rational& q = j < cols ? entries[j*rows+i] : rhs[i];
+            integer den(q.get_den());
+            mpz_lcm(lcm.get_mpz_t(), lcm.get_mpz_t(), den.get_mpz_t());
+        }
+        for (int j = 0; j < width; ++j) {
+            const rational& q = j < cols ? entries[j*rows+i] : rhs[i];
+            integer den(q.get_den());
+            mpz_divexact(factor.get_mpz_t(), lcm.get_mpz_t(), den.get_mpz_t());
+            a[i*width+j] = q.get_num();
+            a[i*width+j] *= factor;
+        }
+        if (scale) {
+            *scale *= lcm;
+        }
+    }
+    return a;
+}
+
+//! @brief Back substitution on the echelon form of [A | b] with n pivots,
+//! see BareissSolve.
+static void BackSubstitute(std::vector<integer>& a, const int n,
+                           integer* numerators, integer& denominator) {
+    const int cols = n+1;
+    denominator = a[(n-1)*cols+(n-1)];
+    for (int i = n-1; i >= 0; --i) {
+        integer& x = numerators[i];
+        x = denominator*a[i*cols+n];
+        for (int j = i+1; j < n; ++j) {
+            mpz_submul(x.get_mpz_t(), a[i*cols+j].get_mpz_t(),
+                       numerators[j].get_mpz_t());
+        }
+        mpz_divexact(x.get_mpz_t(), x.get_mpz_t(),
+                     a[i*cols+i].get_mpz_t());
+    }
+    if (sgn(denominator) < 0) {
+        denominator = -denominator;
+        for (int i = 0; i < n; ++i) {
+            numerators[i] = -numerators[i];
+        }
+    }
+}
+
+//=============================================================================
+// Implementation: Integer matrices
+//=============================================================================
+
+integer BareissDeterminant(const integer* entries, const int n) {
+    if (n <= 0) {
+        return integer(1);
+    }
+    std::vector<integer> a = Transposed(entries, n, n);
+    bool negate;
+    if (Eliminate(a, n, n, n, true, negate) < n) {
+        return integer(0);
+    }
+    integer& det = a[n*n-1];
+    if (negate) {
+        det = -det;
+    }
+    return det;
+}
+
+Sign BareissSignOfDeterminant(const integer* entries, const int n) {
+    if (n <= 0) {
+        return SIGN_POSITIVE;
+    }
+    std::vector<integer> a = Transposed(entries, n, n);
+    bool negate;
+    if (Eliminate(a, n, n, n, true, negate) < n) {
+        return SIGN_ZERO;
+    }
+    Sign sign = ToSign(a[n*n-1]);
+    return negate ? static_cast<Sign>(-sign) : sign;
+}
+
+int BareissRank(const integer* entries, const int rows, const int cols) {
+    std::vector<integer> a = Transposed(entries, rows, cols);
+    bool negate;
+    return Eliminate(a, cols, rows, rows, false, negate);
+}
+
+bool BareissSolve(const integer* entries, const integer* rhs, const int n,
+                  integer* numerators, integer& denominator) {
+    const int cols = n+1;
+    std::vector<integer> a(n*cols);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            a[i*cols+j] = entries[j*n+i];
+        }
+        a[i*cols+n] = rhs[i];
+    }
+    bool negate;
+    if (Eliminate(a, n, cols, n, true, negate) < n) {
+        return false;
+    }
+    BackSubstitute(a, n, numerators, denominator);
+    return true;
+}
+
+//=============================================================================
+// Implementation: Rational matrices
+//=============================================================================
+
+/*!
+ * With D the product of the row scales, det(mat) = det(A)/D for the scaled
+ * integer matrix A.
+ */
+rational BareissDeterminant(const rational* entries, const int n) {
+    if (n <= 0) {
+        return rational(1);
+    }
+    integer scale;
+    std::vector<integer> a = ClearDenominators(entries, nullptr, n, n,
+                                               &scale);
+    bool negate;
+    if (Eliminate(a, n, n, n, true, negate) < n) {
+        return rational(0);
+    }
+    integer& det = a[n*n-1];
+    if (negate) {
+        det = -det;
+    }
+    rational q(det, scale);
+    q.canonicalize();
+    return q;
+}
+
+//! Row scales are positive, so the scaled matrix has the same sign.
+Sign BareissSignOfDeterminant(const rational* entries, const int n) {
+    if (n <= 0) {
+        return SIGN_POSITIVE;
+    }
+    std::vector<integer> a = ClearDenominators(entries, nullptr, n, n,
+                                               nullptr);
+    bool negate;
+    if (Eliminate(a, n, n, n, true, negate) < n) {
+        return SIGN_ZERO;
+    }
+    Sign sign = ToSign(a[n*n-1]);
+    return negate ? static_cast<Sign>(-sign) : sign;
+}
+
+int BareissRank(const rational* entries, const int rows, const int cols) {
+    std::vector<integer> a = ClearDenominators(entries, nullptr, rows, cols,
+                                               nullptr);
+    bool negate;
+    return Eliminate(a, rows, cols, cols, false, negate);
+}
+
+//! Scaling an equation by its lcm leaves the solution unchanged.
+bool BareissSolve(const rational* entries, const rational* rhs, const int n,
+                  rational* x) {
+    std::vector<integer> a = ClearDenominators(entries, rhs, n, n, nullptr);
+    bool negate;
+    if (Eliminate(a, n, n+1, n, true, negate) < n) {
+        return false;
+    }
+    std::vector<integer> numerators(n);
+    integer denominator;
+    BackSubstitute(a, n, numerators.data(), denominator);
+    for (int i = 0; i < n; ++i) {
+        x[i] = rational(numerators[i], denominator);
+        x[i].canonicalize();
+    }
+    return true;
+}
+
+} // namespace DDAD
@@ -0,0 +1,60 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Exact linear algebra by fraction-free (Bareiss) elimination.
+ *
+ * Each elimination step replaces a(i,j) by (a(i,j)*a(k,k)-a(i,k)*a(k,j))/p,
+ * where p is the previous pivot. The division is exact and every entry is a
+ * minor of the input, so entries grow linearly with the dimension and no
+ * gcd is ever taken. Rational matrices are first brought to integers by
+ * scaling each row by the lcm of its denominators.
+ *
+ * Matrices are given as n x n (or rows x cols) entries in column-major
+ * order, as stored by Mat; determinant, sign and rank may equally be given
+ * row-major, since transposing changes none of them.
+ */
+
+#ifndef GE_BAREISS_H
+#define GE_BAREISS_H
+
+#include "common.h"
+#include "arithmetic.h"
+
+namespace DDAD {
+
+integer BareissDeterminant(const integer* entries, const int n);
+rational BareissDeterminant(const rational* entries, const int n);
+
+//! @brief Sign of the determinant, without dividing out row scales.
+Sign BareissSignOfDeterminant(const integer* entries, const int n);
+Sign BareissSignOfDeterminant(const rational* entries, const int n);
+
+int BareissRank(const integer* entries, const int rows, const int cols);
+int BareissRank(const rational* entries, const int rows, const int cols);
+
+/*!
+ * @brief Solves mat*x = rhs for the n x n matrix in entries. Returns false
+ * if it is singular. Otherwise x = numerators/denominator with denominator
+ * |det(mat)|, as in Cramer's rule; the fractions are not reduced.
+ */
+bool BareissSolve(const integer* entries, const integer* rhs, const int n,
+                  integer* numerators, integer& denominator);
+bool BareissSolve(const rational* entries, const rational* rhs, const int n,
+                  rational* x);
+
+} // namespace DDAD
+
+#endif // GE_BAREISS_H
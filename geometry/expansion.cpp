@@ -0,0 +1,602 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "expansion.h"
+
+namespace DDAD {
+
+namespace Predicate {
+
+//=============================================================================
+// Implementation: Expansion arithmetic
+//=============================================================================
+
+// epsilon = 2^-53 bounds the relative error of one rounded operation, and
+// splitter = 2^27+1 splits a double into two non-overlapping 26-bit halves.
+static const double kEpsilon = 1.1102230246251565e-16;
+static const double kSplitter = 134217729.0;
+
+// Error bound coefficients, with the same names as in Shewchuk's code.
+static const double kResultErrBound = (3.0+8.0*kEpsilon)*kEpsilon;
+static const double kCcwErrBoundA = (3.0+16.0*kEpsilon)*kEpsilon;
+static const double kCcwErrBoundB = (2.0+12.0*kEpsilon)*kEpsilon;
+static const double kCcwErrBoundC = (9.0+64.0*kEpsilon)*kEpsilon*kEpsilon;
+static const double kO3dErrBoundA = (7.0+56.0*kEpsilon)*kEpsilon;
+static const double kIccErrBoundA = (10.0+96.0*kEpsilon)*kEpsilon;
+static const double kIspErrBoundA = (16.0+224.0*kEpsilon)*kEpsilon;
+
+//! @brief Nonoverlapping components in order of increasing magnitude; the
+//! value is their exact sum and its sign is the sign of the last one.
+typedef std::vector<double> Expansion;
+
+//! @brief x+y = a+b exactly, provided |a| >= |b|.
+static inline void FastTwoSum(const double a, const double b, double& x,
+                              double& y) {
+    x = a+b;
+    double bvirt = x-a;
+    y = b-bvirt;
+}
+
+//! @brief x+y = a+b exactly.
+static inline void TwoSum(const double a, const double b, double& x,
+                          double& y) {
+    x = a+b;
+    double bvirt = x-a;
+    double avirt = x-bvirt;
+    double bround = b-bvirt;
+    double around = a-avirt;
+    y = around+bround;
+}
+
+//! @brief Roundoff y of x = fl(a-b).
+static inline void TwoDiffTail(const double a, const double b, const double x,
+                               double& y) {
+    double bvirt = a-x;
+    double avirt = x+bvirt;
+    double bround = bvirt-b;
+    double around = a-avirt;
+    y = around+bround;
+}
+
+//! @brief x+y = a-b exactly.
+static inline void TwoDiff(const double a, const double b, double& x,
+                           double& y) {
+    x = a-b;
+    TwoDiffTail(a, b, x, y);
+}
+
+static inline void Split(const double a, double& hi, double& lo) {
+    double c = kSplitter*a;
+    double abig = c-a;
+    hi = c-abig;
+    lo = a-hi;
+}
+
+//! @brief x+y = a*b exactly, with b already split into bhi+blo.
+static inline void TwoProductPresplit(const double a, const double b,
+                                      const double bhi, const double blo,
+                                      double& x, double& y) {
+    x = a*b;
+    double ahi, alo;
+    Split(a, ahi, alo);
+    double err1 = x-(ahi*bhi);
+    double err2 = err1-(alo*bhi);
+    double err3 = err2-(ahi*blo);
+    y = (alo*blo)-err3;
+}
+
+//! @brief x+y = a*b exactly.
+static inline void TwoProduct(const double a, const double b, double& x,
+                              double& y) {
+    double bhi, blo;
+    Split(b, bhi, blo);
+    TwoProductPresplit(a, b, bhi, blo, x, y);
+}
+
+//! @brief x[3]+x[2]+x[1]+x[0] = (a1+a0)-(b1+b0) exactly.
+static inline void TwoTwoDiff(const double a1, const double a0,
+                              const double b1, const double b0, double* x) {
+    double i, j, k, l;
+    TwoDiff(a0, b0, i, x[0]);
+    TwoSum(a1, i, j, k);
+    TwoDiff(k, b1, l, x[1]);
+    TwoSum(j, l, x[3], x[2]);
+}
+
+static inline double Next(const double* e, int& index, const int length) {
+    return ++index < length ? e[index] : 0.0;
+}
+
+/*!
+ * @brief h = e+f, dropping zero components. h must have room for
+ * elen+flen components; returns the number written, at least one.
+ */
+static int FastExpansionSumZeroElim(const int elen, const double* e,
+                                    const int flen, const double* f,
+                                    double* h) {
+    double q, qnew, hh;
+    int eindex = 0, findex = 0, hindex = 0;
+    double enow = e[0];
+    double fnow = f[0];
+
+    if ((fnow > enow) == (fnow > -enow)) {
+        q = enow;
+        enow = Next(e, eindex, elen);
+    } else {
+        q = fnow;
+        fnow = Next(f, findex, flen);
+    }
+    if (eindex < elen && findex < flen) {
+        if ((fnow > enow) == (fnow > -enow)) {
+            FastTwoSum(enow, q, qnew, hh);
+            enow = Next(e, eindex, elen);
+        } else {
+            FastTwoSum(fnow, q, qnew, hh);
+            fnow = Next(f, findex, flen);
+        }
+        q = qnew;
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+        while (eindex < elen && findex < flen) {
+            if ((fnow > enow) == (fnow > -enow)) {
+                TwoSum(q, enow, qnew, hh);
+                enow = Next(e, eindex, elen);
+            } else {
+                TwoSum(q, fnow, qnew, hh);
+                fnow = Next(f, findex, flen);
+            }
+            q = qnew;
+            if (hh != 0.0) {
+                h[hindex++] = hh;
+            }
+        }
+    }
+    while (eindex < elen) {
+        TwoSum(q, enow, qnew, hh);
+        enow = Next(e, eindex, elen);
+        q = qnew;
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+    }
+    while (findex < flen) {
+        TwoSum(q, fnow, qnew, hh);
+        fnow = Next(f, findex, flen);
+        q = qnew;
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+    }
+    if (q != 0.0 || hindex == 0) {
+        h[hindex++] = q;
+    }
+    return hindex;
+}
+
+/*!
+ * @brief h = b*e, dropping zero components. h must have room for 2*elen
+ * components; returns the number written, at least one.
+ */
+static int ScaleExpansionZeroElim(const int elen, const double* e,
+                                  const double b, double* h) {
+    double bhi, blo, q, hh, product1, product0, sum;
+    int hindex = 0;
+
+    Split(b, bhi, blo);
+    TwoProductPresplit(e[0], b, bhi, blo, q, hh);
+    if (hh != 0.0) {
+        h[hindex++] = hh;
+    }
+    for (int eindex = 1; eindex < elen; ++eindex) {
+        TwoProductPresplit(e[eindex], b, bhi, blo, product1, product0);
+        TwoSum(q, product0, sum, hh);
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+        FastTwoSum(product1, sum, q, hh);
+        if (hh != 0.0) {
+            h[hindex++] = hh;
+        }
+    }
+    if (q != 0.0 || hindex == 0) {
+        h[hindex++] = q;
+    }
+    return hindex;
+}
+
+static Expansion Sum(const Expansion& e, const Expansion& f) {
+    Expansion h(e.size()+f.size());
+    h.resize(FastExpansionSumZeroElim(static_cast<int>(e.size()), e.data(),
+                                      static_cast<int>(f.size()), f.data(),
+                                      h.data()));
+    return h;
+}
+
+static Expansion Difference(const Expansion& e, Expansion f) {
+    for (auto& component : f) {
+        component = -component;
+    }
+    return Sum(e, f);
+}
+
+static Expansion Product(const Expansion& e, const Expansion& f) {
+    Expansion h(1, 0.0);
+    Expansion scaled(2*e.size());
+    for (double component : f) {
+        scaled.resize(2*e.size());
+        scaled.resize(ScaleExpansionZeroElim(static_cast<int>(e.size()),
+                                             e.data(), component,
+                                             scaled.data()));
+        h = Sum(h, scaled);
+    }
+    return h;
+}
+
+//! @brief a-b as an expansion of at most two components.
+static Expansion Difference(const double a, const double b) {
+    double x, y;
+    TwoDiff(a, b, x, y);
+    return y == 0.0 ? Expansion(1, x) : Expansion({ y, x });
+}
+
+static Sign SignOf(const double x) {
+    return x > 0.0 ? SIGN_POSITIVE : (x < 0.0 ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+static Sign SignOf(const Expansion& e) {
+    return SignOf(e.back());
+}
+
+//=============================================================================
+// Implementation: orient2d
+//=============================================================================
+
+/*!
+ * @brief Stages B-D of orient2d: the determinant of the rounded differences
+ * exactly, then with first-order tail corrections, then fully exact.
+ */
+static double Orient2DAdapt(const double* pa, const double* pb,
+                            const double* pc, const double detsum) {
+    double acx = pa[0]-pc[0];
+    double bcx = pb[0]-pc[0];
+    double acy = pa[1]-pc[1];
+    double bcy = pb[1]-pc[1];
+
+    double detleft, detlefttail, detright, detrighttail;
+    TwoProduct(acx, bcy, detleft, detlefttail);
+    TwoProduct(acy, bcx, detright, detrighttail);
+
+    double B[4];
+    TwoTwoDiff(detleft, detlefttail, detright, detrighttail, B);
+    double det = B[0]+B[1]+B[2]+B[3];
+    double errbound = kCcwErrBoundB*detsum;
+    if (det >= errbound || -det >= errbound) {
+        return det;
+    }
+
+    double acxtail, acytail, bcxtail, bcytail;
+    TwoDiffTail(pa[0], pc[0], acx, acxtail);
+    TwoDiffTail(pb[0], pc[0], bcx, bcxtail);
+    TwoDiffTail(pa[1], pc[1], acy, acytail);
+    TwoDiffTail(pb[1], pc[1], bcy, bcytail);
+    if (acxtail == 0.0 && acytail == 0.0 &&
+        bcxtail == 0.0 && bcytail == 0.0) {
+        return det;
+    }
+
+    errbound = kCcwErrBoundC*detsum+kResultErrBound*std::fabs(det);
+    det += (acx*bcytail+bcy*acxtail)-(acy*bcxtail+bcx*acytail);
+    if (det >= errbound || -det >= errbound) {
+        return det;
+    }
+
+    double s1, s0, t1, t0, u[4], C1[8], C2[12], D[16];
+    TwoProduct(acxtail, bcy, s1, s0);
+    TwoProduct(acytail, bcx, t1, t0);
+    TwoTwoDiff(s1, s0, t1, t0, u);
+    int c1length = FastExpansionSumZeroElim(4, B, 4, u, C1);
+
+    TwoProduct(acx, bcytail, s1, s0);
+    TwoProduct(acy, bcxtail, t1, t0);
+    TwoTwoDiff(s1, s0, t1, t0, u);
+    int c2length = FastExpansionSumZeroElim(c1length, C1, 4, u, C2);
+
+    TwoProduct(acxtail, bcytail, s1, s0);
+    TwoProduct(acytail, bcxtail, t1, t0);
+    TwoTwoDiff(s1, s0, t1, t0, u);
+    int dlength = FastExpansionSumZeroElim(c2length, C2, 4, u, D);
+
+    return D[dlength-1];
+}
+
+static Sign Orient2D(const double* pa, const double* pb, const double* pc) {
+    double detleft = (pa[0]-pc[0])*(pb[1]-pc[1]);
+    double detright = (pa[1]-pc[1])*(pb[0]-pc[0]);
+    double det = detleft-detright;
+    double detsum;
+
+    if (detleft > 0.0) {
+        if (detright <= 0.0) {
+            return SignOf(det);
+        }
+        detsum = detleft+detright;
+    } else if (detleft < 0.0) {
+        if (detright >= 0.0) {
+            return SignOf(det);
+        }
+        detsum = -detleft-detright;
+    } else {
+        return SignOf(det);
+    }
+
+    double errbound = kCcwErrBoundA*detsum;
+    if (det >= errbound || -det >= errbound) {
+        return SignOf(det);
+    }
+    return SignOf(Orient2DAdapt(pa, pb, pc, detsum));
+}
+
+//=============================================================================
+// Implementation: orient3d
+//=============================================================================
+
+static Sign Orient3DExact(const double* pa, const double* pb,
+                          const double* pc, const double* pd) {
+    Expansion adx = Difference(pa[0], pd[0]);
+    Expansion ady = Difference(pa[1], pd[1]);
+    Expansion adz = Difference(pa[2], pd[2]);
+    Expansion bdx = Difference(pb[0], pd[0]);
+    Expansion bdy = Difference(pb[1], pd[1]);
+    Expansion bdz = Difference(pb[2], pd[2]);
+    Expansion cdx = Difference(pc[0], pd[0]);
+    Expansion cdy = Difference(pc[1], pd[1]);
+    Expansion cdz = Difference(pc[2], pd[2]);
+
+    Expansion bc = Difference(Product(bdx, cdy), Product(cdx, bdy));
+    Expansion ca = Difference(Product(cdx, ady), Product(adx, cdy));
+    Expansion ab = Difference(Product(adx, bdy), Product(bdx, ady));
+
+    return SignOf(Sum(Sum(Product(adz, bc), Product(bdz, ca)),
+                      Product(cdz, ab)));
+}
+
+static Sign Orient3D(const double* pa, const double* pb, const double* pc,
+                     const double* pd) {
+    double adx = pa[0]-pd[0], ady = pa[1]-pd[1], adz = pa[2]-pd[2];
+    double bdx = pb[0]-pd[0], bdy = pb[1]-pd[1], bdz = pb[2]-pd[2];
+    double cdx = pc[0]-pd[0], cdy = pc[1]-pd[1], cdz = pc[2]-pd[2];
+
+    double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy;
+    double cdxady = cdx*ady, adxcdy = adx*cdy;
+    double adxbdy = adx*bdy, bdxady = bdx*ady;
+
+    double det = adz*(bdxcdy-cdxbdy)+
+                 bdz*(cdxady-adxcdy)+
+                 cdz*(adxbdy-bdxady);
+    double permanent = (std::fabs(bdxcdy)+std::fabs(cdxbdy))*std::fabs(adz)+
+                       (std::fabs(cdxady)+std::fabs(adxcdy))*std::fabs(bdz)+
+                       (std::fabs(adxbdy)+std::fabs(bdxady))*std::fabs(cdz);
+    double errbound = kO3dErrBoundA*permanent;
+    if (det > errbound || -det > errbound) {
+        return SignOf(det);
+    }
+    return Orient3DExact(pa, pb, pc, pd);
+}
+
+//=============================================================================
+// Implementation: incircle
+//=============================================================================
+
+static Sign InCircleExact(const double* pa, const double* pb,
+                          const double* pc, const double* pd) {
+    Expansion adx = Difference(pa[0], pd[0]);
+    Expansion ady = Difference(pa[1], pd[1]);
+    Expansion bdx = Difference(pb[0], pd[0]);
+    Expansion bdy = Difference(pb[1], pd[1]);
+    Expansion cdx = Difference(pc[0], pd[0]);
+    Expansion cdy = Difference(pc[1], pd[1]);
+
+    Expansion alift = Sum(Product(adx, adx), Product(ady, ady));
+    Expansion blift = Sum(Product(bdx, bdx), Product(bdy, bdy));
+    Expansion clift = Sum(Product(cdx, cdx), Product(cdy, cdy));
+
+    Expansion bc = Difference(Product(bdx, cdy), Product(cdx, bdy));
+    Expansion ca = Difference(Product(cdx, ady), Product(adx, cdy));
+    Expansion ab = Difference(Product(adx, bdy), Product(bdx, ady));
+
+    return SignOf(Sum(Sum(Product(alift, bc), Product(blift, ca)),
+                      Product(clift, ab)));
+}
+
+static Sign InCircle(const double* pa, const double* pb, const double* pc,
+                     const double* pd) {
+    double adx = pa[0]-pd[0], ady = pa[1]-pd[1];
+    double bdx = pb[0]-pd[0], bdy = pb[1]-pd[1];
+    double cdx = pc[0]-pd[0], cdy = pc[1]-pd[1];
+
+    double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy;
+    double cdxady = cdx*ady, adxcdy = adx*cdy;
+    double adxbdy = adx*bdy, bdxady = bdx*ady;
+    double alift = adx*adx+ady*ady;
+    double blift = bdx*bdx+bdy*bdy;
+    double clift = cdx*cdx+cdy*cdy;
+
+    double det = alift*(bdxcdy-cdxbdy)+
+                 blift*(cdxady-adxcdy)+
+                 clift*(adxbdy-bdxady);
+    double permanent = (std::fabs(bdxcdy)+std::fabs(cdxbdy))*alift+
+                       (std::fabs(cdxady)+std::fabs(adxcdy))*blift+
+                       (std::fabs(adxbdy)+std::fabs(bdxady))*clift;
+    double errbound = kIccErrBoundA*permanent;
+    if (det > errbound || -det > errbound) {
+        return SignOf(det);
+    }
+    return InCircleExact(pa, pb, pc, pd);
+}
+
+//=============================================================================
+// Implementation: insphere
+//=============================================================================
+
+static Sign InSphereExact(const double* pa, const double* pb,
+                          const double* pc, const double* pd,
+                          const double* pe) {
+    Expansion aex = Difference(pa[0], pe[0]);
+    Expansion aey = Difference(pa[1], pe[1]);
+    Expansion aez = Difference(pa[2], pe[2]);
+    Expansion bex = Difference(pb[0], pe[0]);
+    Expansion bey = Difference(pb[1], pe[1]);
+    Expansion bez = Difference(pb[2], pe[2]);
+    Expansion cex = Difference(pc[0], pe[0]);
+    Expansion cey = Difference(pc[1], pe[1]);
+    Expansion cez = Difference(pc[2], pe[2]);
+    Expansion dex = Difference(pd[0], pe[0]);
+    Expansion dey = Difference(pd[1], pe[1]);
+    Expansion dez = Difference(pd[2], pe[2]);
+
+    Expansion ab = Difference(Product(aex, bey), Product(bex, aey));
+    Expansion bc = Difference(Product(bex, cey), Product(cex, bey));
+    Expansion cd = Difference(Product(cex, dey), Product(dex, cey));
+    Expansion da = Difference(Product(dex, aey), Product(aex, dey));
+    Expansion ac = Difference(Product(aex, cey), Product(cex, aey));
+    Expansion bd = Difference(Product(bex, dey), Product(dex, bey));
+
+    Expansion abc = Sum(Difference(Product(aez, bc), Product(bez, ac)),
+                        Product(cez, ab));
+    Expansion bcd = Sum(Difference(Product(bez, cd), Product(cez, bd)),
+                        Product(dez, bc));
+    Expansion cda = Sum(Sum(Product(cez, da), Product(dez, ac)),
+                        Product(aez, cd));
+    Expansion dab = Sum(Sum(Product(dez, ab), Product(aez, bd)),
+                        Product(bez, da));
+
+    Expansion alift = Sum(Sum(Product(aex, aex), Product(aey, aey)),
+                          Product(aez, aez));
+    Expansion blift = Sum(Sum(Product(bex, bex), Product(bey, bey)),
+                          Product(bez, bez));
+    Expansion clift = Sum(Sum(Product(cex, cex), Product(cey, cey)),
+                          Product(cez, cez));
+    Expansion dlift = Sum(Sum(Product(dex, dex), Product(dey, dey)),
+                          Product(dez, dez));
+
+    return SignOf(Sum(Difference(Product(dlift, abc), Product(clift, dab)),
+                      Difference(Product(blift, cda), Product(alift, bcd))));
+}
+
+static Sign InSphere(const double* pa, const double* pb, const double* pc,
+                     const double* pd, const double* pe) {
+    double aex = pa[0]-pe[0], aey = pa[1]-pe[1], aez = pa[2]-pe[2];
+    double bex = pb[0]-pe[0], bey = pb[1]-pe[1], bez = pb[2]-pe[2];
+    double cex = pc[0]-pe[0], cey = pc[1]-pe[1], cez = pc[2]-pe[2];
+    double dex = pd[0]-pe[0], dey = pd[1]-pe[1], dez = pd[2]-pe[2];
+
+    double aexbey = aex*bey, bexaey = bex*aey;
+    double bexcey = bex*cey, cexbey = cex*bey;
+    double cexdey = cex*dey, dexcey = dex*cey;
+    double dexaey = dex*aey, aexdey = aex*dey;
+    double aexcey = aex*cey, cexaey = cex*aey;
+    double bexdey = bex*dey, dexbey = dex*bey;
+
+    double ab = aexbey-bexaey;
+    double bc = bexcey-cexbey;
+    double cd = cexdey-dexcey;
+    double da = dexaey-aexdey;
+    double ac = aexcey-cexaey;
+    double bd = bexdey-dexbey;
+
+    double abc = aez*bc-bez*ac+cez*ab;
+    double bcd = bez*cd-cez*bd+dez*bc;
+    double cda = cez*da+dez*ac+aez*cd;
+    double dab = dez*ab+aez*bd+bez*da;
+
+    double alift = aex*aex+aey*aey+aez*aez;
+    double blift = bex*bex+bey*bey+bez*bez;
+    double clift = cex*cex+cey*cey+cez*cez;
+    double dlift = dex*dex+dey*dey+dez*dez;
+
+    double det = (dlift*abc-clift*dab)+(blift*cda-alift*bcd);
+
+    double aezplus = std::fabs(aez), bezplus = std::fabs(bez);
+    double cezplus = std::fabs(cez), dezplus = std::fabs(dez);
+    double aexbeyplus = std::fabs(aexbey), bexaeyplus = std::fabs(bexaey);
+    double bexceyplus = std::fabs(bexcey), cexbeyplus = std::fabs(cexbey);
+    double cexdeyplus = std::fabs(cexdey), dexceyplus = std::fabs(dexcey);
+    double dexaeyplus = std::fabs(dexaey), aexdeyplus = std::fabs(aexdey);
+    double aexceyplus = std::fabs(aexcey), cexaeyplus = std::fabs(cexaey);
+    double bexdeyplus = std::fabs(bexdey), dexbeyplus = std::fabs(dexbey);
+    double permanent =
+        ((cexdeyplus+dexceyplus)*bezplus+
+         (dexbeyplus+bexdeyplus)*cezplus+
+         (bexceyplus+cexbeyplus)*dezplus)*alift+
+        ((dexaeyplus+aexdeyplus)*cezplus+
+         (aexceyplus+cexaeyplus)*dezplus+
+         (cexdeyplus+dexceyplus)*aezplus)*blift+
+        ((aexbeyplus+bexaeyplus)*dezplus+
+         (bexdeyplus+dexbeyplus)*aezplus+
+         (dexaeyplus+aexdeyplus)*bezplus)*clift+
+        ((bexceyplus+cexbeyplus)*aezplus+
+         (cexaeyplus+aexceyplus)*bezplus+
+         (aexbeyplus+bexaeyplus)*cezplus)*dlift;
+    double errbound = kIspErrBoundA*permanent;
+    if (det > errbound || -det > errbound) {
+        return SignOf(det);
+    }
+    return InSphereExact(pa, pb, pc, pd, pe);
+}
+
+//=============================================================================
+// Implementation: Predicates
+//=============================================================================
+
+Sign Orient2DSign(const Point_2f& a, const Point_2f& b, const Point_2f& c) {
+    const double pa[2] = { a.x(), a.y() };
+    const double pb[2] = { b.x(), b.y() };
+    const double pc[2] = { c.x(), c.y() };
+    return Orient2D(pa, pb, pc);
+}
+
+Sign Orient3DSign(const Point_3f& a, const Point_3f& b, const Point_3f& c,
+                  const Point_3f& d) {
+    const double pa[3] = { a.x(), a.y(), a.z() };
+    const double pb[3] = { b.x(), b.y(), b.z() };
+    const double pc[3] = { c.x(), c.y(), c.z() };
+    const double pd[3] = { d.x(), d.y(), d.z() };
+    return Orient3D(pa, pb, pc, pd);
+}
+
+Sign InCircleSign(const Point_2f& a, const Point_2f& b, const Point_2f& c,
+                  const Point_2f& d) {
+    const double pa[2] = { a.x(), a.y() };
+    const double pb[2] = { b.x(), b.y() };
+    const double pc[2] = { c.x(), c.y() };
+    const double pd[2] = { d.x(), d.y() };
+    return InCircle(pa, pb, pc, pd);
+}
+
+Sign InSphereSign(const Point_3f& a, const Point_3f& b, const Point_3f& c,
+                  const Point_3f& d, const Point_3f& e) {
+    const double pa[3] = { a.x(), a.y(), a.z() };
+    const double pb[3] = { b.x(), b.y(), b.z() };
+    const double pc[3] = { c.x(), c.y(), c.z() };
+    const double pd[3] = { d.x(), d.y(), d.z() };
+    const double pe[3] = { e.x(), e.y(), e.z() };
+    return InSphere(pa, pb, pc, pd, pe);
+}
+
+} // namespace Predicate
+
+} // namespace DDAD
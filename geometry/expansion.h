@@ -0,0 +1,66 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Exact predicates on floating-point points using adaptive-precision
+ * expansion arithmetic, after Shewchuk, "Adaptive Precision Floating-Point
+ * Arithmetic and Fast Robust Geometric Predicates".
+ *
+ * Every predicate first evaluates its determinant in double precision and
+ * returns if a forward error bound certifies the sign. Otherwise the
+ * determinant is recomputed as a floating-point expansion, a sum of
+ * nonoverlapping doubles, which is exact; orient2d additionally refines the
+ * estimate in two intermediate stages before going fully exact. No GMP
+ * arithmetic is involved.
+ *
+ * The results are exact as long as no intermediate overflows or underflows,
+ * which holds for coordinates of moderate magnitude such as those of Point_2f
+ * and Point_3f. Requires IEEE double arithmetic with round-to-nearest and no
+ * extended precision registers, i.e. no x87 code and no -ffast-math.
+ */
+
+#ifndef GE_EXPANSION_H
+#define GE_EXPANSION_H
+
+#include "common.h"
+#include "point.h"
+
+namespace DDAD {
+
+namespace Predicate {
+
+//! @brief Positive if a, b, c are in counterclockwise order.
+Sign Orient2DSign(const Point_2f& a, const Point_2f& b, const Point_2f& c);
+
+//! @brief Positive if d lies below the plane through a, b, c, where below
+//! means that a, b, c appear counterclockwise when viewed from above.
+Sign Orient3DSign(const Point_3f& a, const Point_3f& b, const Point_3f& c,
+                  const Point_3f& d);
+
+//! @brief Positive if d lies inside the circle through a, b, c, which must
+//! be in counterclockwise order; the sign flips otherwise.
+Sign InCircleSign(const Point_2f& a, const Point_2f& b, const Point_2f& c,
+                  const Point_2f& d);
+
+//! @brief Positive if e lies inside the sphere through a, b, c, d, which
+//! must have positive Orient3DSign; the sign flips otherwise.
+Sign InSphereSign(const Point_3f& a, const Point_3f& b, const Point_3f& c,
+                  const Point_3f& d, const Point_3f& e);
+
+} // namespace Predicate
+
+} // namespace DDAD
+
+#endif // GE_EXPANSION_H
@@ -0,0 +1,211 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "homogeneous.h"
+#include "line.h"
+
+namespace DDAD {
+
+//! @brief n/d as a canonical rational.
+static rational Ratio(const integer& n, const integer& d) {
+    rational r(n, d);
+    r.canonicalize();
+    return r;
+}
+
+/*!
+ * @brief Writes the rationals in as integers over their least common
+ * denominator, which goes to the last slot of out.
+ */
+template <size_t N>
+static void ClearDenominators(const std::array<rational, N-1>& in,
+                              std::array<integer, N>& out) {
+    integer& w = out[N-1];
+    w = 1;
+    for (size_t i = 0; i < N-1; ++i) {
+        integer den = in[i].get_den();
+        mpz_lcm(w.get_mpz_t(), w.get_mpz_t(), den.get_mpz_t());
+    }
+    for (size_t i = 0; i < N-1; ++i) {
+        integer den = in[i].get_den();
+        mpz_divexact(out[i].get_mpz_t(), w.get_mpz_t(), den.get_mpz_t());
+        out[i] *= in[i].get_num();
+    }
+}
+
+//=============================================================================
+// Implementation: Point_2h
+//=============================================================================
+
+Point_2h::Point_2h(const integer& x, const integer& y, const integer& w) {
+    assert(w != 0);
+    if (w < 0) {
+        elements_[0] = -x;
+        elements_[1] = -y;
+        elements_[2] = -w;
+    } else {
+        elements_[0] = x;
+        elements_[1] = y;
+        elements_[2] = w;
+    }
+}
+
+Point_2h::Point_2h(const Point_2i& p) {
+    elements_[0] = p.x();
+    elements_[1] = p.y();
+    elements_[2] = 1;
+}
+
+Point_2h::Point_2h(const Point_2r& p) {
+    ClearDenominators<3>(p.elements(), elements_);
+}
+
+//! @brief Compares the represented rational points, not the triples.
+bool operator==(const Point_2h& lhs, const Point_2h& rhs) {
+    return lhs.x()*rhs.w() == rhs.x()*lhs.w() &&
+           lhs.y()*rhs.w() == rhs.y()*lhs.w();
+}
+
+Point_2r ToPoint_2r(const Point_2h& p) {
+    return Point_2r(Ratio(p.x(), p.w()), Ratio(p.y(), p.w()));
+}
+
+//=============================================================================
+// Implementation: Point_3h
+//=============================================================================
+
+Point_3h::Point_3h(const integer& x, const integer& y, const integer& z,
+                   const integer& w) {
+    assert(w != 0);
+    if (w < 0) {
+        elements_[0] = -x;
+        elements_[1] = -y;
+        elements_[2] = -z;
+        elements_[3] = -w;
+    } else {
+        elements_[0] = x;
+        elements_[1] = y;
+        elements_[2] = z;
+        elements_[3] = w;
+    }
+}
+
+Point_3h::Point_3h(const Point_3i& p) {
+    elements_[0] = p.x();
+    elements_[1] = p.y();
+    elements_[2] = p.z();
+    elements_[3] = 1;
+}
+
+Point_3h::Point_3h(const Point_3r& p) {
+    ClearDenominators<4>(p.elements(), elements_);
+}
+
+//! @brief Compares the represented rational points, not the tuples.
+bool operator==(const Point_3h& lhs, const Point_3h& rhs) {
+    return lhs.x()*rhs.w() == rhs.x()*lhs.w() &&
+           lhs.y()*rhs.w() == rhs.y()*lhs.w() &&
+           lhs.z()*rhs.w() == rhs.z()*lhs.w();
+}
+
+Point_3r ToPoint_3r(const Point_3h& p) {
+    return Point_3r(Ratio(p.x(), p.w()), Ratio(p.y(), p.w()),
+                    Ratio(p.z(), p.w()));
+}
+
+//=============================================================================
+// Implementation: Line_2h
+//=============================================================================
+
+Line_2h::Line_2h(const Line_2r& l) {
+    *this = Line_2h(Point_2h(l.p()), Point_2h(l.q()));
+}
+
+// Predicates =================================================================
+
+namespace Predicate {
+
+bool AIsLeftOfB(const Point_2h& a, const Point_2h& b) {
+    integer ax = a.x()*b.w();
+    integer bx = b.x()*a.w();
+    return ax < bx || (ax == bx && a.y()*b.w() < b.y()*a.w());
+}
+
+Orientation OrientationPQR(const Point_2h& p, const Point_2h& q,
+                           const Point_2h& r) {
+    DDAD_PROFILE_SITE("Predicate::OrientationPQR(Point_2h)");
+    return OrientationPQR(Line_2h(p, q), r);
+}
+
+Orientation OrientationPQR(const Line_2h& pq, const Point_2h& r) {
+    int s = sgn(Dot(pq, r));
+    if (s > 0) {
+        return ORIENTATION_LEFT;
+    } else if (s < 0) {
+        return ORIENTATION_RIGHT;
+    } else {
+        return ORIENTATION_COLINEAR;
+    }
+}
+
+bool AreParallel(const Line_2h& a, const Line_2h& b) {
+    return a.a()*b.b() == a.b()*b.a();
+}
+
+/*!
+ * With all w > 0 the 4x4 determinant of the homogeneous rows has the sign
+ * of det[a-d; b-d; c-d]. Expanded by 2x2 minors of the first two columns.
+ */
+Sign Orient3D(const Point_3h& a, const Point_3h& b, const Point_3h& c,
+              const Point_3h& d) {
+    DDAD_PROFILE_SITE("Predicate::Orient3D(Point_3h)");
+    integer m01 = a.x()*b.y()-b.x()*a.y();
+    integer m02 = a.x()*c.y()-c.x()*a.y();
+    integer m03 = a.x()*d.y()-d.x()*a.y();
+    integer m12 = b.x()*c.y()-c.x()*b.y();
+    integer m13 = b.x()*d.y()-d.x()*b.y();
+    integer m23 = c.x()*d.y()-d.x()*c.y();
+
+    integer n01 = a.z()*b.w()-b.z()*a.w();
+    integer n02 = a.z()*c.w()-c.z()*a.w();
+    integer n03 = a.z()*d.w()-d.z()*a.w();
+    integer n12 = b.z()*c.w()-c.z()*b.w();
+    integer n13 = b.z()*d.w()-d.z()*b.w();
+    integer n23 = c.z()*d.w()-d.z()*c.w();
+
+    integer det = m01*n23-m02*n13+m03*n12+m12*n03-m13*n02+m23*n01;
+
+    int s = sgn(det);
+    return s > 0 ? SIGN_POSITIVE : (s < 0 ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+} // namespace Predicate
+
+// Constructions ==============================================================
+
+namespace Construction {
+
+Point_2h Meet(const Line_2h& a, const Line_2h& b) {
+    DDAD_PROFILE_SITE("Construction::Meet");
+    assert(!Predicate::AreParallel(a, b));
+    return Point_2h(a.b()*b.c()-a.c()*b.b(),
+                    a.c()*b.a()-a.a()*b.c(),
+                    a.a()*b.b()-a.b()*b.a());
+}
+
+} // namespace Construction
+
+} // namespace DDAD
@@ -0,0 +1,286 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Homogeneous integer point and line types for division-free exact
+ * predicates and constructions.
+ *
+ * A rational point (x/w, y/w) is stored as the integer triple (x : y : w)
+ * with w > 0. Predicates and constructions on these types only add and
+ * multiply integers, so they never pay for the gcd that canonicalizes every
+ * mpq_class operation. Convert from and to Point_2r/Point_3r at the API
+ * boundary.
+ */
+
+#ifndef GE_HOMOGENEOUS_H
+#define GE_HOMOGENEOUS_H
+
+#include "common.h"
+#include "arithmetic.h"
+#include "point.h"
+
+namespace DDAD {
+
+class Line_2r;
+
+//=============================================================================
+// Interface: Point_2h
+//=============================================================================
+
+class Point_2h {
+public:
+    Point_2h();
+    Point_2h(const integer& x, const integer& y, const integer& w = 1);
+    explicit Point_2h(const Point_2i& p);
+    explicit Point_2h(const Point_2r& p);
+
+    const integer& x() const;
+    const integer& y() const;
+    const integer& w() const;
+    const std::array<integer, 3>& elements() const;
+
+private:
+    std::array<integer, 3> elements_;
+};
+
+bool operator==(const Point_2h& lhs, const Point_2h& rhs);
+bool operator!=(const Point_2h& lhs, const Point_2h& rhs);
+std::ostream& operator<<(std::ostream& o, const Point_2h& p);
+std::string to_string(const Point_2h& p);
+
+Point_2r ToPoint_2r(const Point_2h& p);
+
+//=============================================================================
+// Interface: Point_3h
+//=============================================================================
+
+class Point_3h {
+public:
+    Point_3h();
+    Point_3h(const integer& x, const integer& y, const integer& z,
+             const integer& w = 1);
+    explicit Point_3h(const Point_3i& p);
+    explicit Point_3h(const Point_3r& p);
+
+    const integer& x() const;
+    const integer& y() const;
+    const integer& z() const;
+    const integer& w() const;
+    const std::array<integer, 4>& elements() const;
+
+private:
+    std::array<integer, 4> elements_;
+};
+
+bool operator==(const Point_3h& lhs, const Point_3h& rhs);
+bool operator!=(const Point_3h& lhs, const Point_3h& rhs);
+std::ostream& operator<<(std::ostream& o, const Point_3h& p);
+std::string to_string(const Point_3h& p);
+
+Point_3r ToPoint_3r(const Point_3h& p);
+
+//=============================================================================
+// Interface: Line_2h
+//=============================================================================
+
+/*!
+ * @brief The Line_2h class is an oriented line ax+by+cw = 0. The line
+ * through p and q is their cross product, which puts points left of pq on
+ * the positive side.
+ */
+class Line_2h {
+public:
+    Line_2h();
+    Line_2h(const integer& a, const integer& b, const integer& c);
+    Line_2h(const Point_2h& p, const Point_2h& q);
+    explicit Line_2h(const Line_2r& l);
+
+    const integer& a() const;
+    const integer& b() const;
+    const integer& c() const;
+
+private:
+    std::array<integer, 3> elements_;
+};
+
+std::ostream& operator<<(std::ostream& o, const Line_2h& l);
+std::string to_string(const Line_2h& l);
+
+//! @brief Signed, unnormalized offset ax+by+cw of p from l.
+integer Dot(const Line_2h& l, const Point_2h& p);
+
+// Predicates =================================================================
+
+namespace Predicate {
+
+bool AIsLeftOfB(const Point_2h& a, const Point_2h& b);
+Orientation OrientationPQR(const Point_2h& p, const Point_2h& q,
+                           const Point_2h& r);
+Orientation OrientationPQR(const Line_2h& pq, const Point_2h& r);
+bool AreParallel(const Line_2h& a, const Line_2h& b);
+
+//! @brief Sign of the 3D orientation determinant of a, b, c, d.
+Sign Orient3D(const Point_3h& a, const Point_3h& b, const Point_3h& c,
+              const Point_3h& d);
+
+} // namespace Predicate
+
+// Constructions ==============================================================
+
+namespace Construction {
+
+//! @brief Intersection point of two non-parallel lines.
+Point_2h Meet(const Line_2h& a, const Line_2h& b);
+
+} // namespace Construction
+
+//=============================================================================
+// Implementation: Point_2h
+//=============================================================================
+
+inline Point_2h::Point_2h() {
+    elements_[0] = 0;
+    elements_[1] = 0;
+    elements_[2] = 1;
+}
+
+inline bool operator!=(const Point_2h& lhs, const Point_2h& rhs) {
+    return !(lhs == rhs);
+}
+
+inline std::ostream& operator<<(std::ostream& o, const Point_2h& p) {
+    return o << to_string(p);
+}
+
+//! @brief Represents this point as (x : y : w).
+inline std::string to_string(const Point_2h& p) {
+    std::stringstream ss;
+    ss << "(" << p.x() << " : " << p.y() << " : " << p.w() << ")";
+    return ss.str();
+}
+
+// Accessors/Mutators =========================================================
+
+inline const integer& Point_2h::x() const {
+    return elements_[0];
+}
+inline const integer& Point_2h::y() const {
+    return elements_[1];
+}
+inline const integer& Point_2h::w() const {
+    return elements_[2];
+}
+inline const std::array<integer, 3>& Point_2h::elements() const {
+    return elements_;
+}
+
+//=============================================================================
+// Implementation: Point_3h
+//=============================================================================
+
+inline Point_3h::Point_3h() {
+    elements_[0] = 0;
+    elements_[1] = 0;
+    elements_[2] = 0;
+    elements_[3] = 1;
+}
+
+inline bool operator!=(const Point_3h& lhs, const Point_3h& rhs) {
+    return !(lhs == rhs);
+}
+
+inline std::ostream& operator<<(std::ostream& o, const Point_3h& p) {
+    return o << to_string(p);
+}
+
+//! @brief Represents this point as (x : y : z : w).
+inline std::string to_string(const Point_3h& p) {
+    std::stringstream ss;
+    ss << "(" << p.x() << " : " << p.y() << " : " << p.z() << " : "
+       << p.w() << ")";
+    return ss.str();
+}
+
+// Accessors/Mutators =========================================================
+
+inline const integer& Point_3h::x() const {
+    return elements_[0];
+}
+inline const integer& Point_3h::y() const {
+    return elements_[1];
+}
+inline const integer& Point_3h::z() const {
+    return elements_[2];
+}
+inline const integer& Point_3h::w() const {
+    return elements_[3];
+}
+inline const std::array<integer, 4>& Point_3h::elements() const {
+    return elements_;
+}
+
+//=============================================================================
+// Implementation: Line_2h
+//=============================================================================
+
+inline Line_2h::Line_2h() {
+    elements_[0] = 0;
+    elements_[1] = 0;
+    elements_[2] = 0;
+}
+
+inline Line_2h::Line_2h(const integer& a, const integer& b,
+                        const integer& c) {
+    elements_[0] = a;
+    elements_[1] = b;
+    elements_[2] = c;
+}
+
+inline Line_2h::Line_2h(const Point_2h& p, const Point_2h& q) {
+    elements_[0] = p.y()*q.w()-p.w()*q.y();
+    elements_[1] = p.w()*q.x()-p.x()*q.w();
+    elements_[2] = p.x()*q.y()-p.y()*q.x();
+}
+
+inline integer Dot(const Line_2h& l, const Point_2h& p) {
+    return l.a()*p.x()+l.b()*p.y()+l.c()*p.w();
+}
+
+inline std::ostream& operator<<(std::ostream& o, const Line_2h& l) {
+    return o << to_string(l);
+}
+
+//! @brief Represents this line as [a : b : c].
+inline std::string to_string(const Line_2h& l) {
+    std::stringstream ss;
+    ss << "[" << l.a() << " : " << l.b() << " : " << l.c() << "]";
+    return ss.str();
+}
+
+// Accessors/Mutators =========================================================
+
+inline const integer& Line_2h::a() const {
+    return elements_[0];
+}
+inline const integer& Line_2h::b() const {
+    return elements_[1];
+}
+inline const integer& Line_2h::c() const {
+    return elements_[2];
+}
+
+} // namespace DDAD
+
+#endif // GE_HOMOGENEOUS_H
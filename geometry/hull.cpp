@@ -0,0 +1,55 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Thread management for the parallel convex hull.
+ */
+
+#include "common.h"
+#include "hull.h"
+
+#include <thread>
+
+namespace DDAD {
+
+//=============================================================================
+// Implementation: Workers
+//=============================================================================
+
+size_t WorkerCount(const size_t threads, const size_t count,
+                   const size_t min_share) {
+    size_t workers = threads;
+    if (workers == 0) {
+        workers = std::thread::hardware_concurrency();
+    }
+    workers = std::min(workers, count/std::max<size_t>(min_share, 1));
+    return std::max<size_t>(workers, 1);
+}
+
+void ParallelFor(const size_t count, const std::function<void(size_t)>& task) {
+    std::vector<std::thread> workers;
+    workers.reserve(count > 0 ? count-1 : 0);
+    for (size_t i = 1; i < count; ++i) {
+        workers.push_back(std::thread(task, i));
+    }
+    if (count > 0) {
+        task(0);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace DDAD
@@ -0,0 +1,385 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Multi-threaded convex hull of unordered 2D point sets.
+ *
+ * The hull is computed in three parallel passes over the input:
+ *
+ * 1. Each thread finds the extreme points of its share of the input in
+ *    the four axis and four diagonal directions, and these are reduced to
+ *    the Akl-Toussaint octagon.
+ * 2. Each thread discards the points of its share strictly inside the
+ *    octagon, which cannot be hull vertices, and sorts the rest into
+ *    slabs, lexicographically ordered ranges of points bounded by
+ *    splitters sampled from the input.
+ * 3. Each thread takes one slab, sorts it and hulls it with Andrew's
+ *    monotone chain.
+ *
+ * Slabs are lexicographically separated, so their hulls are merged left to
+ * right by finding the lower and upper bridges between neighbours. All
+ * decisions are made by the predicates of the kernel, so the hull is exact
+ * whenever the kernel is; see kernel.h.
+ */
+
+#ifndef GE_HULL_H
+#define GE_HULL_H
+
+#include "common.h"
+#include "kernel.h"
+#include "pointbuffer.h"
+
+#include <functional>
+
+namespace DDAD {
+
+//=============================================================================
+// Interface: ParallelConvexHull
+//=============================================================================
+
+/*!
+ * @brief Indices of the vertices of the convex hull of points[0, count), in
+ * counterclockwise order from the lexicographically smallest. Only
+ * strictly convex vertices are reported, and of duplicate points only one.
+ * @param threads - number of worker threads, or 0 for one per core.
+ */
+template <class Kernel>
+std::vector<size_t> ParallelConvexHullIndices(
+    const typename Kernel::Point_2* points, const size_t count,
+    const size_t threads = 0);
+
+template <class Kernel>
+std::vector<typename Kernel::Point_2> ParallelConvexHull(
+    const std::vector<typename Kernel::Point_2>& points,
+    const size_t threads = 0);
+
+//! @brief As above; every point is materialized once, in parallel.
+template <class Kernel>
+std::vector<typename Kernel::Point_2> ParallelConvexHull(
+    const PointBufferView<typename Kernel::Number, 2>& points,
+    const size_t threads = 0);
+
+//! @brief Worker threads to use for count items: threads, or one per core
+//! if it is 0, but no more than keeps min_share items on each.
+size_t WorkerCount(const size_t threads, const size_t count,
+                   const size_t min_share);
+
+//! @brief Runs task(0), ..., task(count-1) on count threads, task(0) on the
+//! calling one, and returns when all have finished.
+void ParallelFor(const size_t count, const std::function<void(size_t)>& task);
+
+//=============================================================================
+// Implementation: ParallelConvexHull
+//=============================================================================
+
+//! @brief Approximate value of a coordinate, for ranking points only.
+inline double ApproxCoordinate(const float x) {
+    return x;
+}
+
+inline double ApproxCoordinate(const int64_t x) {
+    return static_cast<double>(x);
+}
+
+template <class T>
+inline double ApproxCoordinate(const T& x) {
+    return x.get_d();
+}
+
+/*!
+ * @brief Directions k = 0, ..., 7 are the compass directions
+ * counterclockwise from -x. FartherOnAxis tells whether p lies farther
+ * than q in the axis direction k, breaking ties lexicographically so that
+ * the extreme point is a hull vertex.
+ */
+template <class Kernel>
+bool FartherOnAxis(const size_t k, const typename Kernel::Point_2& p,
+                   const typename Kernel::Point_2& q) {
+    switch (k) {
+    case 0: return Kernel::AIsLeftOfB(p, q);
+    case 2: return Kernel::AIsBelowB(p, q);
+    case 4: return Kernel::AIsLeftOfB(q, p);
+    default: return Kernel::AIsBelowB(q, p);
+    }
+}
+
+/*!
+ * @brief Extent of a point in the diagonal direction k, in double
+ * precision. Rounding may pick a point that is not quite extreme, which
+ * only makes the filter discard fewer points: any input points serve as
+ * corners, as the filter tests them exactly.
+ */
+inline double DiagonalScore(const size_t k, const double x, const double y) {
+    double dx = (k == 1 || k == 7) ? -1.0 : 1.0;
+    double dy = (k == 1 || k == 3) ? -1.0 : 1.0;
+    return dx*x+dy*y;
+}
+
+template <class Point>
+inline double DiagonalScore(const size_t k, const Point& p) {
+    return DiagonalScore(k, ApproxCoordinate(p.x()), ApproxCoordinate(p.y()));
+}
+
+//! @brief First index of the share of the given worker.
+inline size_t WorkerBegin(const size_t worker, const size_t workers,
+                          const size_t count) {
+    return worker*count/workers;
+}
+
+/*!
+ * @brief Appends chain B to chain A through their bridge. Both are convex
+ * chains in lexicographic order, lower chains if turn is ORIENTATION_LEFT
+ * and upper chains if it is ORIENTATION_RIGHT, and every point of A
+ * precedes every point of B. Vertices that end up on the bridge are
+ * dropped.
+ */
+template <class Kernel>
+void MergeHullChains(const typename Kernel::Point_2* points,
+                     std::vector<size_t>& A, const std::vector<size_t>& B,
+                     const Orientation turn) {
+    if (B.empty()) {
+        return;
+    }
+    if (A.empty()) {
+        A = B;
+        return;
+    }
+
+    size_t i = A.size()-1;
+    size_t j = 0;
+    bool moved = true;
+    while (moved) {
+        moved = false;
+        while (i > 0 && Kernel::OrientationPQR(points[A[i]], points[B[j]],
+                                               points[A[i-1]]) != turn) {
+            --i;
+            moved = true;
+        }
+        while (j+1 < B.size() &&
+               Kernel::OrientationPQR(points[A[i]], points[B[j]],
+                                      points[B[j+1]]) != turn) {
+            ++j;
+            moved = true;
+        }
+    }
+
+    A.resize(i+1);
+    A.insert(A.end(), B.begin()+j, B.end());
+}
+
+//! @brief Lower and upper hull chains of the given points, sorted in place,
+//! by Andrew's monotone chain.
+template <class Kernel>
+void MonotoneChain(const typename Kernel::Point_2* points,
+                   std::vector<size_t>& slab, std::vector<size_t>& lower,
+                   std::vector<size_t>& upper) {
+    typedef typename Kernel::Point_2 Point;
+
+    std::sort(begin(slab), end(slab), [&](size_t a, size_t b) {
+        return Kernel::AIsLeftOfB(points[a], points[b]);
+    });
+    slab.erase(std::unique(begin(slab), end(slab), [&](size_t a, size_t b) {
+        return points[a] == points[b];
+    }), end(slab));
+
+    auto extend = [&](std::vector<size_t>& chain, const size_t i,
+                      const Orientation turn) {
+        const Point& p = points[i];
+        while (chain.size() > 1 &&
+               Kernel::OrientationPQR(points[chain[chain.size()-2]],
+                                      points[chain.back()], p) != turn) {
+            chain.pop_back();
+        }
+        chain.push_back(i);
+    };
+    for (size_t i : slab) {
+        extend(lower, i, ORIENTATION_LEFT);
+        extend(upper, i, ORIENTATION_RIGHT);
+    }
+}
+
+template <class Kernel>
+std::vector<size_t> ParallelConvexHullIndices(
+        const typename Kernel::Point_2* points, const size_t count,
+        const size_t threads) {
+    typedef typename Kernel::Point_2 Point;
+    static const size_t kMinShare = 1 << 14;
+    static const size_t kSamplesPerSlab = 64;
+
+    if (count == 0) {
+        return std::vector<size_t>();
+    }
+    const size_t workers = WorkerCount(threads, count, kMinShare);
+
+    // pass 1: extreme points of each share in eight directions
+    std::vector<std::array<size_t, 8>> extremes(workers);
+    ParallelFor(workers, [&](size_t w) {
+        size_t begin = WorkerBegin(w, workers, count);
+        size_t end = WorkerBegin(w+1, workers, count);
+        std::array<size_t, 8>& e = extremes[w];
+        std::array<double, 8> score;
+        e.fill(begin);
+        for (size_t k = 1; k < 8; k += 2) {
+            score[k] = DiagonalScore(k, points[begin]);
+        }
+        for (size_t i = begin+1; i < end; ++i) {
+            const Point& p = points[i];
+            for (size_t k = 0; k < 8; k += 2) {
+                if (FartherOnAxis<Kernel>(k, p, points[e[k]])) e[k] = i;
+            }
+            double x = ApproxCoordinate(p.x());
+            double y = ApproxCoordinate(p.y());
+            for (size_t k = 1; k < 8; k += 2) {
+                double s = DiagonalScore(k, x, y);
+                if (s > score[k]) {
+                    score[k] = s;
+                    e[k] = i;
+                }
+            }
+        }
+    });
+    std::array<size_t, 8> octagon = extremes[0];
+    for (size_t w = 1; w < workers; ++w) {
+        for (size_t k = 0; k < 8; ++k) {
+            const Point& p = points[extremes[w][k]];
+            const Point& q = points[octagon[k]];
+            if (k % 2 == 0 ? FartherOnAxis<Kernel>(k, p, q)
+                           : DiagonalScore(k, p) > DiagonalScore(k, q)) {
+                octagon[k] = extremes[w][k];
+            }
+        }
+    }
+
+    // the extremes are in counterclockwise order, some of them repeated
+    std::vector<size_t> corners;
+    for (size_t k = 0; k < 8; ++k) {
+        if (corners.empty() || points[corners.back()] != points[octagon[k]]) {
+            corners.push_back(octagon[k]);
+        }
+    }
+    while (corners.size() > 1 &&
+           points[corners.back()] == points[corners.front()]) {
+        corners.pop_back();
+    }
+    auto discard = [&](const Point& p) {
+        if (corners.size() < 3) {
+            return false;
+        }
+        for (size_t k = 0; k < corners.size(); ++k) {
+            const Point& a = points[corners[k]];
+            const Point& b = points[corners[(k+1)%corners.size()]];
+            if (Kernel::OrientationPQR(a, b, p) != ORIENTATION_LEFT) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // splitters between slabs, sampled evenly from the input
+    std::vector<size_t> sample;
+    const size_t samples = std::min(count, kSamplesPerSlab*workers);
+    for (size_t s = 0; s < samples; ++s) {
+        sample.push_back(s*count/samples);
+    }
+    std::sort(begin(sample), end(sample), [&](size_t a, size_t b) {
+        return Kernel::AIsLeftOfB(points[a], points[b]);
+    });
+    std::vector<size_t> splitters;
+    for (size_t w = 1; w < workers; ++w) {
+        splitters.push_back(sample[w*samples/workers]);
+    }
+
+    // pass 2: discard interior points, sort the rest into slabs
+    std::vector<std::vector<std::vector<size_t>>> buckets(workers);
+    ParallelFor(workers, [&](size_t w) {
+        size_t begin = WorkerBegin(w, workers, count);
+        size_t end = WorkerBegin(w+1, workers, count);
+        buckets[w].resize(workers);
+        for (size_t i = begin; i < end; ++i) {
+            const Point& p = points[i];
+            if (discard(p)) {
+                continue;
+            }
+            // slab of p is the number of splitters not after it
+            size_t slab = std::upper_bound(
+                splitters.begin(), splitters.end(), i,
+                [&](size_t a, size_t b) {
+                    return Kernel::AIsLeftOfB(points[a], points[b]);
+                }) - splitters.begin();
+            buckets[w][slab].push_back(i);
+        }
+    });
+
+    // pass 3: hull each slab
+    std::vector<std::vector<size_t>> lower(workers);
+    std::vector<std::vector<size_t>> upper(workers);
+    ParallelFor(workers, [&](size_t w) {
+        std::vector<size_t> slab;
+        for (size_t v = 0; v < workers; ++v) {
+            slab.insert(slab.end(), buckets[v][w].begin(),
+                        buckets[v][w].end());
+            std::vector<size_t>().swap(buckets[v][w]);
+        }
+        MonotoneChain<Kernel>(points, slab, lower[w], upper[w]);
+    });
+
+    // merge slab hulls left to right
+    for (size_t w = 1; w < workers; ++w) {
+        MergeHullChains<Kernel>(points, lower[0], lower[w], ORIENTATION_LEFT);
+        MergeHullChains<Kernel>(points, upper[0], upper[w], ORIENTATION_RIGHT);
+    }
+
+    // lower chain, then upper chain back without its endpoints
+    std::vector<size_t> hull = lower[0];
+    for (size_t k = upper[0].size()-1; k-- > 1; ) {
+        hull.push_back(upper[0][k]);
+    }
+    return hull;
+}
+
+template <class Kernel>
+std::vector<typename Kernel::Point_2> ParallelConvexHull(
+        const std::vector<typename Kernel::Point_2>& points,
+        const size_t threads) {
+    std::vector<size_t> hull =
+        ParallelConvexHullIndices<Kernel>(points.data(), points.size(),
+                                          threads);
+
+    std::vector<typename Kernel::Point_2> vertices;
+    vertices.reserve(hull.size());
+    for (size_t i : hull) {
+        vertices.push_back(points[i]);
+    }
+    return vertices;
+}
+
+template <class Kernel>
+std::vector<typename Kernel::Point_2> ParallelConvexHull(
+        const PointBufferView<typename Kernel::Number, 2>& points,
+        const size_t threads) {
+    std::vector<typename Kernel::Point_2> materialized(points.size());
+    const size_t workers = WorkerCount(threads, points.size(), 1 << 14);
+    ParallelFor(workers, [&](size_t w) {
+        size_t end = WorkerBegin(w+1, workers, points.size());
+        for (size_t i = WorkerBegin(w, workers, points.size()); i < end; ++i) {
+            materialized[i] = points.point(i);
+        }
+    });
+    return ParallelConvexHull<Kernel>(materialized, threads);
+}
+
+} // namespace DDAD
+
+#endif // GE_HULL_H
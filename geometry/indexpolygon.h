@@ -0,0 +1,300 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Index-based polylines and polygons over a contiguous vertex pool.
+ *
+ * Polyline_2r and Polygon_2r hold a shared point per vertex so that the
+ * workbench can track each one. The types here are for batch work: the
+ * points live once in a VertexPool, by value and contiguous, and a chain is
+ * a vector of PointIndex into it. Building a chain of n vertices costs two
+ * allocations once reserved, and sharing the pool lets a hull refer to the
+ * vertices of its input without copying them. Chains keep a pointer to
+ * their pool, which must outlive them and is invalidated, like a
+ * PointBufferView, by anything that reallocates the pool.
+ */
+
+#ifndef GE_INDEXPOLYGON_H
+#define GE_INDEXPOLYGON_H
+
+#include "common.h"
+#include "point.h"
+#include "pointbuffer.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Interface: VertexPool
+//=============================================================================
+
+template <class Point>
+class VertexPool {
+public:
+    VertexPool();
+
+    PointIndex push_back(const Point& p);
+    void reserve(const size_t count);
+    void clear();
+
+    const Point& operator[](const PointIndex i) const;
+    const Point* data() const;
+    size_t size() const;
+    bool empty() const;
+
+private:
+    std::vector<Point> vertices_;
+};
+
+//=============================================================================
+// Interface: IndexPolyline
+//=============================================================================
+
+template <class Point>
+class IndexPolyline {
+public:
+    explicit IndexPolyline(const VertexPool<Point>& pool);
+
+    void Close();
+    void Open();
+
+    void push_back(const PointIndex i);
+    void pop_back();
+    void reserve(const size_t count);
+    void clear();
+
+    //! @brief The i-th vertex of the chain, not of the pool.
+    const Point& operator[](const size_t i) const;
+    PointIndex index(const size_t i) const;
+    size_t size() const;
+    bool empty() const;
+
+    const std::vector<PointIndex>& indices() const;
+    const VertexPool<Point>& pool() const;
+    bool closed() const;
+
+private:
+    const VertexPool<Point>* pool_;
+    std::vector<PointIndex> indices_;
+    bool closed_;
+};
+
+//=============================================================================
+// Interface: IndexPolygon
+//=============================================================================
+
+template <class Point>
+class IndexPolygon {
+public:
+    explicit IndexPolygon(const VertexPool<Point>& pool);
+
+    void push_back(const PointIndex i);
+    void pop_back();
+    void reserve(const size_t count);
+
+    const Point& operator[](const size_t i) const;
+    PointIndex index(const size_t i) const;
+    size_t size() const;
+
+    const IndexPolyline<Point>& boundary() const;
+
+private:
+    IndexPolyline<Point> boundary_;
+};
+
+typedef VertexPool<Point_2i> VertexPool_2i;
+typedef VertexPool<Point_2f> VertexPool_2f;
+typedef VertexPool<Point_2r> VertexPool_2r;
+
+typedef IndexPolyline<Point_2i> IndexPolyline_2i;
+typedef IndexPolyline<Point_2f> IndexPolyline_2f;
+typedef IndexPolyline<Point_2r> IndexPolyline_2r;
+
+typedef IndexPolygon<Point_2i> IndexPolygon_2i;
+typedef IndexPolygon<Point_2f> IndexPolygon_2f;
+typedef IndexPolygon<Point_2r> IndexPolygon_2r;
+
+//=============================================================================
+// Implementation: VertexPool
+//=============================================================================
+
+template <class Point>
+inline VertexPool<Point>::VertexPool() {}
+
+template <class Point>
+inline PointIndex VertexPool<Point>::push_back(const Point& p) {
+    vertices_.push_back(p);
+    return static_cast<PointIndex>(vertices_.size()-1);
+}
+
+template <class Point>
+inline void VertexPool<Point>::reserve(const size_t count) {
+    vertices_.reserve(count);
+}
+
+template <class Point>
+inline void VertexPool<Point>::clear() {
+    vertices_.clear();
+}
+
+// Accessors/Mutators =========================================================
+
+template <class Point>
+inline const Point& VertexPool<Point>::operator[](const PointIndex i) const {
+    assert(i < vertices_.size());
+    return vertices_[i];
+}
+
+template <class Point>
+inline const Point* VertexPool<Point>::data() const {
+    return vertices_.data();
+}
+
+template <class Point>
+inline size_t VertexPool<Point>::size() const {
+    return vertices_.size();
+}
+
+template <class Point>
+inline bool VertexPool<Point>::empty() const {
+    return vertices_.empty();
+}
+
+//=============================================================================
+// Implementation: IndexPolyline
+//=============================================================================
+
+template <class Point>
+inline IndexPolyline<Point>::IndexPolyline(const VertexPool<Point>& pool) :
+    pool_(&pool),
+    closed_(false) {}
+
+template <class Point>
+inline void IndexPolyline<Point>::Close() {
+    closed_ = true;
+}
+
+template <class Point>
+inline void IndexPolyline<Point>::Open() {
+    closed_ = false;
+}
+
+template <class Point>
+inline void IndexPolyline<Point>::push_back(const PointIndex i) {
+    assert(i < pool_->size());
+    indices_.push_back(i);
+}
+
+template <class Point>
+inline void IndexPolyline<Point>::pop_back() {
+    indices_.pop_back();
+}
+
+template <class Point>
+inline void IndexPolyline<Point>::reserve(const size_t count) {
+    indices_.reserve(count);
+}
+
+template <class Point>
+inline void IndexPolyline<Point>::clear() {
+    indices_.clear();
+}
+
+// Accessors/Mutators =========================================================
+
+template <class Point>
+inline const Point& IndexPolyline<Point>::operator[](const size_t i) const {
+    return (*pool_)[indices_[i]];
+}
+
+template <class Point>
+inline PointIndex IndexPolyline<Point>::index(const size_t i) const {
+    return indices_[i];
+}
+
+template <class Point>
+inline size_t IndexPolyline<Point>::size() const {
+    return indices_.size();
+}
+
+template <class Point>
+inline bool IndexPolyline<Point>::empty() const {
+    return indices_.empty();
+}
+
+template <class Point>
+inline const std::vector<PointIndex>& IndexPolyline<Point>::indices() const {
+    return indices_;
+}
+
+template <class Point>
+inline const VertexPool<Point>& IndexPolyline<Point>::pool() const {
+    return *pool_;
+}
+
+template <class Point>
+inline bool IndexPolyline<Point>::closed() const {
+    return closed_;
+}
+
+//=============================================================================
+// Implementation: IndexPolygon
+//=============================================================================
+
+template <class Point>
+inline IndexPolygon<Point>::IndexPolygon(const VertexPool<Point>& pool) :
+    boundary_(pool) {
+    boundary_.Close();
+}
+
+template <class Point>
+inline void IndexPolygon<Point>::push_back(const PointIndex i) {
+    boundary_.push_back(i);
+}
+
+template <class Point>
+inline void IndexPolygon<Point>::pop_back() {
+    boundary_.pop_back();
+}
+
+template <class Point>
+inline void IndexPolygon<Point>::reserve(const size_t count) {
+    boundary_.reserve(count);
+}
+
+// Accessors/Mutators =========================================================
+
+template <class Point>
+inline const Point& IndexPolygon<Point>::operator[](const size_t i) const {
+    return boundary_[i];
+}
+
+template <class Point>
+inline PointIndex IndexPolygon<Point>::index(const size_t i) const {
+    return boundary_.index(i);
+}
+
+template <class Point>
+inline size_t IndexPolygon<Point>::size() const {
+    return boundary_.size();
+}
+
+template <class Point>
+inline const IndexPolyline<Point>& IndexPolygon<Point>::boundary() const {
+    return boundary_;
+}
+
+} // namespace DDAD
+
+#endif // GE_INDEXPOLYGON_H
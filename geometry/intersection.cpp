@@ -17,6 +17,7 @@
 #include "intersection.h"
 #include "arithmetic.h"
 #include "line.h"
+#include "homogeneous.h"
 
 namespace DDAD {
 
@@ -51,15 +52,31 @@ Line_2rLine_2r::Line_2rLine_2r(const Line_2r* line_imp,
     }
 }
 
-//! \todo div by zero?
+/*!
+ * Evaluated in homogeneous coordinates: with L the implicit form of
+ * line_imp_ and p, q the points of line_par_, the intersection is L x pq and
+ * t = -(L.p)q_w / ((L.q)p_w-(L.p)q_w). Only the two results are
+ * canonicalized.
+ */
 void Line_2rLine_2r::Update() {
-    time_ = (line_imp_->d()-Dot(line_imp_->N(), line_par_->p()))/
-            (Dot(line_imp_->N(), line_par_->V()));
+    DDAD_PROFILE_SITE("Intersection::Line_2rLine_2r");
+    Line_2h imp(*line_imp_);
+    Point_2h p(line_par_->p());
+    Point_2h q(line_par_->q());
+    integer sp = Dot(imp, p);
+    integer sq = Dot(imp, q);
+    integer den = sq*p.w()-sp*q.w();
+    assert(den != 0);
+
+    rational time(-sp*q.w(), den);
+    time.canonicalize();
+    time_ = time;
+
+    Point_2r isect = ToPoint_2r(Construction::Meet(imp, Line_2h(p, q)));
     if (!intersection_) {
-        intersection_ = std::make_shared<Point_2r>(line_par_->p()+
-                                                   line_par_->V()*time_);
+        intersection_ = std::make_shared<Point_2r>(isect);
     } else {
-        *intersection_ = line_par_->p()+line_par_->V()*time_;
+        *intersection_ = isect;
     }
 }
 
@@ -148,14 +165,55 @@ SharedPoint_2r Line_2rRay_2r::intersection_sptr() {
 
 namespace Construction {
 
+/*!
+ * @brief Time at which r crosses l as the fraction num/den, without
+ * canonicalizing; see Line_2rLine_2r::Update. Returns false if r does not
+ * cross l, in which case the constructions below fall back to r's origin.
+ */
+static bool CrossingTime(const Line_2r& l, const Ray_2r& r, integer* num,
+                         integer* den) {
+    DDAD_PROFILE_SITE("Construction::CrossingTime");
+    Line_2h L(l);
+    Point_2h p(r.support().p());
+    Point_2h q(r.support().q());
+    integer sp = Dot(L, p);
+    integer sq = Dot(L, q);
+    *den = sq*p.w()-sp*q.w();
+    *num = -sp*q.w();
+    return *den != 0 && sgn(*num)*sgn(*den) >= 0;
+}
+
 Point_2r LastAfter(const Line_2r& l, const Ray_2r& r) {
-    Intersection::Line_2rRay_2r isect(&l, &r);
-    return r.origin()+r.direction()*Ceil(isect.time());
+    integer num, den, t;
+    if (!CrossingTime(l, r, &num, &den)) {
+        return r.origin();
+    }
+    mpz_cdiv_q(t.get_mpz_t(), num.get_mpz_t(), den.get_mpz_t());
+    return r.origin()+r.direction()*t;
 }
 
 Point_2r LastBefore(const Line_2r& l, const Ray_2r& r) {
-    Intersection::Line_2rRay_2r isect(&l, &r);
-    return r.origin()+r.direction()*Floor(isect.time());
+    integer num, den, t;
+    if (!CrossingTime(l, r, &num, &den)) {
+        return r.origin();
+    }
+    mpz_fdiv_q(t.get_mpz_t(), num.get_mpz_t(), den.get_mpz_t());
+    return r.origin()+r.direction()*t;
+}
+
+LazyPoint_2r LazyIntersection(const Line_2r& line_imp,
+                              const Line_2r& line_par,
+                              LazyRational* out_time) {
+    LazyRational Nx(line_imp.N().x()), Ny(line_imp.N().y());
+    LazyRational px(line_par.p().x()), py(line_par.p().y());
+    LazyRational Vx(line_par.V().x()), Vy(line_par.V().y());
+
+    LazyRational t = (LazyRational(line_imp.d())-(Nx*px+Ny*py))/
+                     (Nx*Vx+Ny*Vy);
+    if (out_time) {
+        *out_time = t;
+    }
+    return LazyPoint_2r(px+Vx*t, py+Vy*t);
 }
 
 } // namespace Construction
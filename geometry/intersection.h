@@ -28,6 +28,7 @@
 #include "pointset.h"
 #include "polytope.h"
 #include "quadedge.h"
+#include "lazy.h"
 
 namespace DDAD {
 
@@ -137,6 +138,16 @@ protected:
 namespace Construction {
 Point_2r LastBefore(const Line_2r& l, const Ray_2r& r);
 Point_2r LastAfter(const Line_2r& l, const Ray_2r& r);
+
+/*!
+ * @brief Intersection of line_imp with line_par as a lazy point, for callers
+ * that only compare or display it. Uses the same parameterization as
+ * Line_2rLine_2r; the lines must intersect in a point.
+ * \param out_time - if not null, receives the lazy parameter along line_par.
+ */
+LazyPoint_2r LazyIntersection(const Line_2r& line_imp,
+                              const Line_2r& line_par,
+                              LazyRational* out_time = nullptr);
 }
 
 namespace Predicate {
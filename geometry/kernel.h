@@ -0,0 +1,241 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Geometric kernels: a point type, its number type and the predicate
+ * set that algorithms such as Melkman are written against.
+ *
+ * A kernel is a class with typedefs Number and Point_2 and static members
+ *
+ *     Orientation OrientationPQR(const Point_2& p, const Point_2& q,
+ *                                const Point_2& r);
+ *     bool RIsLeftOrInsidePQ(const Point_2& p, const Point_2& q,
+ *                            const Point_2& r);
+ *     bool AIsLeftOfB(const Point_2& a, const Point_2& b);
+ *     bool AIsBelowB(const Point_2& a, const Point_2& b);
+ *
+ * with the meaning of the Predicate functions of the same name. Templating
+ * an algorithm on its kernel lets the caller choose, per call, between
+ * machine integers on bounded grid points, filtered doubles, and exact
+ * rationals, instead of always paying for rationals.
+ */
+
+#ifndef GE_KERNEL_H
+#define GE_KERNEL_H
+
+#include "common.h"
+#include "arithmetic.h"
+#include "point.h"
+#include "predicate.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Interface: Kernels
+//=============================================================================
+
+/*!
+ * @brief Grid points held in int64_t with coordinates below 2^InputBits in
+ * magnitude, evaluated in the narrowest machine integer that cannot
+ * overflow; see Predicate::IntegerKernel. Neither the points nor the
+ * predicates touch GMP. Exceeding the bound is undefined behaviour.
+ */
+template <int InputBits>
+struct IntegerKernel_2 {
+    static_assert(InputBits > 0 && InputBits < 64,
+                  "IntegerKernel_2: coordinates must fit in int64_t");
+
+    typedef int64_t Number;
+    typedef Point_2l Point_2;
+
+    static Orientation OrientationPQR(const Point_2& p, const Point_2& q,
+                                      const Point_2& r);
+    static bool RIsLeftOrInsidePQ(const Point_2& p, const Point_2& q,
+                                  const Point_2& r);
+    static bool AIsLeftOfB(const Point_2& a, const Point_2& b);
+    static bool AIsBelowB(const Point_2& a, const Point_2& b);
+};
+
+//! @brief Integer points of any size. Small coordinates take a machine
+//! integer path and a floating-point filter is tried before falling back
+//! to GMP integers.
+struct FilteredKernel_2 {
+    typedef integer Number;
+    typedef Point_2i Point_2;
+
+    static Orientation OrientationPQR(const Point_2& p, const Point_2& q,
+                                      const Point_2& r);
+    static bool RIsLeftOrInsidePQ(const Point_2& p, const Point_2& q,
+                                  const Point_2& r);
+    static bool AIsLeftOfB(const Point_2& a, const Point_2& b);
+    static bool AIsBelowB(const Point_2& a, const Point_2& b);
+};
+
+//! @brief Float points, filtered in double precision with an exact
+//! expansion fallback; see expansion.h.
+struct FloatKernel_2 {
+    typedef float Number;
+    typedef Point_2f Point_2;
+
+    static Orientation OrientationPQR(const Point_2& p, const Point_2& q,
+                                      const Point_2& r);
+    static bool RIsLeftOrInsidePQ(const Point_2& p, const Point_2& q,
+                                  const Point_2& r);
+    static bool AIsLeftOfB(const Point_2& a, const Point_2& b);
+    static bool AIsBelowB(const Point_2& a, const Point_2& b);
+};
+
+//! @brief Rational points, filtered and then exact in rational arithmetic.
+struct RationalKernel_2 {
+    typedef rational Number;
+    typedef Point_2r Point_2;
+
+    static Orientation OrientationPQR(const Point_2& p, const Point_2& q,
+                                      const Point_2& r);
+    static bool RIsLeftOrInsidePQ(const Point_2& p, const Point_2& q,
+                                  const Point_2& r);
+    static bool AIsLeftOfB(const Point_2& a, const Point_2& b);
+    static bool AIsBelowB(const Point_2& a, const Point_2& b);
+};
+
+//=============================================================================
+// Implementation: Kernels
+//=============================================================================
+
+/*!
+ * @brief RIsLeftOrInsidePQ from an exact orientation. A colinear r lies on
+ * the closed segment pq iff it lies in its bounding box, which needs only
+ * comparisons, so this stays exact for any number type. As with the dot
+ * product test, every r is inside a degenerate pq.
+ */
+template <class Kernel>
+bool RIsLeftOrInsidePQByOrientation(const typename Kernel::Point_2& p,
+                                    const typename Kernel::Point_2& q,
+                                    const typename Kernel::Point_2& r) {
+    Orientation orientation = Kernel::OrientationPQR(p, q, r);
+    if (orientation != ORIENTATION_COLINEAR) {
+        return orientation == ORIENTATION_LEFT;
+    }
+    if (p == q) {
+        return true;
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        if (p[i] <= q[i] ? (r[i] < p[i] || q[i] < r[i])
+                         : (r[i] < q[i] || p[i] < r[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int InputBits>
+inline Orientation IntegerKernel_2<InputBits>::OrientationPQR(
+        const Point_2& p, const Point_2& q, const Point_2& r) {
+    typedef typename Predicate::PredicateInteger<
+        Predicate::PREDICATE_ORIENTATION_PQR, InputBits>::type Integer;
+
+    Integer det = (Integer(q.x())-p.x())*(Integer(r.y())-p.y())-
+                  (Integer(q.y())-p.y())*(Integer(r.x())-p.x());
+
+    if (det > 0) {
+        return ORIENTATION_LEFT;
+    } else if (det < 0) {
+        return ORIENTATION_RIGHT;
+    } else {
+        return ORIENTATION_COLINEAR;
+    }
+}
+
+template <int InputBits>
+inline bool IntegerKernel_2<InputBits>::RIsLeftOrInsidePQ(
+        const Point_2& p, const Point_2& q, const Point_2& r) {
+    return RIsLeftOrInsidePQByOrientation<IntegerKernel_2>(p, q, r);
+}
+
+template <int InputBits>
+inline bool IntegerKernel_2<InputBits>::AIsLeftOfB(
+        const Point_2& a, const Point_2& b) {
+    return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+}
+
+template <int InputBits>
+inline bool IntegerKernel_2<InputBits>::AIsBelowB(
+        const Point_2& a, const Point_2& b) {
+    return a.y() < b.y() || (a.y() == b.y() && a.x() < b.x());
+}
+
+inline Orientation FilteredKernel_2::OrientationPQR(
+        const Point_2& p, const Point_2& q, const Point_2& r) {
+    return Predicate::OrientationPQR(p, q, r);
+}
+
+inline bool FilteredKernel_2::RIsLeftOrInsidePQ(
+        const Point_2& p, const Point_2& q, const Point_2& r) {
+    return RIsLeftOrInsidePQByOrientation<FilteredKernel_2>(p, q, r);
+}
+
+inline bool FilteredKernel_2::AIsLeftOfB(
+        const Point_2& a, const Point_2& b) {
+    return Predicate::AIsLeftOfB(a, b);
+}
+
+inline bool FilteredKernel_2::AIsBelowB(
+        const Point_2& a, const Point_2& b) {
+    return Predicate::AIsBelowB(a, b);
+}
+
+inline Orientation FloatKernel_2::OrientationPQR(
+        const Point_2& p, const Point_2& q, const Point_2& r) {
+    return Predicate::OrientationPQR(p, q, r);
+}
+
+inline bool FloatKernel_2::RIsLeftOrInsidePQ(
+        const Point_2& p, const Point_2& q, const Point_2& r) {
+    return RIsLeftOrInsidePQByOrientation<FloatKernel_2>(p, q, r);
+}
+
+inline bool FloatKernel_2::AIsLeftOfB(
+        const Point_2& a, const Point_2& b) {
+    return Predicate::AIsLeftOfB(a, b);
+}
+
+inline bool FloatKernel_2::AIsBelowB(
+        const Point_2& a, const Point_2& b) {
+    return Predicate::AIsBelowB(a, b);
+}
+
+inline Orientation RationalKernel_2::OrientationPQR(
+        const Point_2& p, const Point_2& q, const Point_2& r) {
+    return Predicate::OrientationPQR(p, q, r);
+}
+
+inline bool RationalKernel_2::RIsLeftOrInsidePQ(
+        const Point_2& p, const Point_2& q, const Point_2& r) {
+    return Predicate::RIsLeftOrInsidePQ(p, q, r);
+}
+
+inline bool RationalKernel_2::AIsLeftOfB(
+        const Point_2& a, const Point_2& b) {
+    return Predicate::AIsLeftOfB(a, b);
+}
+
+inline bool RationalKernel_2::AIsBelowB(
+        const Point_2& a, const Point_2& b) {
+    return Predicate::AIsBelowB(a, b);
+}
+
+} // namespace DDAD
+
+#endif // GE_KERNEL_H
@@ -0,0 +1,444 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "lattice.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Implementation: Row operations
+//=============================================================================
+
+//! @brief Row-major copy of the column-major rows x cols matrix in entries.
+static std::vector<integer> ToRows(const integer* entries, const int rows,
+                                   const int cols) {
+    std::vector<integer> a(rows*cols);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            a[i*cols+j] = entries[j*rows+i];
+        }
+    }
+    return a;
+}
+
+//! @brief Writes the row-major matrix a to out in column-major order.
+static void FromRows(const std::vector<integer>& a, const int rows,
+                     const int cols, integer* out) {
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            out[j*rows+i] = a[i*cols+j];
+        }
+    }
+}
+
+static std::vector<integer> Identity(const int n) {
+    std::vector<integer> a(n*n, integer(0));
+    for (int i = 0; i < n; ++i) {
+        a[i*n+i] = 1;
+    }
+    return a;
+}
+
+/*!
+ * @brief Replaces rows i and k of the row-major matrix a by p*row i + q*row
+ * k and r*row i + s*row k. Unimodular when p*s-q*r = +-1.
+ */
+static void CombineRows(std::vector<integer>& a, const int cols, const int i,
+                        const int k, const integer& p, const integer& q,
+                        const integer& r, const integer& s) {
+    integer x, y;
+    for (int j = 0; j < cols; ++j) {
+        x = p*a[i*cols+j]+q*a[k*cols+j];
+        y = r*a[i*cols+j]+s*a[k*cols+j];
+        a[i*cols+j] = std::move(x);
+        a[k*cols+j] = std::move(y);
+    }
+}
+
+//! @brief Row i of the row-major matrix a less q times row k.
+static void SubtractRow(std::vector<integer>& a, const int cols, const int i,
+                        const int k, const integer& q) {
+    for (int j = 0; j < cols; ++j) {
+        mpz_submul(a[i*cols+j].get_mpz_t(), q.get_mpz_t(),
+                   a[k*cols+j].get_mpz_t());
+    }
+}
+
+static void NegateRow(std::vector<integer>& a, const int cols, const int i) {
+    for (int j = 0; j < cols; ++j) {
+        a[i*cols+j] = -a[i*cols+j];
+    }
+}
+
+static void SwapRows(std::vector<integer>& a, const int cols, const int i,
+                     const int k) {
+    for (int j = 0; j < cols; ++j) {
+        std::swap(a[i*cols+j], a[k*cols+j]);
+    }
+}
+
+//=============================================================================
+// Implementation: Lattice
+//=============================================================================
+
+integer ExtendedGCD(const integer& a, const integer& b, integer& s,
+                    integer& t) {
+    integer g;
+    mpz_gcdext(g.get_mpz_t(), s.get_mpz_t(), t.get_mpz_t(), a.get_mpz_t(),
+               b.get_mpz_t());
+    return g;
+}
+
+/*!
+ * Folds the coordinates of v into the first one with extended gcds. With
+ * g = s*a + t*b, the column operation [s -b/g; t a/g] takes (a, b) to
+ * (g, 0); the inverse row operation [a/g b/g; -t s] is applied to the
+ * basis, so that g times its first row stays equal to the coordinates of v
+ * folded so far.
+ */
+bool UnimodularCompletion(const integer* v, const int n, integer* basis) {
+    std::vector<integer> b = Identity(n);
+    integer g(v[0]), s, t, p, q;
+    for (int j = 1; j < n; ++j) {
+        if (sgn(v[j]) == 0) {
+            continue;
+        }
+        integer h = ExtendedGCD(g, v[j], s, t);
+        mpz_divexact(p.get_mpz_t(), g.get_mpz_t(), h.get_mpz_t());
+        mpz_divexact(q.get_mpz_t(), v[j].get_mpz_t(), h.get_mpz_t());
+        CombineRows(b, n, 0, j, p, q, -t, s);
+        g = std::move(h);
+    }
+    if (sgn(g) == 0) {
+        return false;
+    }
+    if (sgn(g) < 0) {
+        // only when v is a negative multiple of the first unit vector
+        NegateRow(b, n, 0);
+        if (n > 1) {
+            NegateRow(b, n, n-1);
+        }
+    }
+    FromRows(b, n, n, basis);
+    return true;
+}
+
+void HermiteNormalForm(const integer* entries, const int rows,
+                       const int cols, integer* hnf, integer* transform) {
+    DDAD_PROFILE_SITE("Lattice::HermiteNormalForm");
+    std::vector<integer> a = ToRows(entries, rows, cols);
+    std::vector<integer> u;
+    if (transform) {
+        u = Identity(rows);
+    }
+
+    integer s, t, p, q;
+    int r = 0;
+    for (int c = 0; c < cols && r < rows; ++c) {
+        // fold column c of the rows below into the pivot row
+        for (int i = r+1; i < rows; ++i) {
+            const integer& x = a[r*cols+c];
+            const integer& y = a[i*cols+c];
+            if (sgn(y) == 0) {
+                continue;
+            }
+            integer g = ExtendedGCD(x, y, s, t);
+            mpz_divexact(p.get_mpz_t(), x.get_mpz_t(), g.get_mpz_t());
+            mpz_divexact(q.get_mpz_t(), y.get_mpz_t(), g.get_mpz_t());
+            q = -q;
+            CombineRows(a, cols, r, i, s, t, q, p);
+            if (transform) {
+                CombineRows(u, rows, r, i, s, t, q, p);
+            }
+        }
+        const int pivot = sgn(a[r*cols+c]);
+        if (pivot == 0) {
+            continue;
+        }
+        if (pivot < 0) {
+            NegateRow(a, cols, r);
+            if (transform) {
+                NegateRow(u, rows, r);
+            }
+        }
+
+        // reduce the entries above the pivot into [0, pivot)
+        for (int i = 0; i < r; ++i) {
+            mpz_fdiv_q(q.get_mpz_t(), a[i*cols+c].get_mpz_t(),
+                       a[r*cols+c].get_mpz_t());
+            if (sgn(q) != 0) {
+                SubtractRow(a, cols, i, r, q);
+                if (transform) {
+                    SubtractRow(u, rows, i, r, q);
+                }
+            }
+        }
+        ++r;
+    }
+
+    FromRows(a, rows, cols, hnf);
+    if (transform) {
+        FromRows(u, rows, rows, transform);
+    }
+}
+
+/*!
+ * Cohen's integral LLL. With b* the Gram-Schmidt vectors, d[i] is the Gram
+ * determinant |b*_1|^2...|b*_i|^2 and lambda(k,j) = d[j]*mu(k,j), both
+ * integers, so no fractions arise. Indices are 1-based as in the reference.
+ */
+bool LLLReduce(const integer* entries, const int rows, const int cols,
+               integer* reduced, integer* transform) {
+    DDAD_PROFILE_SITE("Lattice::LLLReduce");
+    const int n = rows;
+    std::vector<integer> b = ToRows(entries, rows, cols);
+    std::vector<integer> h;
+    if (transform) {
+        h = Identity(n);
+    }
+    if (n == 0) {
+        return true;
+    }
+
+    std::vector<integer> d(n+1);
+    std::vector<integer> lambda((n+1)*(n+1), integer(0));
+    auto row = [](const int i) { return i-1; };
+    auto l = [&](const int i, const int j) -> integer& {
+        return lambda[i*(n+1)+j];
+    };
+    auto dot = [&](const int i, const int j) {
+        integer sum(0);
+        for (int c = 0; c < cols; ++c) {
+            mpz_addmul(sum.get_mpz_t(), b[row(i)*cols+c].get_mpz_t(),
+                       b[row(j)*cols+c].get_mpz_t());
+        }
+        return sum;
+    };
+
+    integer q, twice;
+    // size-reduces b_k against b_m
+    auto reduce = [&](const int k, const int m) {
+        mpz_mul_2exp(twice.get_mpz_t(), l(k,m).get_mpz_t(), 1);
+        if (mpz_cmpabs(twice.get_mpz_t(), d[m].get_mpz_t()) <= 0) {
+            return;
+        }
+        // q = round(lambda(k,m)/d[m]) = floor((2*lambda+d)/(2*d))
+        twice += d[m];
+        mpz_fdiv_q(q.get_mpz_t(), twice.get_mpz_t(), d[m].get_mpz_t());
+        mpz_fdiv_q_2exp(q.get_mpz_t(), q.get_mpz_t(), 1);
+        SubtractRow(b, cols, row(k), row(m), q);
+        if (transform) {
+            SubtractRow(h, n, row(k), row(m), q);
+        }
+        mpz_submul(l(k,m).get_mpz_t(), q.get_mpz_t(), d[m].get_mpz_t());
+        for (int i = 1; i < m; ++i) {
+            mpz_submul(l(k,i).get_mpz_t(), q.get_mpz_t(),
+                       l(m,i).get_mpz_t());
+        }
+    };
+
+    d[0] = 1;
+    d[1] = dot(1, 1);
+    if (sgn(d[1]) == 0) {
+        return false;
+    }
+    int k = 2;
+    int kmax = 1;
+    integer u, bb, tmp;
+    while (k <= n) {
+        if (k > kmax) {
+            // incremental Gram-Schmidt
+            kmax = k;
+            for (int j = 1; j <= k; ++j) {
+                u = dot(k, j);
+                for (int i = 1; i < j; ++i) {
+                    u *= d[i];
+                    mpz_submul(u.get_mpz_t(), l(k,i).get_mpz_t(),
+                               l(j,i).get_mpz_t());
+                    mpz_divexact(u.get_mpz_t(), u.get_mpz_t(),
+                                 d[i-1].get_mpz_t());
+                }
+                if (j < k) {
+                    l(k,j) = u;
+                } else if (sgn(u) == 0) {
+                    return false;
+                } else {
+                    d[k] = u;
+                }
+            }
+        }
+
+        // Lovasz condition 4*d[k]*d[k-2] >= 3*d[k-1]^2 - 4*lambda(k,k-1)^2
+        reduce(k, k-1);
+        tmp = 4*d[k]*d[k-2]+4*l(k,k-1)*l(k,k-1);
+        if (tmp < 3*d[k-1]*d[k-1]) {
+            SwapRows(b, cols, row(k), row(k-1));
+            if (transform) {
+                SwapRows(h, n, row(k), row(k-1));
+            }
+            for (int j = 1; j <= k-2; ++j) {
+                std::swap(l(k,j), l(k-1,j));
+            }
+            const integer lam = l(k,k-1);
+            bb = d[k-2]*d[k]+lam*lam;
+            mpz_divexact(bb.get_mpz_t(), bb.get_mpz_t(), d[k-1].get_mpz_t());
+            for (int i = k+1; i <= kmax; ++i) {
+                integer t = l(i,k);
+                u = d[k]*l(i,k-1)-lam*t;
+                mpz_divexact(l(i,k).get_mpz_t(), u.get_mpz_t(),
+                             d[k-1].get_mpz_t());
+                u = bb*t+lam*l(i,k);
+                mpz_divexact(l(i,k-1).get_mpz_t(), u.get_mpz_t(),
+                             d[k].get_mpz_t());
+            }
+            d[k-1] = bb;
+            k = std::max(2, k-1);
+        } else {
+            for (int m = k-2; m >= 1; --m) {
+                reduce(k, m);
+            }
+            ++k;
+        }
+    }
+
+    FromRows(b, rows, cols, reduced);
+    if (transform) {
+        FromRows(h, n, n, transform);
+    }
+    return true;
+}
+
+Matrix_NxNi UnimodularCompletion(const std::vector<integer>& v) {
+    Matrix_NxNi basis(v.size());
+    bool nonzero = UnimodularCompletion(v.data(), v.size(), &basis(0,0));
+    assert(nonzero);
+    (void)nonzero;
+    return basis;
+}
+
+Matrix_NxNi HermiteNormalForm(const Matrix_NxNi& mat) {
+    Matrix_NxNi hnf(mat.size());
+    HermiteNormalForm(mat.elements().data(), mat.size(), mat.size(),
+                      &hnf(0,0), nullptr);
+    return hnf;
+}
+
+Matrix_NxNi LLLReduce(const Matrix_NxNi& mat) {
+    Matrix_NxNi reduced(mat.size());
+    bool independent = LLLReduce(mat.elements().data(), mat.size(),
+                                 mat.size(), &reduced(0,0), nullptr);
+    assert(independent);
+    (void)independent;
+    return reduced;
+}
+
+/*!
+ * Completes u to a basis B, rewrites v as v*Inverse(B), whose last two
+ * coordinates are not both zero since u and v are independent, and
+ * completes those to a 2x2 basis acting on the last two rows of B.
+ */
+Matrix_3x3i UnimodularBasisForPlane(const Vector_3i& u, const Vector_3i& v) {
+    Matrix_3x3i basisU = UnimodularCompletion(u);
+    Vector_3i vPrime = v*Inverse(basisU);
+    assert(sgn(vPrime.y()) != 0 || sgn(vPrime.z()) != 0);
+    Matrix_2x2i basisV = UnimodularCompletion(Vector_2i(vPrime.y(),
+                                                        vPrime.z()));
+    return Matrix_3x3i(1, 0, 0,
+                       0, basisV(0,0), basisV(0,1),
+                       0, basisV(1,0), basisV(1,1))*basisU;
+}
+
+//=============================================================================
+// Implementation: UnimodularTransform_3i
+//=============================================================================
+
+/*!
+ * @brief p*mat for an integer matrix, as (n*mat)/D with D the lcm of the
+ * denominators of p and n its coordinates scaled by D.
+ */
+static Point_3r Multiply(const rational& x, const rational& y,
+                         const rational& z, const Matrix_3x3i& mat) {
+    std::array<const rational*, 3> p = {{&x, &y, &z}};
+    integer D(1), den;
+    for (auto c : p) {
+        den = c->get_den();
+        mpz_lcm(D.get_mpz_t(), D.get_mpz_t(), den.get_mpz_t());
+    }
+    std::array<integer, 3> n;
+    for (int i = 0; i < 3; ++i) {
+        den = p[i]->get_den();
+        mpz_divexact(n[i].get_mpz_t(), D.get_mpz_t(), den.get_mpz_t());
+        n[i] *= p[i]->get_num();
+    }
+    std::array<rational, 3> elements;
+    integer sum;
+    for (int col = 0; col < 3; ++col) {
+        sum = n[0]*mat(0,col);
+        mpz_addmul(sum.get_mpz_t(), n[1].get_mpz_t(),
+                   mat(1,col).get_mpz_t());
+        mpz_addmul(sum.get_mpz_t(), n[2].get_mpz_t(),
+                   mat(2,col).get_mpz_t());
+        elements[col] = rational(sum, D);
+        elements[col].canonicalize();
+    }
+    return Point_3r(std::move(elements));
+}
+
+static PointBuffer_3r Multiply(const PointBufferView_3r& points,
+                               const Matrix_3x3i& mat) {
+    DDAD_PROFILE_SITE("Construction::UnimodularTransform_3i");
+    PointBuffer_3r result;
+    result.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        result.push_back(Multiply(points.x(i), points.y(i), points.z(i),
+                                  mat));
+    }
+    return result;
+}
+
+//! @brief The identity.
+UnimodularTransform_3i::UnimodularTransform_3i() {}
+
+UnimodularTransform_3i::UnimodularTransform_3i(const Matrix_3x3i& basis) :
+    basis_(basis),
+    inverse_(Inverse(basis)) {}
+
+Point_3r UnimodularTransform_3i::ToBasis(const Point_3r& p) const {
+    return Multiply(p.x(), p.y(), p.z(), inverse_);
+}
+
+PointBuffer_3r UnimodularTransform_3i::ToBasis(
+        const PointBufferView_3r& points) const {
+    return Multiply(points, inverse_);
+}
+
+Point_3r UnimodularTransform_3i::FromBasis(const Point_3r& p) const {
+    return Multiply(p.x(), p.y(), p.z(), basis_);
+}
+
+PointBuffer_3r UnimodularTransform_3i::FromBasis(
+        const PointBufferView_3r& points) const {
+    return Multiply(points, basis_);
+}
+
+UnimodularTransform_3i UnimodularTransform_3i::Inverted() const {
+    UnimodularTransform_3i inverted;
+    inverted.basis_ = inverse_;
+    inverted.inverse_ = basis_;
+    return inverted;
+}
+
+} // namespace DDAD
@@ -0,0 +1,215 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Integer lattices: unimodular completion, Hermite normal form, and
+ * LLL reduction.
+ *
+ * A lattice basis is given by the rows of a matrix, as elsewhere in the
+ * geometry module: a vector v has coordinates v*Inverse(B) in the basis B.
+ * Every routine here runs a fixed number of extended gcd or exact integer
+ * steps for its input size, rather than searching, so there is no input on
+ * which it fails to terminate or has to give up.
+ *
+ * The pointer overloads take matrices in column-major order, as stored by
+ * Mat, and write their results in the same order.
+ */
+
+#ifndef GE_LATTICE_H
+#define GE_LATTICE_H
+
+#include "common.h"
+#include "arithmetic.h"
+#include "vector.h"
+#include "matrix.h"
+#include "pointbuffer.h"
+
+namespace DDAD {
+
+//! @brief g = gcd(a, b) = s*a + t*b with g >= 0, by mpz_gcdext.
+integer ExtendedGCD(const integer& a, const integer& b, integer& s,
+                    integer& t);
+
+/*!
+ * @brief Writes to basis an n x n matrix of determinant 1 whose first row is
+ * v divided by the gcd of its coordinates. Built from one extended gcd per
+ * nonzero coordinate, so the other rows are no larger than v. Returns false
+ * for the zero vector.
+ */
+bool UnimodularCompletion(const integer* v, const int n, integer* basis);
+
+/*!
+ * @brief Row-style Hermite normal form H = U*mat of the rows x cols matrix
+ * mat, with U unimodular. H is in echelon form, each pivot is positive and
+ * the entries above a pivot are reduced into [0, pivot). Writes U to
+ * transform if it is not null. Uses at most rows*cols extended gcds.
+ */
+void HermiteNormalForm(const integer* entries, const int rows,
+                       const int cols, integer* hnf, integer* transform);
+
+/*!
+ * @brief LLL reduction of the rows of mat with delta = 3/4, in exact integer
+ * arithmetic (Cohen, Algorithm 2.6.7). Writes the reduced basis U*mat to
+ * reduced and U to transform if it is not null. Returns false, leaving the
+ * outputs unspecified, if the rows are linearly dependent.
+ */
+bool LLLReduce(const integer* entries, const int rows, const int cols,
+               integer* reduced, integer* transform);
+
+template <size_t N>
+Mat<integer, N, N> UnimodularCompletion(const Vec<integer, N>& v);
+template <size_t R, size_t C>
+Mat<integer, R, C> HermiteNormalForm(const Mat<integer, R, C>& mat);
+template <size_t R, size_t C>
+Mat<integer, R, C> HermiteNormalForm(const Mat<integer, R, C>& mat,
+                                     Mat<integer, R, R>& transform);
+//! @brief The rows of mat must be linearly independent.
+template <size_t R, size_t C>
+Mat<integer, R, C> LLLReduce(const Mat<integer, R, C>& mat);
+template <size_t R, size_t C>
+Mat<integer, R, C> LLLReduce(const Mat<integer, R, C>& mat,
+                             Mat<integer, R, R>& transform);
+
+Matrix_NxNi UnimodularCompletion(const std::vector<integer>& v);
+Matrix_NxNi HermiteNormalForm(const Matrix_NxNi& mat);
+Matrix_NxNi LLLReduce(const Matrix_NxNi& mat);
+
+/*!
+ * @brief Unimodular basis whose first row is u divided by its gcd and whose
+ * first two rows span the integer points of the plane spanned by u and v,
+ * which must be linearly independent. Rewritten in this basis, the plane
+ * is parallel to the xy coordinate plane.
+ */
+Matrix_3x3i UnimodularBasisForPlane(const Vector_3i& u, const Vector_3i& v);
+
+//=============================================================================
+// Interface: UnimodularTransform_3i
+//=============================================================================
+
+/*!
+ * @brief Change of basis to the rows of a unimodular matrix B, keeping both
+ * B and its inverse so that neither is recomputed per point. ToBasis(p) is
+ * p*Inverse(B) and FromBasis(p) is p*B. Rational points are multiplied as
+ * integer numerators over a common denominator, so each coordinate costs
+ * three integer products and one canonicalization rather than three
+ * rational products and sums.
+ */
+class UnimodularTransform_3i {
+public:
+    UnimodularTransform_3i();
+    explicit UnimodularTransform_3i(const Matrix_3x3i& basis);
+
+    Point_3i ToBasis(const Point_3i& p) const;
+    Point_3r ToBasis(const Point_3r& p) const;
+    Vector_3i ToBasis(const Vector_3i& v) const;
+    PointBuffer_3r ToBasis(const PointBufferView_3r& points) const;
+    Point_3i FromBasis(const Point_3i& p) const;
+    Point_3r FromBasis(const Point_3r& p) const;
+    Vector_3i FromBasis(const Vector_3i& v) const;
+    PointBuffer_3r FromBasis(const PointBufferView_3r& points) const;
+
+    //! @brief The transform back from the basis, swapping B and its inverse.
+    UnimodularTransform_3i Inverted() const;
+
+    const Matrix_3x3i& basis() const;
+    const Matrix_3x3i& inverse() const;
+
+private:
+    Matrix_3x3i basis_;
+    Matrix_3x3i inverse_;
+};
+
+//=============================================================================
+// Implementation: Lattice
+//=============================================================================
+
+template <size_t N>
+inline Mat<integer, N, N> UnimodularCompletion(const Vec<integer, N>& v) {
+    Mat<integer, N, N> basis;
+    bool nonzero = UnimodularCompletion(v.elements().data(), N, &basis(0,0));
+    assert(nonzero);
+    (void)nonzero;
+    return basis;
+}
+
+template <size_t R, size_t C>
+inline Mat<integer, R, C> HermiteNormalForm(const Mat<integer, R, C>& mat) {
+    Mat<integer, R, C> hnf;
+    HermiteNormalForm(mat.elements().data(), R, C, &hnf(0,0), nullptr);
+    return hnf;
+}
+
+template <size_t R, size_t C>
+inline Mat<integer, R, C> HermiteNormalForm(const Mat<integer, R, C>& mat,
+                                            Mat<integer, R, R>& transform) {
+    Mat<integer, R, C> hnf;
+    HermiteNormalForm(mat.elements().data(), R, C, &hnf(0,0),
+                      &transform(0,0));
+    return hnf;
+}
+
+template <size_t R, size_t C>
+inline Mat<integer, R, C> LLLReduce(const Mat<integer, R, C>& mat) {
+    Mat<integer, R, C> reduced;
+    bool independent = LLLReduce(mat.elements().data(), R, C, &reduced(0,0),
+                                 nullptr);
+    assert(independent);
+    (void)independent;
+    return reduced;
+}
+
+template <size_t R, size_t C>
+inline Mat<integer, R, C> LLLReduce(const Mat<integer, R, C>& mat,
+                                    Mat<integer, R, R>& transform) {
+    Mat<integer, R, C> reduced;
+    bool independent = LLLReduce(mat.elements().data(), R, C, &reduced(0,0),
+                                 &transform(0,0));
+    assert(independent);
+    (void)independent;
+    return reduced;
+}
+
+//=============================================================================
+// Implementation: UnimodularTransform_3i
+//=============================================================================
+
+inline Point_3i UnimodularTransform_3i::ToBasis(const Point_3i& p) const {
+    return p*inverse_;
+}
+
+inline Vector_3i UnimodularTransform_3i::ToBasis(const Vector_3i& v) const {
+    return v*inverse_;
+}
+
+inline Point_3i UnimodularTransform_3i::FromBasis(const Point_3i& p) const {
+    return p*basis_;
+}
+
+inline Vector_3i UnimodularTransform_3i::FromBasis(const Vector_3i& v) const {
+    return v*basis_;
+}
+
+// Accessors/Mutators =========================================================
+
+inline const Matrix_3x3i& UnimodularTransform_3i::basis() const {
+    return basis_;
+}
+inline const Matrix_3x3i& UnimodularTransform_3i::inverse() const {
+    return inverse_;
+}
+
+} // namespace DDAD
+
+#endif // GE_LATTICE_H
@@ -0,0 +1,305 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "lazy.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Implementation: Interval
+//=============================================================================
+
+static const double kInfinity = std::numeric_limits<double>::infinity();
+
+//! @brief Widens [lo, hi] by one ulp on each side; NaN becomes everything.
+static Interval Outward(const double lo, const double hi) {
+    if (lo != lo || hi != hi) {
+        return Interval(-kInfinity, kInfinity);
+    }
+    return Interval(std::nextafter(lo, -kInfinity),
+                    std::nextafter(hi, kInfinity));
+}
+
+//! @brief d moved by the given number of ulps toward -infinity or
+//! +infinity.
+static double StepAway(double d, const double to, int ulps) {
+    while (ulps-- > 0) {
+        d = std::nextafter(d, to);
+    }
+    return d;
+}
+
+/*!
+ * Integers that fit in the mantissa convert exactly. If the numerator and
+ * denominator both fit, get_d is one rounding from the value, either the
+ * truncation of mpq_get_d or the division of a SmallRational, so one ulp
+ * contains it. Otherwise a SmallRational rounds its numerator, denominator
+ * and quotient, which can be off by up to about 3u|d| for the unit
+ * roundoff u; as an ulp just below a power of two is only u|d|, it takes
+ * four ulps to contain that on both sides.
+ */
+Interval::Interval(const rational& q) {
+    double d = q.get_d();
+    integer num = q.get_num();
+    integer den = q.get_den();
+    bool fits = mpz_sizeinbase(num.get_mpz_t(), 2) <= 53 &&
+                mpz_sizeinbase(den.get_mpz_t(), 2) <= 53;
+    if (fits && den == 1) {
+        lo_ = hi_ = d;
+    } else {
+        int ulps = fits ? 1 : 4;
+        lo_ = StepAway(d, -kInfinity, ulps);
+        hi_ = StepAway(d, kInfinity, ulps);
+    }
+}
+
+Interval operator+(const Interval& lhs, const Interval& rhs) {
+    return Outward(lhs.lo()+rhs.lo(), lhs.hi()+rhs.hi());
+}
+
+Interval operator-(const Interval& lhs, const Interval& rhs) {
+    return Outward(lhs.lo()-rhs.hi(), lhs.hi()-rhs.lo());
+}
+
+Interval operator*(const Interval& lhs, const Interval& rhs) {
+    double a = lhs.lo()*rhs.lo();
+    double b = lhs.lo()*rhs.hi();
+    double c = lhs.hi()*rhs.lo();
+    double d = lhs.hi()*rhs.hi();
+    if (a != a || b != b || c != c || d != d) {
+        return Interval(-kInfinity, kInfinity);
+    }
+    return Outward(std::min(std::min(a, b), std::min(c, d)),
+                   std::max(std::max(a, b), std::max(c, d)));
+}
+
+Interval operator/(const Interval& lhs, const Interval& rhs) {
+    if (rhs.contains_zero()) {
+        return Interval(-kInfinity, kInfinity);
+    }
+    double a = lhs.lo()/rhs.lo();
+    double b = lhs.lo()/rhs.hi();
+    double c = lhs.hi()/rhs.lo();
+    double d = lhs.hi()/rhs.hi();
+    if (a != a || b != b || c != c || d != d) {
+        return Interval(-kInfinity, kInfinity);
+    }
+    return Outward(std::min(std::min(a, b), std::min(c, d)),
+                   std::max(std::max(a, b), std::max(c, d)));
+}
+
+Interval operator-(const Interval& i) {
+    return Interval(-i.hi(), -i.lo());
+}
+
+//=============================================================================
+// Implementation: LazyRational
+//=============================================================================
+
+LazyRational::LazyRational() {
+    // all default-constructed values share one exact zero
+    static const std::shared_ptr<Node> zero = LazyRational(rational(0)).node_;
+    node_ = zero;
+}
+
+LazyRational::LazyRational(const int n) {
+    *this = LazyRational(rational(n));
+}
+
+LazyRational::LazyRational(const rational& q) :
+    node_(std::make_shared<Node>()) {
+    node_->op = OP_CONSTANT;
+    node_->approx = Interval(q);
+    node_->exact.reset(new rational(q));
+}
+
+LazyRational::LazyRational(const Op op, const Interval& approx,
+                           const std::shared_ptr<Node>& lhs,
+                           const std::shared_ptr<Node>& rhs) :
+    node_(std::make_shared<Node>()) {
+    node_->op = op;
+    node_->approx = approx;
+    node_->lhs = lhs;
+    node_->rhs = rhs;
+}
+
+/*!
+ * Evaluates node exactly, caching the result and dropping the references
+ * to its operands so that fully evaluated subtrees can be freed.
+ */
+const rational& LazyRational::Evaluate(Node& node) {
+    if (node.exact) {
+        return *node.exact;
+    }
+
+    rational value;
+    switch (node.op) {
+    case OP_ADD:
+        value = Evaluate(*node.lhs)+Evaluate(*node.rhs);
+        break;
+    case OP_SUB:
+        value = Evaluate(*node.lhs)-Evaluate(*node.rhs);
+        break;
+    case OP_MUL:
+        value = Evaluate(*node.lhs)*Evaluate(*node.rhs);
+        break;
+    case OP_DIV:
+        assert(sgn(Evaluate(*node.rhs)) != 0);
+        value = Evaluate(*node.lhs)/Evaluate(*node.rhs);
+        break;
+    case OP_NEG:
+        value = -Evaluate(*node.lhs);
+        break;
+    default:
+        assert(false);
+        break;
+    }
+
+    node.exact.reset(new rational(value));
+    node.lhs.reset();
+    node.rhs.reset();
+    return *node.exact;
+}
+
+int LazyRational::sign() const {
+    const Interval& i = node_->approx;
+    if (i.lo() > 0.0) {
+        return 1;
+    } else if (i.hi() < 0.0) {
+        return -1;
+    } else if (i.is_point()) {
+        return 0;
+    }
+    return sgn(exact());
+}
+
+LazyRational operator+(const LazyRational& lhs, const LazyRational& rhs) {
+    return LazyRational(LazyRational::OP_ADD,
+                        lhs.interval()+rhs.interval(), lhs.node_, rhs.node_);
+}
+
+LazyRational operator-(const LazyRational& lhs, const LazyRational& rhs) {
+    return LazyRational(LazyRational::OP_SUB,
+                        lhs.interval()-rhs.interval(), lhs.node_, rhs.node_);
+}
+
+LazyRational operator*(const LazyRational& lhs, const LazyRational& rhs) {
+    return LazyRational(LazyRational::OP_MUL,
+                        lhs.interval()*rhs.interval(), lhs.node_, rhs.node_);
+}
+
+LazyRational operator/(const LazyRational& lhs, const LazyRational& rhs) {
+    return LazyRational(LazyRational::OP_DIV,
+                        lhs.interval()/rhs.interval(), lhs.node_, rhs.node_);
+}
+
+LazyRational operator-(const LazyRational& q) {
+    return LazyRational(LazyRational::OP_NEG, -q.interval(), q.node_,
+                        nullptr);
+}
+
+int Compare(const LazyRational& lhs, const LazyRational& rhs) {
+    const Interval& l = lhs.interval();
+    const Interval& r = rhs.interval();
+    if (l.hi() < r.lo()) {
+        return -1;
+    } else if (l.lo() > r.hi()) {
+        return 1;
+    } else if (l.is_point() && r.is_point()) {
+        return 0;
+    }
+    const rational& a = lhs.exact();
+    const rational& b = rhs.exact();
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+//=============================================================================
+// Implementation: LazyPoint_2r, LazyPoint_3r
+//=============================================================================
+
+Point_2r ToPoint_2r(const LazyPoint_2r& p) {
+    return Point_2r(p.x().exact(), p.y().exact());
+}
+
+Point_2f ToPoint_2f(const LazyPoint_2r& p) {
+    return Point_2f(static_cast<float>(p.x().get_d()),
+                    static_cast<float>(p.y().get_d()));
+}
+
+Point_3r ToPoint_3r(const LazyPoint_3r& p) {
+    return Point_3r(p.x().exact(), p.y().exact(), p.z().exact());
+}
+
+Point_3f ToPoint_3f(const LazyPoint_3r& p) {
+    return Point_3f(static_cast<float>(p.x().get_d()),
+                    static_cast<float>(p.y().get_d()),
+                    static_cast<float>(p.z().get_d()));
+}
+
+//=============================================================================
+// Implementation: LazyMatrix_3x3r
+//=============================================================================
+
+LazyMatrix_3x3r LazyInverse(const Matrix_3x3r& mat) {
+    LazyMatrix_3x3r A;
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t col = 0; col < 3; ++col) {
+            A(row,col) = LazyRational(mat(row,col));
+        }
+    }
+
+    LazyMatrix_3x3r adj(
+         A(1,1)*A(2,2)-A(1,2)*A(2,1),
+        -(A(0,1)*A(2,2)-A(0,2)*A(2,1)),
+         A(0,1)*A(1,2)-A(0,2)*A(1,1),
+        -(A(1,0)*A(2,2)-A(1,2)*A(2,0)),
+         A(0,0)*A(2,2)-A(0,2)*A(2,0),
+        -(A(0,0)*A(1,2)-A(0,2)*A(1,0)),
+         A(1,0)*A(2,1)-A(1,1)*A(2,0),
+        -(A(0,0)*A(2,1)-A(0,1)*A(2,0)),
+         A(0,0)*A(1,1)-A(0,1)*A(1,0)
+    );
+    LazyRational det = A(0,0)*adj(0,0)+A(0,1)*adj(1,0)+A(0,2)*adj(2,0);
+
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t col = 0; col < 3; ++col) {
+            adj(row,col) = adj(row,col)/det;
+        }
+    }
+    return adj;
+}
+
+// Predicates =================================================================
+
+namespace Predicate {
+
+Orientation OrientationPQR(const LazyPoint_2r& p, const LazyPoint_2r& q,
+                           const LazyPoint_2r& r) {
+    LazyRational det = (q.x()-p.x())*(r.y()-p.y())-
+                       (q.y()-p.y())*(r.x()-p.x());
+    int s = det.sign();
+    if (s > 0) {
+        return ORIENTATION_LEFT;
+    } else if (s < 0) {
+        return ORIENTATION_RIGHT;
+    } else {
+        return ORIENTATION_COLINEAR;
+    }
+}
+
+} // namespace Predicate
+
+} // namespace DDAD
@@ -0,0 +1,344 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Lazy exact rationals: an interval approximation backed by an
+ * expression DAG that is evaluated exactly only on demand.
+ */
+
+#ifndef GE_LAZY_H
+#define GE_LAZY_H
+
+#include "common.h"
+#include "arithmetic.h"
+#include "point.h"
+#include "matrix.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Interface: Interval
+//=============================================================================
+
+/*!
+ * @brief Closed interval [lo, hi] of doubles. Arithmetic rounds outward by
+ * one ulp per operation, so the result always contains the exact result of
+ * the operation applied to any values in the operands.
+ */
+class Interval {
+public:
+    Interval();
+    Interval(const double d);
+    Interval(const double lo, const double hi);
+    explicit Interval(const rational& q);
+
+    //! @brief True if lo == hi, i.e. the interval is a single exact value.
+    bool is_point() const;
+    bool contains_zero() const;
+    double lo() const;
+    double hi() const;
+    double mid() const;
+
+private:
+    double lo_;
+    double hi_;
+};
+
+Interval operator+(const Interval& lhs, const Interval& rhs);
+Interval operator-(const Interval& lhs, const Interval& rhs);
+Interval operator*(const Interval& lhs, const Interval& rhs);
+Interval operator/(const Interval& lhs, const Interval& rhs);
+Interval operator-(const Interval& i);
+
+//=============================================================================
+// Interface: LazyRational
+//=============================================================================
+
+/*!
+ * @brief The LazyRational class is an exact rational number that is not
+ * computed until it has to be.
+ *
+ * Each value carries an Interval that encloses it and a node in an
+ * expression DAG of the operations that produced it. Sign tests and
+ * comparisons are decided from the intervals when they are disjoint from
+ * zero or from each other; only otherwise is the DAG evaluated in rational
+ * arithmetic. The exact value is cached per node, and its operands are
+ * released once it is known. Copies share nodes, so a LazyRational should
+ * not be evaluated concurrently from several threads.
+ */
+class LazyRational {
+public:
+    LazyRational();
+    LazyRational(const int n);
+    LazyRational(const rational& q);
+
+    const Interval& interval() const;
+    //! @brief Midpoint of the enclosing interval.
+    double get_d() const;
+    //! @brief The exact value, evaluating the DAG if necessary.
+    const rational& exact() const;
+    //! @brief True if the exact value has already been computed.
+    bool is_exact() const;
+    int sign() const;
+
+    friend LazyRational operator+(const LazyRational& lhs,
+                                  const LazyRational& rhs);
+    friend LazyRational operator-(const LazyRational& lhs,
+                                  const LazyRational& rhs);
+    friend LazyRational operator*(const LazyRational& lhs,
+                                  const LazyRational& rhs);
+    friend LazyRational operator/(const LazyRational& lhs,
+                                  const LazyRational& rhs);
+    friend LazyRational operator-(const LazyRational& q);
+
+private:
+    enum Op {
+        OP_CONSTANT,
+        OP_ADD,
+        OP_SUB,
+        OP_MUL,
+        OP_DIV,
+        OP_NEG
+    };
+
+    struct Node {
+        Op op;
+        Interval approx;
+        std::shared_ptr<Node> lhs;
+        std::shared_ptr<Node> rhs;
+        std::unique_ptr<rational> exact;
+    };
+
+    LazyRational(const Op op, const Interval& approx,
+                 const std::shared_ptr<Node>& lhs,
+                 const std::shared_ptr<Node>& rhs);
+
+    static const rational& Evaluate(Node& node);
+
+    std::shared_ptr<Node> node_;
+};
+
+int Compare(const LazyRational& lhs, const LazyRational& rhs);
+bool operator==(const LazyRational& lhs, const LazyRational& rhs);
+bool operator!=(const LazyRational& lhs, const LazyRational& rhs);
+bool operator<(const LazyRational& lhs, const LazyRational& rhs);
+bool operator<=(const LazyRational& lhs, const LazyRational& rhs);
+bool operator>(const LazyRational& lhs, const LazyRational& rhs);
+bool operator>=(const LazyRational& lhs, const LazyRational& rhs);
+std::ostream& operator<<(std::ostream& o, const LazyRational& q);
+
+//=============================================================================
+// Interface: LazyPoint_2r
+//=============================================================================
+
+class LazyPoint_2r {
+public:
+    LazyPoint_2r();
+    LazyPoint_2r(const Point_2r& p);
+    LazyPoint_2r(const LazyRational& x, const LazyRational& y);
+
+    const LazyRational& x() const;
+    const LazyRational& y() const;
+
+private:
+    std::array<LazyRational, 2> elements_;
+};
+
+//! @brief Evaluates p exactly.
+Point_2r ToPoint_2r(const LazyPoint_2r& p);
+//! @brief Approximates p from its intervals without exact evaluation.
+Point_2f ToPoint_2f(const LazyPoint_2r& p);
+
+//=============================================================================
+// Interface: LazyPoint_3r
+//=============================================================================
+
+class LazyPoint_3r {
+public:
+    LazyPoint_3r();
+    LazyPoint_3r(const Point_3r& p);
+    LazyPoint_3r(const LazyRational& x, const LazyRational& y,
+                 const LazyRational& z);
+
+    const LazyRational& x() const;
+    const LazyRational& y() const;
+    const LazyRational& z() const;
+
+private:
+    std::array<LazyRational, 3> elements_;
+};
+
+Point_3r ToPoint_3r(const LazyPoint_3r& p);
+Point_3f ToPoint_3f(const LazyPoint_3r& p);
+
+//=============================================================================
+// Interface: LazyMatrix_3x3r
+//=============================================================================
+
+typedef Mat<LazyRational, 3, 3> LazyMatrix_3x3r;
+
+/*!
+ * @brief Inverse of a nonsingular matrix, as its lazy adjugate entries over
+ * its lazy determinant. Unlike Inverse(Matrix_3x3r), nothing is multiplied
+ * out or canonicalized until an entry is compared or converted exactly.
+ */
+LazyMatrix_3x3r LazyInverse(const Matrix_3x3r& mat);
+
+// Predicates =================================================================
+
+namespace Predicate {
+
+Orientation OrientationPQR(const LazyPoint_2r& p, const LazyPoint_2r& q,
+                           const LazyPoint_2r& r);
+
+} // namespace Predicate
+
+//=============================================================================
+// Implementation: Interval
+//=============================================================================
+
+inline Interval::Interval() :
+    lo_(0.0),
+    hi_(0.0) {}
+
+inline Interval::Interval(const double d) :
+    lo_(d),
+    hi_(d) {}
+
+inline Interval::Interval(const double lo, const double hi) :
+    lo_(lo),
+    hi_(hi) {}
+
+inline bool Interval::is_point() const {
+    return lo_ == hi_;
+}
+
+inline bool Interval::contains_zero() const {
+    return lo_ <= 0.0 && hi_ >= 0.0;
+}
+
+inline double Interval::lo() const {
+    return lo_;
+}
+
+inline double Interval::hi() const {
+    return hi_;
+}
+
+inline double Interval::mid() const {
+    return lo_ == hi_ ? lo_ : 0.5*lo_+0.5*hi_;
+}
+
+//=============================================================================
+// Implementation: LazyRational
+//=============================================================================
+
+inline const Interval& LazyRational::interval() const {
+    return node_->approx;
+}
+
+inline double LazyRational::get_d() const {
+    return node_->approx.mid();
+}
+
+inline bool LazyRational::is_exact() const {
+    return node_->exact != nullptr;
+}
+
+inline const rational& LazyRational::exact() const {
+    return Evaluate(*node_);
+}
+
+inline bool operator==(const LazyRational& lhs, const LazyRational& rhs) {
+    return Compare(lhs, rhs) == 0;
+}
+
+inline bool operator!=(const LazyRational& lhs, const LazyRational& rhs) {
+    return Compare(lhs, rhs) != 0;
+}
+
+inline bool operator<(const LazyRational& lhs, const LazyRational& rhs) {
+    return Compare(lhs, rhs) < 0;
+}
+
+inline bool operator<=(const LazyRational& lhs, const LazyRational& rhs) {
+    return Compare(lhs, rhs) <= 0;
+}
+
+inline bool operator>(const LazyRational& lhs, const LazyRational& rhs) {
+    return Compare(lhs, rhs) > 0;
+}
+
+inline bool operator>=(const LazyRational& lhs, const LazyRational& rhs) {
+    return Compare(lhs, rhs) >= 0;
+}
+
+inline std::ostream& operator<<(std::ostream& o, const LazyRational& q) {
+    return o << q.exact();
+}
+
+//=============================================================================
+// Implementation: LazyPoint_2r, LazyPoint_3r
+//=============================================================================
+
+inline LazyPoint_2r::LazyPoint_2r() {}
+
+inline LazyPoint_2r::LazyPoint_2r(const Point_2r& p) {
+    elements_[0] = p.x();
+    elements_[1] = p.y();
+}
+
+inline LazyPoint_2r::LazyPoint_2r(const LazyRational& x,
+                                  const LazyRational& y) {
+    elements_[0] = x;
+    elements_[1] = y;
+}
+
+inline const LazyRational& LazyPoint_2r::x() const {
+    return elements_[0];
+}
+inline const LazyRational& LazyPoint_2r::y() const {
+    return elements_[1];
+}
+
+inline LazyPoint_3r::LazyPoint_3r() {}
+
+inline LazyPoint_3r::LazyPoint_3r(const Point_3r& p) {
+    elements_[0] = p.x();
+    elements_[1] = p.y();
+    elements_[2] = p.z();
+}
+
+inline LazyPoint_3r::LazyPoint_3r(const LazyRational& x,
+                                  const LazyRational& y,
+                                  const LazyRational& z) {
+    elements_[0] = x;
+    elements_[1] = y;
+    elements_[2] = z;
+}
+
+inline const LazyRational& LazyPoint_3r::x() const {
+    return elements_[0];
+}
+inline const LazyRational& LazyPoint_3r::y() const {
+    return elements_[1];
+}
+inline const LazyRational& LazyPoint_3r::z() const {
+    return elements_[2];
+}
+
+} // namespace DDAD
+
+#endif // GE_LAZY_H
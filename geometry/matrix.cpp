@@ -13,37 +13,158 @@
  * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstdlib>
+
 #include "common.h"
 #include "matrix.h"
+#include "modular.h"
+#include "bareiss.h"
 #include "point.h"
 #include "vector.h"
 
 namespace DDAD {
 
+//=============================================================================
+// Implementation: Sign of integer determinants
+//=============================================================================
+
+template <class T>
+static Sign ToSign(const T& x) {
+    return x > 0 ? SIGN_POSITIVE : (x < 0 ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+template <size_t N>
+static bool AllFit(const std::array<integer, N>& elements, const int bits) {
+    for (auto& e : elements) {
+        if (!IntegerFits(e, bits)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Integer>
+static Sign SignOfDeterminant2(const Matrix_2x2i& mat) {
+    Integer a = ToInt64(mat(0,0)), b = ToInt64(mat(0,1));
+    Integer c = ToInt64(mat(1,0)), d = ToInt64(mat(1,1));
+    return ToSign(a*d-b*c);
+}
+
+//! @brief Cofactor expansion along the first row; with entries below 2^k
+//! every intermediate stays below 2^(3k+3).
+template <class Integer>
+static Sign SignOfDeterminant3(const Matrix_3x3i& mat) {
+    Integer m[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            m[i][j] = ToInt64(mat(i,j));
+        }
+    }
+    Integer c0 = m[1][1]*m[2][2]-m[1][2]*m[2][1];
+    Integer c1 = m[1][0]*m[2][2]-m[1][2]*m[2][0];
+    Integer c2 = m[1][0]*m[2][1]-m[1][1]*m[2][0];
+    return ToSign(m[0][0]*c0-m[0][1]*c1+m[0][2]*c2);
+}
+
+/*!
+ * Entries below 2^31 keep both products and their difference within 63
+ * bits; with 128-bit integers the bound is 2^63. Larger entries compare the
+ * two products in integer arithmetic instead.
+ */
+Sign SignOfDeterminant(const Matrix_2x2i& mat) {
+    if (AllFit(mat.elements(), 31)) {
+        return SignOfDeterminant2<int64_t>(mat);
+    }
+#if DDAD_HAS_INT128
+    if (AllFit(mat.elements(), 63)) {
+        return SignOfDeterminant2<int128_t>(mat);
+    }
+#endif
+    integer ad = mat(0,0)*mat(1,1);
+    integer bc = mat(0,1)*mat(1,0);
+    return ad > bc ? SIGN_POSITIVE : (ad < bc ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+Sign SignOfDeterminant(const Matrix_3x3i& mat) {
+    if (AllFit(mat.elements(), 20)) {
+        return SignOfDeterminant3<int64_t>(mat);
+    }
+#if DDAD_HAS_INT128
+    if (AllFit(mat.elements(), 41)) {
+        return SignOfDeterminant3<int128_t>(mat);
+    }
+#endif
+    return ModularSignOfDeterminant(mat.elements().data(), 3);
+}
+
 //=============================================================================
 // Implementation: Matrix_3x3i
 //=============================================================================
 
 integer Determinant(const Matrix_3x3i& mat) {
-    return mat(0,0)*mat(1,1)*mat(2,2) -
-           mat(0,0)*mat(2,1)*mat(1,2) +
-           mat(1,0)*mat(2,1)*mat(0,2) -
-           mat(1,0)*mat(0,1)*mat(2,2) +
-           mat(2,0)*mat(0,1)*mat(1,2) -
-           mat(2,0)*mat(1,1)*mat(0,2);
+    return ModularDeterminant(mat.elements().data(), 3);
+}
+
+Matrix_3x3i Adjugate(const Matrix_3x3i& mat) {
+    return Matrix_3x3i( mat(1,1)*mat(2,2)-mat(1,2)*mat(2,1),
+                       -(mat(0,1)*mat(2,2)-mat(0,2)*mat(2,1)),
+                        mat(0,1)*mat(1,2)-mat(0,2)*mat(1,1),
+                       -(mat(1,0)*mat(2,2)-mat(1,2)*mat(2,0)),
+                        mat(0,0)*mat(2,2)-mat(0,2)*mat(2,0),
+                       -(mat(0,0)*mat(1,2)-mat(0,2)*mat(1,0)),
+                        mat(1,0)*mat(2,1)-mat(1,1)*mat(2,0),
+                       -(mat(0,0)*mat(2,1)-mat(0,1)*mat(2,0)),
+                        mat(0,0)*mat(1,1)-mat(0,1)*mat(1,0));
+}
+
+void NotUnimodular(const char* caller) {
+    LOG(FATAL) << caller << ": matrix is not unimodular, use RationalInverse";
+    std::abort();
 }
 
+//! @brief 1/det = det for det = +-1, so no division is needed.
 Matrix_3x3i Inverse(const Matrix_3x3i& mat) {
-    integer d = Determinant(mat);
-    return Matrix_3x3i( (mat(1,1)*mat(2,2)-mat(1,2)*mat(2,1))/d,
-                       -(mat(0,1)*mat(2,2)-mat(0,2)*mat(2,1))/d,
-                        (mat(0,1)*mat(1,2)-mat(0,2)*mat(1,1))/d,
-                       -(mat(1,0)*mat(2,2)-mat(1,2)*mat(2,0))/d,
-                        (mat(0,0)*mat(2,2)-mat(0,2)*mat(2,0))/d,
-                       -(mat(0,0)*mat(1,2)-mat(0,2)*mat(1,0))/d,
-                        (mat(1,0)*mat(2,1)-mat(1,1)*mat(2,0))/d,
-                       -(mat(0,0)*mat(2,1)-mat(0,1)*mat(2,0))/d,
-                        (mat(0,0)*mat(1,1)-mat(0,1)*mat(1,0))/d);
+    Matrix_3x3i adj = Adjugate(mat);
+    integer det = mat(0,0)*adj(0,0)+mat(0,1)*adj(1,0)+mat(0,2)*adj(2,0);
+    if (det != 1 && det != -1) {
+        NotUnimodular("Inverse(Matrix_3x3i)");
+    }
+    return adj*det;
+}
+
+//! @brief Each entry is canonicalized once.
+Matrix_3x3r RationalInverse(const Matrix_3x3i& mat) {
+    DDAD_PROFILE_SITE("Construction::RationalInverse(Matrix_3x3i)");
+    Matrix_3x3i adj = Adjugate(mat);
+    integer det = mat(0,0)*adj(0,0)+mat(0,1)*adj(1,0)+mat(0,2)*adj(2,0);
+    assert(det != 0);
+    if (det < 0) {
+        // mpq_set requires a positive denominator
+        det = -det;
+        adj = -adj;
+    }
+    auto entry = [&](const int row, const int col) {
+        rational r(adj(row,col), det);
+        r.canonicalize();
+        return r;
+    };
+    return Matrix_3x3r(entry(0,0), entry(0,1), entry(0,2),
+                       entry(1,0), entry(1,1), entry(1,2),
+                       entry(2,0), entry(2,1), entry(2,2));
+}
+
+//=============================================================================
+// Implementation: Matrix_NxNi
+//=============================================================================
+
+integer Determinant(const Matrix_NxNi& mat) {
+    return ModularDeterminant(mat.elements().data(),
+                              static_cast<int>(mat.size()));
+}
+
+Sign SignOfDeterminant(const Matrix_NxNi& mat) {
+    return ModularSignOfDeterminant(mat.elements().data(),
+                                    static_cast<int>(mat.size()));
 }
 
 //=============================================================================
@@ -51,27 +172,67 @@ Matrix_3x3i Inverse(const Matrix_3x3i& mat) {
 //=============================================================================
 
 rational Determinant(const Matrix_3x3r& mat) {
-    return mat(0,0)*mat(1,1)*mat(2,2) -
-           mat(0,0)*mat(2,1)*mat(1,2) +
-           mat(1,0)*mat(2,1)*mat(0,2) -
-           mat(1,0)*mat(0,1)*mat(2,2) +
-           mat(2,0)*mat(0,1)*mat(1,2) -
-           mat(2,0)*mat(1,1)*mat(0,2);
+    return BareissDeterminant(mat.elements().data(), 3);
+}
+
+Sign SignOfDeterminant(const Matrix_3x3r& mat) {
+    return BareissSignOfDeterminant(mat.elements().data(), 3);
 }
 
+/*!
+ * Computed division-free: with D the common denominator of the entries and
+ * M = A/D for an integer matrix A, the inverse is D*adj(A)/det(A). Each
+ * entry is canonicalized once. A singular matrix yields adj(mat).
+ */
 Matrix_3x3r Inverse(const Matrix_3x3r& mat) {
-    rational d = Determinant(mat);
-    d = (d == 0) ? 1 : rational(d.get_den(), d.get_num());
-
-    return Matrix_3x3r( (mat(1,1)*mat(2,2)-mat(1,2)*mat(2,1))*d,
-                       -(mat(0,1)*mat(2,2)-mat(0,2)*mat(2,1))*d,
-                        (mat(0,1)*mat(1,2)-mat(0,2)*mat(1,1))*d,
-                       -(mat(1,0)*mat(2,2)-mat(1,2)*mat(2,0))*d,
-                        (mat(0,0)*mat(2,2)-mat(0,2)*mat(2,0))*d,
-                       -(mat(0,0)*mat(1,2)-mat(0,2)*mat(1,0))*d,
-                        (mat(1,0)*mat(2,1)-mat(1,1)*mat(2,0))*d,
-                       -(mat(0,0)*mat(2,1)-mat(0,1)*mat(2,0))*d,
-                        (mat(0,0)*mat(1,1)-mat(0,1)*mat(1,0))*d);
+    DDAD_PROFILE_SITE("Construction::Inverse(Matrix_3x3r)");
+    integer D = 1;
+    for (int i = 0; i < 9; ++i) {
+        integer den = mat.elements()[i].get_den();
+        mpz_lcm(D.get_mpz_t(), D.get_mpz_t(), den.get_mpz_t());
+    }
+    std::array<integer, 9> a;
+    for (int i = 0; i < 9; ++i) {
+        integer den = mat.elements()[i].get_den();
+        mpz_divexact(a[i].get_mpz_t(), D.get_mpz_t(), den.get_mpz_t());
+        a[i] *= mat.elements()[i].get_num();
+    }
+    // elements are column-major
+    auto A = [&a](const int row, const int col) -> const integer& {
+        return a[(col*3)+row];
+    };
+
+    integer adj[9] = {
+         A(1,1)*A(2,2)-A(1,2)*A(2,1),
+        -(A(0,1)*A(2,2)-A(0,2)*A(2,1)),
+         A(0,1)*A(1,2)-A(0,2)*A(1,1),
+        -(A(1,0)*A(2,2)-A(1,2)*A(2,0)),
+         A(0,0)*A(2,2)-A(0,2)*A(2,0),
+        -(A(0,0)*A(1,2)-A(0,2)*A(1,0)),
+         A(1,0)*A(2,1)-A(1,1)*A(2,0),
+        -(A(0,0)*A(2,1)-A(0,1)*A(2,0)),
+         A(0,0)*A(1,1)-A(0,1)*A(1,0)
+    };
+    integer det = A(0,0)*adj[0]+A(0,1)*adj[3]+A(0,2)*adj[6];
+
+    integer num_scale, den;
+    if (det == 0) {
+        num_scale = 1;
+        den = D*D;
+    } else {
+        num_scale = D;
+        den = det;
+    }
+    // mpq_set requires a positive denominator, canonicalize before copying
+    auto entry = [&](const int i) {
+        rational r(adj[i]*num_scale, den);
+        r.canonicalize();
+        return r;
+    };
+
+    return Matrix_3x3r(entry(0), entry(1), entry(2),
+                       entry(3), entry(4), entry(5),
+                       entry(6), entry(7), entry(8));
 }
 
 } // namespace DDAD
@@ -19,632 +19,520 @@
 #include "common.h"
 #include "point.h"
 #include "vector.h"
+#include "modular.h"
+#include "bareiss.h"
 
 namespace DDAD {
 
-//=============================================================================
-// Interface: Matrix_2x2i
-//=============================================================================
-
-class Matrix_2x2i {
-public:
-    Matrix_2x2i();
-    Matrix_2x2i(const integer& a, const integer& b,
-                const integer& c, const integer& d);
-
-      const integer& operator()(const size_t row, const size_t col) const;
-      integer& operator()(const size_t row, const size_t col);
-      const std::array<integer, 4>& elements() const;
-
-  private:
-      std::array<integer, 4> elements_;
-};
-
-Vector_2i RowVec(const Matrix_2x2i& mat, const size_t row);
-Vector_2i ColVec(const Matrix_2x2i& mat, const size_t col);
-
-integer Determinant(const Matrix_2x2i& mat);
-Matrix_2x2i Inverse(const Matrix_2x2i& mat);
-Matrix_2x2i Transpose(const Matrix_2x2i& mat);
-std::string to_string(const Matrix_2x2i& mat);
-
-bool operator==(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs);
-bool operator!=(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs);
-Matrix_2x2i operator+(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs);
-Matrix_2x2i operator-(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs);
-Matrix_2x2i operator-(const Matrix_2x2i& mat);
-Matrix_2x2i operator*(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs);
-Matrix_2x2i operator*(const Matrix_2x2i& lhs, const integer& rhs);
-Matrix_2x2i operator*(const integer& lhs, const Matrix_2x2i& rhs);
-//Matrix_2x2i operator/(const Matrix_2x2i& lhs, const integer rhs);
-//Matrix_2x2i& operator+=(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs);
-//Matrix_2x2i& operator-=(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs);
-//Matrix_2x2i& operator*=(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs);
-//Matrix_2x2i& operator*=(const Matrix_2x2i& lhs, const integer rhs);
-//Matrix_2x2i& operator/=(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs);
-//Matrix_2x2i& operator/=(const Matrix_2x2i& lhs, const integer rhs);
-std::ostream& operator<<(std::ostream& o, const Matrix_2x2i& mat);
-
-//=============================================================================
-// Interface: Mixed Matrix_2x2i arithmetic
-//=============================================================================
+template <class T, size_t R, size_t C> class Mat;
 
-Point_2i operator*(const Point_2i& p, const Matrix_2x2i& mat);
-Point_2i operator*(const Matrix_2x2i& mat, const Point_2i& p);
-Vector_2i operator*(const Vector_2i& v, const Matrix_2x2i& mat);
-Vector_2i operator*(const Matrix_2x2i& mat, const Vector_2i& v);
+typedef Mat<integer, 2, 2> Matrix_2x2i;
+typedef Mat<rational, 2, 2> Matrix_2x2r;
+typedef Mat<integer, 3, 3> Matrix_3x3i;
+typedef Mat<rational, 3, 3> Matrix_3x3r;
+typedef Mat<integer, 4, 4> Matrix_4x4i;
+typedef Mat<rational, 4, 4> Matrix_4x4r;
 
 //=============================================================================
-// Implementation: Matrix_2x2i
+// Interface: Mat
 //=============================================================================
 
-inline Matrix_2x2i::Matrix_2x2i() {
-    Matrix_2x2i& mat = *this;
-    mat(0,0) = 1;
-    mat(0,1) = 0;
-    mat(1,0) = 0;
-    mat(1,1) = 1;
-}
-
-inline Matrix_2x2i::Matrix_2x2i(const integer& a, const integer& b,
-                                const integer& c, const integer& d) {
-    Matrix_2x2i& mat = *this;
-    mat(0,0) = a;
-    mat(0,1) = b;
-    mat(1,0) = c;
-    mat(1,1) = d;
-}
-
-inline const integer& Matrix_2x2i::operator()(const size_t row,
-                                              const size_t col) const {
-    return elements_[(col*2)+row];
-}
+/*!
+ * @brief R x C matrix of T, stored in column-major order. Entries are given
+ * to the constructors row by row. Rational entries are expected in canonical
+ * form, as every result of rational arithmetic is.
+ */
+template <class T, size_t R, size_t C>
+class Mat {
+public:
+    typedef T Scalar;
+
+    Mat();
+    constexpr Mat(const T& a, const T& b,
+                  const T& c, const T& d);
+    constexpr Mat(const T& m00, const T& m01, const T& m02,
+                  const T& m10, const T& m11, const T& m12,
+                  const T& m20, const T& m21, const T& m22);
+    template <class U, typename std::enable_if<
+        IsWidening<U, T>::value, int>::type = 0>
+    Mat(const Mat<U, R, C>& mat);
+
+    const T& operator()(const size_t row, const size_t col) const;
+    T& operator()(const size_t row, const size_t col);
+    const std::array<T, R*C>& elements() const;
+
+    friend bool operator==(const Mat& lhs, const Mat& rhs) {
+        return lhs.elements_ == rhs.elements_;
+    }
 
-inline integer& Matrix_2x2i::operator()(const size_t row, const size_t col) {
-    return elements_[(col*2)+row];
-}
+    friend bool operator!=(const Mat& lhs, const Mat& rhs) {
+        return lhs.elements_ != rhs.elements_;
+    }
 
-inline Matrix_2x2i operator*(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs) {
-    Matrix_2x2i result;
-    for(int r = 0; r < 2; ++r) {
-        for(int c = 0; c < 2; ++c) {
-            // it's not the other way around with transposing the rhs, right?
-            result(r,c) = Transpose(lhs)(r,c) * rhs(r,c);
+    friend Mat operator+(Mat lhs, const Mat& rhs) {
+        for (size_t i = 0; i < R*C; ++i) {
+            lhs.elements_[i] += rhs.elements_[i];
         }
+        return lhs;
     }
-    return result;
-}
 
-inline Matrix_2x2i operator+(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs) {
-    Matrix_2x2i result = Matrix_2x2i();
-    for(int r = 0; r < 2; ++r) {
-        for(int c = 0; c < 2; ++c) {
-            result(r,c) = lhs(r,c)+rhs(r,c);
+    friend Mat operator-(Mat lhs, const Mat& rhs) {
+        for (size_t i = 0; i < R*C; ++i) {
+            lhs.elements_[i] -= rhs.elements_[i];
         }
+        return lhs;
     }
-    return result;
-}
-
-inline Matrix_2x2i operator-(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs) {
-    return lhs + (-rhs);
-}
-
-inline Matrix_2x2i operator-(const Matrix_2x2i& mat) {
-      return Matrix_2x2i(-mat(0,0), -mat(0,1),
-                         -mat(1,0), -mat(1,1));
-}
-
-inline Matrix_2x2i Transpose(const Matrix_2x2i& mat) {
-    return Matrix_2x2i(mat(0,0), mat(1,0),
-                       mat(0,1), mat(1,1));
-}
-
-inline bool operator==(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs) {
-    return lhs.elements() == rhs.elements();
-}
 
-inline bool operator!=(const Matrix_2x2i& lhs, const Matrix_2x2i& rhs) {
-    return lhs.elements() != rhs.elements();
-}
-
-inline Matrix_2x2i operator*(const integer& lhs, const Matrix_2x2i& rhs) {
-    return Matrix_2x2i(lhs*rhs(0,0), lhs*rhs(0,1),
-                       lhs*rhs(1,0), lhs*rhs(1,1));
-}
+    friend Mat operator-(Mat mat) {
+        for (size_t i = 0; i < R*C; ++i) {
+            mat.elements_[i] = -mat.elements_[i];
+        }
+        return mat;
+    }
 
-inline Matrix_2x2i operator*(const Matrix_2x2i& lhs, const integer& rhs) {
-    return rhs*lhs;
-}
+    friend Mat operator*(Mat mat, const T& s) {
+        for (size_t i = 0; i < R*C; ++i) {
+            mat.elements_[i] *= s;
+        }
+        return mat;
+    }
 
-inline std::ostream& operator<<(std::ostream& o, const Matrix_2x2i& mat) {
-    o << to_string(mat);
-    return o;
-}
+    friend Mat operator*(const T& s, const Mat& mat) {
+        return mat*s;
+    }
 
-inline std::string to_string(const Matrix_2x2i& mat) {
-    std::stringstream result;
-    result << "[" << mat(0,0) << " " << mat(0,1) << "]\n"
-           << "[" << mat(1,0) << " " << mat(1,1) << "]";
-    return result.str();
-}
+    friend std::ostream& operator<<(std::ostream& o, const Mat& mat) {
+        return o << to_string(mat);
+    }
 
-inline Vector_2i RowVec(const Matrix_2x2i& mat, const size_t row) {
-    return Vector_2i(mat(row, 0), mat(row, 1));
-}
+    //! @brief One bracketed row per line.
+    friend std::string to_string(const Mat& mat) {
+        std::stringstream result;
+        for (size_t row = 0; row < R; ++row) {
+            result << (row > 0 ? "\n[" : "[") << mat(row,0);
+            for (size_t col = 1; col < C; ++col) {
+                result << " " << mat(row,col);
+            }
+            result << "]";
+        }
+        return result.str();
+    }
 
-inline Vector_2i ColVec(const Matrix_2x2i& mat, const size_t col) {
-    return Vector_2i(mat(0, col), mat(1, col));
-}
+private:
+    std::array<T, R*C> elements_;
+};
 
-inline integer Determinant(const Matrix_2x2i& mat) {
-    return mat(0,0)*mat(1,1)-mat(0,1)*mat(1,0);
-}
+template <class T, size_t R, size_t C>
+Vec<T, C> RowVec(const Mat<T, R, C>& mat, const size_t row);
+template <class T, size_t R, size_t C>
+Vec<T, R> ColVec(const Mat<T, R, C>& mat, const size_t col);
+template <class T, size_t R, size_t C>
+Mat<T, C, R> Transpose(const Mat<T, R, C>& mat);
 
-inline Matrix_2x2i Inverse(const Matrix_2x2i& mat) {
-    integer det = Determinant(mat);
-    return Matrix_2x2i( mat(1,1)/det, -mat(0,1)/det,
-                       -mat(1,0)/det,  mat(0,0)/det);
-}
+template <class T>
+T Determinant(const Mat<T, 2, 2>& mat);
+integer Determinant(const Matrix_3x3i& mat);
+rational Determinant(const Matrix_3x3r& mat);
+//! @brief Sign of the determinant, in machine integers when the entries
+//! are small enough.
+Sign SignOfDeterminant(const Matrix_2x2i& mat);
+Sign SignOfDeterminant(const Matrix_3x3i& mat);
+//! @brief Without dividing out denominators, see bareiss.h.
+Sign SignOfDeterminant(const Matrix_3x3r& mat);
+
+//! @brief Beyond 3x3, integer determinants are multi-modular, see
+//! modular.h, and rational ones fraction-free, see bareiss.h.
+template <size_t N, typename std::enable_if<(N > 3), int>::type = 0>
+integer Determinant(const Mat<integer, N, N>& mat);
+template <size_t N, typename std::enable_if<(N > 3), int>::type = 0>
+rational Determinant(const Mat<rational, N, N>& mat);
+template <size_t N, typename std::enable_if<(N > 3), int>::type = 0>
+Sign SignOfDeterminant(const Mat<integer, N, N>& mat);
+template <size_t N, typename std::enable_if<(N > 3), int>::type = 0>
+Sign SignOfDeterminant(const Mat<rational, N, N>& mat);
+
+//! @brief Rank and solution of mat*x = rhs by fraction-free elimination.
+//! Solve returns false, leaving x unchanged, if mat is singular.
+template <class T, size_t R, size_t C>
+int Rank(const Mat<T, R, C>& mat);
+template <size_t N>
+bool Solve(const Mat<integer, N, N>& mat, const Vec<integer, N>& rhs,
+           Vec<rational, N>& x);
+template <size_t N>
+bool Solve(const Mat<rational, N, N>& mat, const Vec<rational, N>& rhs,
+           Vec<rational, N>& x);
+//! @brief Transposed cofactor matrix; mat*adj(mat) = det(mat)*I, so an
+//! integer inverse scaled by the determinant.
+Matrix_2x2i Adjugate(const Matrix_2x2i& mat);
+Matrix_3x3i Adjugate(const Matrix_3x3i& mat);
+//! @brief mat must be unimodular, which is checked in every build; see
+//! RationalInverse otherwise.
+Matrix_2x2i Inverse(const Matrix_2x2i& mat);
+Matrix_3x3i Inverse(const Matrix_3x3i& mat);
+Matrix_3x3r Inverse(const Matrix_3x3r& mat);
+//! @brief Exact inverse of a nonsingular integer matrix, adj(mat)/det(mat).
+Matrix_3x3r RationalInverse(const Matrix_3x3i& mat);
+//! @brief Logs a fatal error for an integer Inverse given a matrix that is
+//! not unimodular and aborts, even if fatal logs are disabled.
+[[noreturn]] void NotUnimodular(const char* caller);
 
-// Accessors/Mutators =========================================================
+//=============================================================================
+// Interface: Mixed Mat arithmetic
+//=============================================================================
 
-inline const std::array<integer, 4>& Matrix_2x2i::elements() const {
-    return elements_;
-}
+template <class T, size_t R, size_t K, size_t C>
+Mat<T, R, C> operator*(const Mat<T, R, K>& lhs, const Mat<T, K, C>& rhs);
+
+// The matrix may be of a narrower type than the point or vector, e.g. a
+// Point_3r times a Matrix_3x3i is a Point_3r.
+template <class T, class U, size_t R, size_t C, typename std::enable_if<
+    IsWidening<U, T>::value, int>::type = 0>
+Point<T, C> operator*(const Point<T, R>& p, const Mat<U, R, C>& mat);
+template <class T, class U, size_t R, size_t C, typename std::enable_if<
+    IsWidening<U, T>::value, int>::type = 0>
+Point<T, R> operator*(const Mat<U, R, C>& mat, const Point<T, C>& p);
+template <class T, class U, size_t R, size_t C, typename std::enable_if<
+    IsWidening<U, T>::value, int>::type = 0>
+Vec<T, C> operator*(const Vec<T, R>& v, const Mat<U, R, C>& mat);
+template <class T, class U, size_t R, size_t C, typename std::enable_if<
+    IsWidening<U, T>::value, int>::type = 0>
+Vec<T, R> operator*(const Mat<U, R, C>& mat, const Vec<T, C>& v);
 
 //=============================================================================
-// Implementation: Mixed Matrix_2x2i arithmetic
+// Implementation: Mat
 //=============================================================================
 
-inline Point_2i operator*(const Point_2i& p, const Matrix_2x2i& mat) {
-    return Point_2i(Dot(ColVec(mat, 0), p),
-                    Dot(ColVec(mat, 1), p));
+//! @brief Ones on the diagonal, i.e. the identity for square matrices.
+template <class T, size_t R, size_t C>
+inline Mat<T, R, C>::Mat() :
+    elements_() {
+    for (size_t i = 0; i < R && i < C; ++i) {
+        (*this)(i,i) = 1;
+    }
 }
 
-inline Point_2i operator*(const Matrix_2x2i& mat, const Point_2i& p) {
-    return Point_2i(Dot(RowVec(mat, 0), p),
-                    Dot(RowVec(mat, 1), p));
+template <class T, size_t R, size_t C>
+inline constexpr Mat<T, R, C>::Mat(const T& a, const T& b,
+                                   const T& c, const T& d) :
+    elements_{{a, c, b, d}} {
+    static_assert(R == 2 && C == 2, "Mat: four entries for a non-2x2 matrix");
 }
 
-inline Vector_2i operator*(const Vector_2i& v, const Matrix_2x2i& mat) {
-    return Vector_2i(Dot(ColVec(mat, 0), v),
-                     Dot(ColVec(mat, 1), v));
+template <class T, size_t R, size_t C>
+inline constexpr Mat<T, R, C>::Mat(const T& m00, const T& m01, const T& m02,
+                                   const T& m10, const T& m11, const T& m12,
+                                   const T& m20, const T& m21, const T& m22) :
+    elements_{{m00, m10, m20, m01, m11, m21, m02, m12, m22}} {
+    static_assert(R == 3 && C == 3, "Mat: nine entries for a non-3x3 matrix");
 }
 
-inline Vector_2i operator*(const Matrix_2x2i& mat, const Vector_2i& v) {
-    return Vector_2i(Dot(RowVec(mat, 0), v),
-                     Dot(RowVec(mat, 1), v));
+//! @brief Allow implicit conversion from a matrix of narrower type.
+template <class T, size_t R, size_t C>
+template <class U, typename std::enable_if<
+    IsWidening<U, T>::value, int>::type>
+inline Mat<T, R, C>::Mat(const Mat<U, R, C>& mat) :
+    elements_() {
+    for (size_t i = 0; i < R*C; ++i) {
+        elements_[i] = mat.elements()[i];
+    }
 }
 
-//=============================================================================
-// Interface: Matrix_2x2r
-//=============================================================================
-
-class Matrix_2x2r {
-public:
-    Matrix_2x2r();
-    Matrix_2x2r(const rational& a, const rational& b,
-                const rational& c, const rational& d);
-
-    const rational& operator()(const size_t row, const size_t col) const;
-    rational& operator()(const size_t row, const size_t col);
-    const std::array<rational, 4>& elements() const;
-
-private:
-    std::array<rational, 4> elements_;
-};
-
-rational Determinant(const Matrix_2x2r& mat);
-
-/*
-bool operator==(const Matrix_2x2r& lhs, const Matrix_2x2r& rhs);
-bool operator!=(const Matrix_2x2r& lhs, const Matrix_2x2r& rhs);
-Matrix_2x2r operator+(const Matrix_2x2r& lhs, const Matrix_2x2r& rhs);
-Matrix_2x2r operator-(const Matrix_2x2r& lhs, const Matrix_2x2r& rhs);
-Matrix_2x2r operator-(const Matrix_2x2r& M);
-Matrix_2x2r operator*(const Matrix_2x2r& lhs, const Matrix_2x2r& rhs);
-Matrix_2x2r operator*(const Matrix_2x2r& lhs, const rational& rhs);
-Matrix_2x2r operator/(const Matrix_2x2r& lhs, const rational& rhs);
-Matrix_2x2r& operator+=(const Matrix_2x2r& lhs, const Matrix_2x2r& rhs);
-Matrix_2x2r& operator-=(const Matrix_2x2r& lhs, const Matrix_2x2r& rhs);
-Matrix_2x2r& operator*=(const Matrix_2x2r& lhs, const Matrix_2x2r& rhs);
-Matrix_2x2r& operator*=(const Matrix_2x2r& lhs, const rational& rhs);
-Matrix_2x2r& operator/=(const Matrix_2x2r& lhs, const Matrix_2x2r& rhs);
-Matrix_2x2r& operator/=(const Matrix_2x2r& lhs, const rational& rhs);
-std::ostream& operator<<(std::ostream& o, const Matrix_2x2r& mat);
-
-Matrix_2x2r Inverse(const Matrix_2x2r& M);
-Matrix_2x2r Transpose(const Matrix_2x2r& M);
-std::string to_string(const Matrix_2x2r& M);
-*/
-
-//=============================================================================
-// Implementation: Matrix_2x2r
-//=============================================================================
-
-inline Matrix_2x2r::Matrix_2x2r() {
-    Matrix_2x2r& mat = *this;
-    mat(0,0) = 1;
-    mat(0,1) = 0;
-    mat(1,0) = 0;
-    mat(1,1) = 1;
+template <class T, size_t R, size_t C>
+inline const T& Mat<T, R, C>::operator()(const size_t row,
+                                         const size_t col) const {
+    return elements_[(col*R)+row];
 }
 
-inline Matrix_2x2r::Matrix_2x2r(const rational& a, const rational& b,
-                                const rational& c, const rational& d) {
-    Matrix_2x2r& mat = *this;
-    mat(0,0) = a;
-    mat(0,1) = b;
-    mat(1,0) = c;
-    mat(1,1) = d;
+template <class T, size_t R, size_t C>
+inline T& Mat<T, R, C>::operator()(const size_t row, const size_t col) {
+    return elements_[(col*R)+row];
 }
 
-inline const rational& Matrix_2x2r::operator()(const size_t row,
-                                               const size_t col) const {
-    return elements_[(col*2)+row];
+template <class T, size_t R, size_t C>
+inline Vec<T, C> RowVec(const Mat<T, R, C>& mat, const size_t row) {
+    std::array<T, C> elements;
+    for (size_t col = 0; col < C; ++col) {
+        elements[col] = mat(row,col);
+    }
+    return Vec<T, C>(std::move(elements));
 }
 
-inline rational& Matrix_2x2r::operator()(const size_t row, const size_t col) {
-    return elements_[(col*2)+row];
+template <class T, size_t R, size_t C>
+inline Vec<T, R> ColVec(const Mat<T, R, C>& mat, const size_t col) {
+    std::array<T, R> elements;
+    for (size_t row = 0; row < R; ++row) {
+        elements[row] = mat(row,col);
+    }
+    return Vec<T, R>(std::move(elements));
 }
 
-inline rational Determinant(const Matrix_2x2r& mat) {
-    return mat(0,0)*mat(1,1)-mat(0,1)*mat(1,0);
+template <class T, size_t R, size_t C>
+inline Mat<T, C, R> Transpose(const Mat<T, R, C>& mat) {
+    Mat<T, C, R> transpose;
+    for (size_t row = 0; row < R; ++row) {
+        for (size_t col = 0; col < C; ++col) {
+            transpose(col,row) = mat(row,col);
+        }
+    }
+    return transpose;
 }
 
-// Accessors/Mutators =========================================================
-
-inline const std::array<rational, 4>& Matrix_2x2r::elements() const {
-    return elements_;
+template <class T>
+inline T Determinant(const Mat<T, 2, 2>& mat) {
+    return mat(0,0)*mat(1,1)-mat(0,1)*mat(1,0);
 }
 
-//=============================================================================
-// Interface: Matrix_3x3i
-//=============================================================================
-
-class Matrix_3x3i {
-public:
-    Matrix_3x3i();
-    Matrix_3x3i(const integer& m00, const integer& m01, const integer& m02,
-                const integer& m10, const integer& m11, const integer& m12,
-                const integer& m20, const integer& m21, const integer& m22);
-
-    const integer& operator()(const size_t row, const size_t col) const;
-    integer& operator()(const size_t row, const size_t col);
-    const std::array<integer, 9>& elements() const;
-
-private:
-    std::array<integer, 9> elements_;
-};
-
-bool operator==(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-bool operator!=(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-Matrix_3x3i operator*(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-std::ostream& operator<<(std::ostream& o, const Matrix_3x3i& mat);
-
-Vector_3i RowVec(const Matrix_3x3i& mat, const int row);
-Vector_3i ColVec(const Matrix_3x3i& mat, const int col);
-
-integer Determinant(const Matrix_3x3i& mat);
-Matrix_3x3i Inverse(const Matrix_3x3i& mat);
-//Matrix_3x3i Transpose(const Matrix_3x3i& mat);
-std::string to_string(const Matrix_3x3i& mat);
-
-/*
-bool operator==(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-bool operator!=(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-Matrix_3x3i operator+(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-Matrix_3x3i operator-(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-Matrix_3x3i operator-(const Matrix_3x3i& mat);
-Matrix_3x3i operator*(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-Matrix_3x3i operator*(const Matrix_3x3i& lhs, const integer& rhs);
-Matrix_3x3i operator/(const Matrix_3x3i& lhs, const integer& rhs);
-Matrix_3x3i& operator+=(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-Matrix_3x3i& operator-=(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-Matrix_3x3i& operator*=(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-Matrix_3x3i& operator*=(const Matrix_3x3i& lhs, const integer& rhs);
-Matrix_3x3i& operator/=(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs);
-Matrix_3x3i& operator/=(const Matrix_3x3i& lhs, const integer& rhs);
-*/
-
-//=============================================================================
-// Interface: Mixed Matrix_3x3i arithmetic
-//=============================================================================
-
-Point_3i operator*(const Point_3i& lhs, const Matrix_3x3i& rhs);
-Point_3i operator*(const Matrix_3x3i& lhs, const Point_3i& rhs);
-Vector_3i operator*(const Vector_3i& lhs, const Matrix_3x3i& rhs);
-Vector_3i operator*(const Matrix_3x3i& lhs, const Vector_3i& rhs);
-
-//=============================================================================
-// Implementation: Matrix_3x3i
-//=============================================================================
-
-inline Matrix_3x3i::Matrix_3x3i() {
-    Matrix_3x3i& mat = *this;
-    mat(0,0) = 1;
-    mat(0,1) = 0;
-    mat(0,2) = 0;
-    mat(1,0) = 0;
-    mat(1,1) = 1;
-    mat(1,2) = 0;
-    mat(2,0) = 0;
-    mat(2,1) = 0;
-    mat(2,2) = 1;
-}
-
-inline Matrix_3x3i::Matrix_3x3i(const integer& m00, const integer& m01,
-                                const integer& m02, const integer& m10,
-                                const integer& m11, const integer& m12,
-                                const integer& m20, const integer& m21,
-                                const integer& m22) {
-    Matrix_3x3i& mat = *this;
-    mat(0,0) = m00;
-    mat(0,1) = m01;
-    mat(0,2) = m02;
-    mat(1,0) = m10;
-    mat(1,1) = m11;
-    mat(1,2) = m12;
-    mat(2,0) = m20;
-    mat(2,1) = m21;
-    mat(2,2) = m22;
-}
-
-inline const integer& Matrix_3x3i::operator()(const size_t row,
-                                               const size_t col) const {
-    return elements_[(col*3)+row];
+inline Matrix_2x2i Adjugate(const Matrix_2x2i& mat) {
+    return Matrix_2x2i( mat(1,1), -mat(0,1),
+                       -mat(1,0),  mat(0,0));
 }
 
-inline integer& Matrix_3x3i::operator()(const size_t row, const size_t col) {
-    return elements_[(col*3)+row];
+//! @brief 1/det = det for det = +-1, so no division is needed.
+inline Matrix_2x2i Inverse(const Matrix_2x2i& mat) {
+    integer det = Determinant(mat);
+    if (det != 1 && det != -1) {
+        NotUnimodular("Inverse(Matrix_2x2i)");
+    }
+    return Adjugate(mat)*det;
 }
 
-inline bool operator==(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs) {
-    return lhs.elements() == rhs.elements();
+template <size_t N, typename std::enable_if<(N > 3), int>::type>
+inline integer Determinant(const Mat<integer, N, N>& mat) {
+    return ModularDeterminant(mat.elements().data(), N);
 }
 
-inline bool operator!=(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs) {
-    return lhs.elements() != rhs.elements();
+template <size_t N, typename std::enable_if<(N > 3), int>::type>
+inline rational Determinant(const Mat<rational, N, N>& mat) {
+    return BareissDeterminant(mat.elements().data(), N);
 }
 
-inline Vector_3i RowVec(const Matrix_3x3i& mat, const int row) {
-    return Vector_3i(mat(row,0), mat(row,1), mat(row,2));
+template <size_t N, typename std::enable_if<(N > 3), int>::type>
+inline Sign SignOfDeterminant(const Mat<integer, N, N>& mat) {
+    return ModularSignOfDeterminant(mat.elements().data(), N);
 }
 
-inline Vector_3i ColVec(const Matrix_3x3i& mat, const int col) {
-    return Vector_3i(mat(0,col), mat(1,col), mat(2,col));
+template <size_t N, typename std::enable_if<(N > 3), int>::type>
+inline Sign SignOfDeterminant(const Mat<rational, N, N>& mat) {
+    return BareissSignOfDeterminant(mat.elements().data(), N);
 }
 
-inline Matrix_3x3i operator*(const Matrix_3x3i& lhs, const Matrix_3x3i& rhs) {
-    auto row0 = RowVec(lhs, 0);
-    auto row1 = RowVec(lhs, 1);
-    auto row2 = RowVec(lhs, 2);
-    auto col0 = ColVec(rhs, 0);
-    auto col1 = ColVec(rhs, 1);
-    auto col2 = ColVec(rhs, 2);
-    return Matrix_3x3i(Dot(row0, col0), Dot(row0, col1), Dot(row0, col2),
-                       Dot(row1, col0), Dot(row1, col1), Dot(row1, col2),
-                       Dot(row2, col0), Dot(row2, col1), Dot(row2, col2));
+template <class T, size_t R, size_t C>
+inline int Rank(const Mat<T, R, C>& mat) {
+    return BareissRank(mat.elements().data(), R, C);
 }
 
-inline std::ostream& operator<<(std::ostream& o, const Matrix_3x3i& mat) {
-    return o << to_string(mat);
+template <size_t N>
+inline bool Solve(const Mat<integer, N, N>& mat, const Vec<integer, N>& rhs,
+                  Vec<rational, N>& x) {
+    std::array<integer, N> numerators;
+    integer denominator;
+    if (!BareissSolve(mat.elements().data(), rhs.elements().data(), N,
+                      numerators.data(), denominator)) {
+        return false;
+    }
+    std::array<rational, N> elements;
+    for (size_t i = 0; i < N; ++i) {
+        elements[i] = rational(numerators[i], denominator);
+        elements[i].canonicalize();
+    }
+    x = Vec<rational, N>(std::move(elements));
+    return true;
 }
 
-inline std::string to_string(const Matrix_3x3i& mat) {
-    std::stringstream result;
-    result << "[" << mat(0,0) << " " << mat(0,1) << " " << mat(0,2) << "]\n"
-           << "[" << mat(1,0) << " " << mat(1,1) << " " << mat(1,2) << "]\n"
-           << "[" << mat(2,0) << " " << mat(2,1) << " " << mat(2,2) << "]";
-    return result.str();
+template <size_t N>
+inline bool Solve(const Mat<rational, N, N>& mat, const Vec<rational, N>& rhs,
+                  Vec<rational, N>& x) {
+    std::array<rational, N> elements;
+    if (!BareissSolve(mat.elements().data(), rhs.elements().data(), N,
+                      elements.data())) {
+        return false;
+    }
+    x = Vec<rational, N>(std::move(elements));
+    return true;
 }
 
 // Accessors/Mutators =========================================================
 
-inline const std::array<integer, 9>& Matrix_3x3i::elements() const {
+template <class T, size_t R, size_t C>
+inline const std::array<T, R*C>& Mat<T, R, C>::elements() const {
     return elements_;
 }
 
 //=============================================================================
-// Implementation: Mixed Matrix_3x3i arithmetic
+// Implementation: Mixed Mat arithmetic
 //=============================================================================
 
-inline Point_3i operator*(const Point_3i& p, const Matrix_3x3i& mat) {
-    return Point_3i(Dot(ColVec(mat, 0), p),
-                    Dot(ColVec(mat, 1), p),
-                    Dot(ColVec(mat, 2), p));
-}
-
-inline Point_3i operator*(const Matrix_3x3i& mat, const Point_3i& p) {
-    return Point_3i(Dot(RowVec(mat, 0), p),
-                    Dot(RowVec(mat, 1), p),
-                    Dot(RowVec(mat, 2), p));
-}
-
-inline Vector_3i operator*(const Vector_3i& v, const Matrix_3x3i& mat) {
-    return Vector_3i(Dot(ColVec(mat, 0), v),
-                     Dot(ColVec(mat, 1), v),
-                     Dot(ColVec(mat, 2), v));
-}
-
-inline Vector_3i operator*(const Matrix_3x3i& mat, const Vector_3i& v) {
-    return Vector_3i(Dot(RowVec(mat, 0), v),
-                     Dot(RowVec(mat, 1), v),
-                     Dot(RowVec(mat, 2), v));
+//! @brief Accumulates each entry in place rather than copying out row and
+//! column vectors.
+template <class T, size_t R, size_t K, size_t C>
+inline Mat<T, R, C> operator*(const Mat<T, R, K>& lhs,
+                              const Mat<T, K, C>& rhs) {
+    Mat<T, R, C> product;
+    for (size_t row = 0; row < R; ++row) {
+        for (size_t col = 0; col < C; ++col) {
+            T& entry = product(row,col);
+            entry = lhs(row,0)*rhs(0,col);
+            for (size_t k = 1; k < K; ++k) {
+                entry += lhs(row,k)*rhs(k,col);
+            }
+        }
+    }
+    return product;
+}
+
+//! @brief Row vector times matrix; binds mat without a copy unless it has to
+//! be widened.
+template <class T, class U, size_t R, size_t C, typename std::enable_if<
+    IsWidening<U, T>::value, int>::type>
+inline Point<T, C> operator*(const Point<T, R>& p, const Mat<U, R, C>& mat) {
+    const Mat<T, R, C>& m = mat;
+    std::array<T, C> elements;
+    for (size_t col = 0; col < C; ++col) {
+        T& entry = elements[col];
+        entry = p[0]*m(0,col);
+        for (size_t row = 1; row < R; ++row) {
+            entry += p[row]*m(row,col);
+        }
+    }
+    return Point<T, C>(std::move(elements));
+}
+
+template <class T, class U, size_t R, size_t C, typename std::enable_if<
+    IsWidening<U, T>::value, int>::type>
+inline Point<T, R> operator*(const Mat<U, R, C>& mat, const Point<T, C>& p) {
+    const Mat<T, R, C>& m = mat;
+    std::array<T, R> elements;
+    for (size_t row = 0; row < R; ++row) {
+        T& entry = elements[row];
+        entry = m(row,0)*p[0];
+        for (size_t col = 1; col < C; ++col) {
+            entry += m(row,col)*p[col];
+        }
+    }
+    return Point<T, R>(std::move(elements));
+}
+
+template <class T, class U, size_t R, size_t C, typename std::enable_if<
+    IsWidening<U, T>::value, int>::type>
+inline Vec<T, C> operator*(const Vec<T, R>& v, const Mat<U, R, C>& mat) {
+    const Mat<T, R, C>& m = mat;
+    std::array<T, C> elements;
+    for (size_t col = 0; col < C; ++col) {
+        T& entry = elements[col];
+        entry = v[0]*m(0,col);
+        for (size_t row = 1; row < R; ++row) {
+            entry += v[row]*m(row,col);
+        }
+    }
+    return Vec<T, C>(std::move(elements));
+}
+
+template <class T, class U, size_t R, size_t C, typename std::enable_if<
+    IsWidening<U, T>::value, int>::type>
+inline Vec<T, R> operator*(const Mat<U, R, C>& mat, const Vec<T, C>& v) {
+    const Mat<T, R, C>& m = mat;
+    std::array<T, R> elements;
+    for (size_t row = 0; row < R; ++row) {
+        T& entry = elements[row];
+        entry = m(row,0)*v[0];
+        for (size_t col = 1; col < C; ++col) {
+            entry += m(row,col)*v[col];
+        }
+    }
+    return Vec<T, R>(std::move(elements));
 }
 
 //=============================================================================
-// Interface: Matrix_3x3r
+// Interface: Matrix_NxNi
 //=============================================================================
 
-class Matrix_3x3r {
+/*!
+ * @brief Square integer matrix whose dimension is chosen at run time, for
+ * determinants beyond 3x3 such as lifted in-sphere or lattice tests.
+ */
+class Matrix_NxNi {
 public:
-    Matrix_3x3r();
-    Matrix_3x3r(const rational& m00, const rational& m01, const rational& m02,
-                const rational& m10, const rational& m11, const rational& m12,
-                const rational& m20, const rational& m21, const rational& m22);
-    Matrix_3x3r(const Matrix_3x3i& imat);
+    explicit Matrix_NxNi(const size_t n);
+    Matrix_NxNi(const Matrix_3x3i& mat);
 
-    const rational& operator()(const size_t row, const size_t col) const;
-    rational& operator()(const size_t row, const size_t col);
-    const std::array<rational, 9>& elements() const;
+    const integer& operator()(const size_t row, const size_t col) const;
+    integer& operator()(const size_t row, const size_t col);
+    size_t size() const;
+    const std::vector<integer>& elements() const;
 
 private:
-    std::array<rational, 9> elements_;
+    size_t n_;
+    std::vector<integer> elements_;
 };
 
-bool operator==(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-bool operator!=(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-std::ostream& operator<<(std::ostream& o, const Matrix_3x3r& mat);
-
-Vector_3r RowVec(const Matrix_3x3r& mat, const int row);
-Vector_3r ColVec(const Matrix_3x3r& mat, const int col);
+bool operator==(const Matrix_NxNi& lhs, const Matrix_NxNi& rhs);
+bool operator!=(const Matrix_NxNi& lhs, const Matrix_NxNi& rhs);
+std::ostream& operator<<(std::ostream& o, const Matrix_NxNi& mat);
 
-rational Determinant(const Matrix_3x3r& mat);
-Matrix_3x3r Inverse(const Matrix_3x3r& mat);
-//Matrix_3x3r Transpose(const Matrix_3x3r& mat);
-std::string to_string(const Matrix_3x3r& mat);
-
-/*
-bool operator==(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-bool operator!=(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-Matrix_3x3r operator+(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-Matrix_3x3r operator-(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-Matrix_3x3r operator-(const Matrix_3x3r& mat);
-Matrix_3x3r operator*(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-Matrix_3x3r operator*(const Matrix_3x3r& lhs, const rational& rhs);
-Matrix_3x3r operator/(const Matrix_3x3r& lhs, const rational& rhs);
-Matrix_3x3r& operator+=(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-Matrix_3x3r& operator-=(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-Matrix_3x3r& operator*=(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-Matrix_3x3r& operator*=(const Matrix_3x3r& lhs, const rational& rhs);
-Matrix_3x3r& operator/=(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs);
-Matrix_3x3r& operator/=(const Matrix_3x3r& lhs, const rational& rhs);
-*/
-
-//=============================================================================
-// Interface: Mixed Matrix_3x3r arithmetic
-//=============================================================================
-
-Point_3r operator*(const Point_3r& lhs, const Matrix_3x3r& rhs);
-Vector_3r operator*(const Vector_3r& lhs, const Matrix_3x3r& rhs);
+//! @brief Multi-modular, see modular.h.
+integer Determinant(const Matrix_NxNi& mat);
+Sign SignOfDeterminant(const Matrix_NxNi& mat);
+std::string to_string(const Matrix_NxNi& mat);
 
 //=============================================================================
-// Implementation: Matrix_3x3r
+// Implementation: Matrix_NxNi
 //=============================================================================
 
-inline Matrix_3x3r::Matrix_3x3r() {
-    Matrix_3x3r& mat = *this;
-    mat(0,0) = 1;
-    mat(0,1) = 0;
-    mat(0,2) = 0;
-    mat(1,0) = 0;
-    mat(1,1) = 1;
-    mat(1,2) = 0;
-    mat(2,0) = 0;
-    mat(2,1) = 0;
-    mat(2,2) = 1;
-}
-
-inline Matrix_3x3r::Matrix_3x3r(const rational& m00, const rational& m01,
-                                const rational& m02, const rational& m10,
-                                const rational& m11, const rational& m12,
-                                const rational& m20, const rational& m21,
-                                const rational& m22) {
-    Matrix_3x3r& mat = *this;
-    mat(0,0) = m00; mat(0,0).canonicalize();
-    mat(0,1) = m01; mat(0,1).canonicalize();
-    mat(0,2) = m02; mat(0,2).canonicalize();
-    mat(1,0) = m10; mat(1,0).canonicalize();
-    mat(1,1) = m11; mat(1,1).canonicalize();
-    mat(1,2) = m12; mat(1,2).canonicalize();
-    mat(2,0) = m20; mat(2,0).canonicalize();
-    mat(2,1) = m21; mat(2,1).canonicalize();
-    mat(2,2) = m22; mat(2,2).canonicalize();
-}
-
-inline Matrix_3x3r::Matrix_3x3r(const Matrix_3x3i& imat) {
-    Matrix_3x3r& mat = *this;
-    mat(0,0) = imat(0,0);
-    mat(0,1) = imat(0,1);
-    mat(0,2) = imat(0,2);
-    mat(1,0) = imat(1,0);
-    mat(1,1) = imat(1,1);
-    mat(1,2) = imat(1,2);
-    mat(2,0) = imat(2,0);
-    mat(2,1) = imat(2,1);
-    mat(2,2) = imat(2,2);
-}
-
-inline const rational& Matrix_3x3r::operator()(const size_t row,
-                                               const size_t col) const {
-    return elements_[(col*3)+row];
-}
-
-inline rational& Matrix_3x3r::operator()(const size_t row, const size_t col) {
-    return elements_[(col*3)+row];
+//! @brief The n x n identity.
+inline Matrix_NxNi::Matrix_NxNi(const size_t n) :
+    n_(n),
+    elements_(n*n, integer(0)) {
+    Matrix_NxNi& mat = *this;
+    for (size_t i = 0; i < n; ++i) {
+        mat(i,i) = 1;
+    }
 }
 
-inline bool operator==(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs) {
-    return lhs.elements() == rhs.elements();
-}
+inline Matrix_NxNi::Matrix_NxNi(const Matrix_3x3i& imat) :
+    n_(3),
+    elements_(imat.elements().begin(), imat.elements().end()) {}
 
-inline bool operator!=(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs) {
-    return lhs.elements() != rhs.elements();
+inline const integer& Matrix_NxNi::operator()(const size_t row,
+                                               const size_t col) const {
+    return elements_[(col*n_)+row];
 }
 
-inline Vector_3r RowVec(const Matrix_3x3r& mat, const int row) {
-    return Vector_3r(mat(row,0), mat(row,1), mat(row,2));
+inline integer& Matrix_NxNi::operator()(const size_t row, const size_t col) {
+    return elements_[(col*n_)+row];
 }
 
-inline Vector_3r ColVec(const Matrix_3x3r& mat, const int col) {
-    return Vector_3r(mat(0,col), mat(1,col), mat(2,col));
+inline bool operator==(const Matrix_NxNi& lhs, const Matrix_NxNi& rhs) {
+    return lhs.size() == rhs.size() && lhs.elements() == rhs.elements();
 }
 
-inline Matrix_3x3r operator*(const Matrix_3x3r& lhs, const Matrix_3x3r& rhs) {
-    auto row0 = RowVec(lhs, 0);
-    auto row1 = RowVec(lhs, 1);
-    auto row2 = RowVec(lhs, 2);
-    auto col0 = ColVec(rhs, 0);
-    auto col1 = ColVec(rhs, 1);
-    auto col2 = ColVec(rhs, 2);
-    return Matrix_3x3r(Dot(row0, col0), Dot(row0, col1), Dot(row0, col2),
-                       Dot(row1, col0), Dot(row1, col1), Dot(row1, col2),
-                       Dot(row2, col0), Dot(row2, col1), Dot(row2, col2));
+inline bool operator!=(const Matrix_NxNi& lhs, const Matrix_NxNi& rhs) {
+    return !(lhs == rhs);
 }
 
-inline std::ostream& operator<<(std::ostream& o, const Matrix_3x3r& mat) {
+inline std::ostream& operator<<(std::ostream& o, const Matrix_NxNi& mat) {
     return o << to_string(mat);
 }
 
-inline std::string to_string(const Matrix_3x3r& mat) {
+inline std::string to_string(const Matrix_NxNi& mat) {
     std::stringstream result;
-    result << "[" << mat(0,0) << " " << mat(0,1) << " " << mat(0,2) << "]\n"
-           << "[" << mat(1,0) << " " << mat(1,1) << " " << mat(1,2) << "]\n"
-           << "[" << mat(2,0) << " " << mat(2,1) << " " << mat(2,2) << "]";
+    for (size_t i = 0; i < mat.size(); ++i) {
+        result << (i > 0 ? "\n[" : "[");
+        for (size_t j = 0; j < mat.size(); ++j) {
+            result << (j > 0 ? " " : "") << mat(i,j);
+        }
+        result << "]";
+    }
     return result.str();
 }
 
 // Accessors/Mutators =========================================================
 
-inline const std::array<rational, 9>& Matrix_3x3r::elements() const {
-    return elements_;
-}
-
-//=============================================================================
-// Implementation: Mixed Matrix_3x3r arithmetic
-//=============================================================================
-
-inline Point_3r operator*(const Point_3r& p, const Matrix_3x3r& mat) {
-    return Point_3r(Dot(ColVec(mat, 0), p),
-                    Dot(ColVec(mat, 1), p),
-                    Dot(ColVec(mat, 2), p));
+inline size_t Matrix_NxNi::size() const {
+    return n_;
 }
 
-inline Vector_3r operator*(const Vector_3r& v, const Matrix_3x3r& mat) {
-    return Vector_3r(Dot(ColVec(mat, 0), v),
-                     Dot(ColVec(mat, 1), v),
-                     Dot(ColVec(mat, 2), v));
+inline const std::vector<integer>& Matrix_NxNi::elements() const {
+    return elements_;
 }
 
 } // namespace DDAD
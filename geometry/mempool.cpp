@@ -0,0 +1,443 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "mempool.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace DDAD {
+
+//=============================================================================
+// Implementation: ArithmeticPool
+//=============================================================================
+
+// Blocks come in power-of-two size classes from 16 bytes to 4 KiB, which
+// covers integers up to 32k bits. Larger requests go to the system allocator.
+// Slabs are aligned to their size, so the slab of a block is found by masking
+// its address.
+static const size_t kMinBlockBytes = 16;
+static const size_t kMaxBlockBytes = 4096;
+static const int kSizeClassCount = 9;
+static const size_t kSlabBytes = 256*1024;
+
+// Open-addressed table of the slabs of all arenas; 16k slabs are 4 GiB.
+static const size_t kSlabTableSize = 16*1024;
+static const uintptr_t kEmptySlot = 0;
+static const uintptr_t kDeletedSlot = 1;
+
+// Added to remote_balance while the owning thread holds the arena, so the
+// balance can only reach zero once the owner has let go of it.
+static const int64_t kOwnerBias = int64_t(1) << 62;
+
+typedef void* (*AllocFunc)(size_t);
+typedef void* (*ReallocFunc)(void*, size_t, size_t);
+typedef void (*FreeFunc)(void*, size_t);
+
+static AllocFunc s_prev_alloc = nullptr;
+static ReallocFunc s_prev_realloc = nullptr;
+static FreeFunc s_prev_free = nullptr;
+
+/*!
+ * @brief Pool of one thread. Only the owning thread touches the free lists,
+ * the bump region, the slabs and the counters. Other threads push the blocks
+ * they free onto remote_frees, a lock-free stack the owner drains into its
+ * free lists on its next allocation; the size class of a pushed block is
+ * stored in its second word.
+ *
+ * remote_balance is kOwnerBias plus the number of blocks pushed minus the
+ * number drained. When its thread exits, the arena subtracts the bias and
+ * its live blocks, and whoever brings the balance to zero destroys it.
+ */
+struct Arena {
+    void* free_lists[kSizeClassCount];
+    char* cursor;
+    char* limit;
+    std::vector<char*> slabs;
+    int64_t live_blocks;
+    std::atomic<void*> remote_frees;
+    std::atomic<int64_t> remote_balance;
+    ArithmeticPoolStats stats;
+};
+
+struct SlabSlot {
+    std::atomic<uintptr_t> begin;
+    std::atomic<Arena*> arena;
+};
+
+/*!
+ * @brief Owner of every slab, looked up without locking on each free. Slots
+ * are only written under s_slab_mutex. Zero-initialized and trivially
+ * destructible, since MPIR may free memory during static destruction.
+ */
+static SlabSlot s_slab_table[kSlabTableSize];
+
+static std::mutex& slab_mutex() {
+    static std::mutex* m = new std::mutex;
+    return *m;
+}
+
+static std::atomic<int> s_arena_count(0);
+static thread_local Arena* s_arena = nullptr;
+static thread_local int s_scope_depth = 0;
+
+static int SizeClass(size_t bytes) {
+    int k = 0;
+    size_t capacity = kMinBlockBytes;
+    while (capacity < bytes) {
+        capacity <<= 1;
+        ++k;
+    }
+    return k;
+}
+
+static size_t ClassBytes(const int k) {
+    return kMinBlockBytes << k;
+}
+
+static size_t SlabHash(const uintptr_t begin) {
+    return static_cast<size_t>((begin/kSlabBytes)*2654435761u) &
+           (kSlabTableSize-1);
+}
+
+static char* AllocateSlabMemory() {
+#ifdef _WIN32
+    return static_cast<char*>(_aligned_malloc(kSlabBytes, kSlabBytes));
+#else
+    void* begin = nullptr;
+    if (posix_memalign(&begin, kSlabBytes, kSlabBytes) != 0) {
+        return nullptr;
+    }
+    return static_cast<char*>(begin);
+#endif
+}
+
+static void FreeSlabMemory(char* begin) {
+#ifdef _WIN32
+    _aligned_free(begin);
+#else
+    std::free(begin);
+#endif
+}
+
+//! @brief Caller holds the slab mutex. False if the table is full.
+static bool InsertSlab(char* begin, Arena* arena) {
+    uintptr_t key = reinterpret_cast<uintptr_t>(begin);
+    size_t i = SlabHash(key);
+    for (size_t probes = 0; probes < kSlabTableSize; ++probes) {
+        uintptr_t current = s_slab_table[i].begin.load(
+            std::memory_order_relaxed);
+        if (current == kEmptySlot || current == kDeletedSlot) {
+            s_slab_table[i].arena.store(arena, std::memory_order_relaxed);
+            s_slab_table[i].begin.store(key, std::memory_order_release);
+            return true;
+        }
+        i = (i+1) & (kSlabTableSize-1);
+    }
+    return false;
+}
+
+//! @brief Caller holds the slab mutex.
+static void EraseSlab(char* begin) {
+    uintptr_t key = reinterpret_cast<uintptr_t>(begin);
+    size_t i = SlabHash(key);
+    while (s_slab_table[i].begin.load(std::memory_order_relaxed) != key) {
+        i = (i+1) & (kSlabTableSize-1);
+    }
+    s_slab_table[i].begin.store(kDeletedSlot, std::memory_order_release);
+    s_slab_table[i].arena.store(nullptr, std::memory_order_relaxed);
+}
+
+//! @brief Arena whose slab holds ptr, or null if ptr is not pooled.
+static Arena* SlabOwner(const void* ptr) {
+    if (s_arena_count.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+    uintptr_t key = reinterpret_cast<uintptr_t>(ptr) & ~(kSlabBytes-1);
+    size_t i = SlabHash(key);
+    for (size_t probes = 0; probes < kSlabTableSize; ++probes) {
+        uintptr_t current = s_slab_table[i].begin.load(
+            std::memory_order_acquire);
+        if (current == key) {
+            return s_slab_table[i].arena.load(std::memory_order_relaxed);
+        }
+        if (current == kEmptySlot) {
+            return nullptr;
+        }
+        i = (i+1) & (kSlabTableSize-1);
+    }
+    return nullptr;
+}
+
+static void DestroyArena(Arena* arena) {
+    {
+        std::lock_guard<std::mutex> lock(slab_mutex());
+        for (char* slab : arena->slabs) {
+            EraseSlab(slab);
+        }
+    }
+    for (char* slab : arena->slabs) {
+        FreeSlabMemory(slab);
+    }
+    s_arena_count.fetch_sub(1);
+    delete arena;
+}
+
+static void PoolFreeLocal(Arena& arena, void* ptr, const int k) {
+    *static_cast<void**>(ptr) = arena.free_lists[k];
+    arena.free_lists[k] = ptr;
+    --arena.live_blocks;
+    arena.stats.bytes_in_use -= ClassBytes(k);
+}
+
+//! @brief Moves the blocks other threads have freed onto the free lists.
+static void DrainRemoteFrees(Arena& arena) {
+    void* block = arena.remote_frees.exchange(nullptr,
+                                              std::memory_order_acquire);
+    int64_t drained = 0;
+    while (block) {
+        void** words = static_cast<void**>(block);
+        void* next = words[0];
+        PoolFreeLocal(arena, block,
+                      static_cast<int>(reinterpret_cast<uintptr_t>(words[1])));
+        block = next;
+        ++drained;
+    }
+    arena.remote_balance.fetch_sub(drained, std::memory_order_relaxed);
+}
+
+/*!
+ * @brief Lets go of the arena of the calling thread, which is destroyed now
+ * if none of its blocks are held by other threads and otherwise by the
+ * thread that frees the last of them.
+ */
+static void OrphanArena(Arena* arena) {
+    DrainRemoteFrees(*arena);
+    int64_t debt = kOwnerBias+arena->live_blocks;
+    if (arena->remote_balance.fetch_sub(debt, std::memory_order_acq_rel) ==
+        debt) {
+        DestroyArena(arena);
+    }
+}
+
+//! @brief Retires the arena of a thread when it exits.
+struct ArenaGuard {
+    ~ArenaGuard() {
+        Arena* arena = s_arena;
+        if (!arena) {
+            return;
+        }
+        s_arena = nullptr;
+        OrphanArena(arena);
+    }
+};
+
+static Arena& LocalArena() {
+    if (!s_arena) {
+        static thread_local ArenaGuard guard;
+        (void)guard;
+        Arena* arena = new Arena;
+        std::fill(arena->free_lists, arena->free_lists+kSizeClassCount,
+                  nullptr);
+        arena->cursor = nullptr;
+        arena->limit = nullptr;
+        arena->live_blocks = 0;
+        arena->remote_frees.store(nullptr);
+        arena->remote_balance.store(kOwnerBias);
+        std::memset(&arena->stats, 0, sizeof(arena->stats));
+        s_arena_count.fetch_add(1);
+        s_arena = arena;
+    }
+    return *s_arena;
+}
+
+static bool AddSlab(Arena& arena) {
+    char* begin = AllocateSlabMemory();
+    if (!begin) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(slab_mutex());
+        if (!InsertSlab(begin, &arena)) {
+            FreeSlabMemory(begin);
+            return false;
+        }
+    }
+    arena.slabs.push_back(begin);
+    arena.cursor = begin;
+    arena.limit = begin+kSlabBytes;
+    arena.stats.slab_bytes += kSlabBytes;
+    return true;
+}
+
+static bool Pooled(const size_t bytes) {
+    return s_scope_depth > 0 && bytes > 0 && bytes <= kMaxBlockBytes;
+}
+
+static void* PoolAlloc(const size_t bytes) {
+    Arena& arena = LocalArena();
+    if (arena.remote_frees.load(std::memory_order_relaxed)) {
+        DrainRemoteFrees(arena);
+    }
+    int k = SizeClass(bytes);
+    size_t capacity = ClassBytes(k);
+    void* block = arena.free_lists[k];
+    if (block) {
+        arena.free_lists[k] = *static_cast<void**>(block);
+        ++arena.stats.recycled_allocations;
+    } else {
+        if ((!arena.cursor || arena.cursor+capacity > arena.limit) &&
+            !AddSlab(arena)) {
+            ++arena.stats.system_allocations;
+            return s_prev_alloc(bytes);
+        }
+        block = arena.cursor;
+        arena.cursor += capacity;
+    }
+    ++arena.live_blocks;
+    ++arena.stats.pooled_allocations;
+    arena.stats.bytes_in_use += capacity;
+    arena.stats.peak_bytes = std::max(arena.stats.peak_bytes,
+                                      arena.stats.bytes_in_use);
+    return block;
+}
+
+//! @brief Hands a block back to the arena of another thread.
+static void PoolFreeRemote(Arena& owner, void* ptr, const size_t bytes) {
+    void** words = static_cast<void**>(ptr);
+    words[1] = reinterpret_cast<void*>(
+        static_cast<uintptr_t>(SizeClass(bytes)));
+    void* head = owner.remote_frees.load(std::memory_order_relaxed);
+    do {
+        words[0] = head;
+    } while (!owner.remote_frees.compare_exchange_weak(
+                 head, ptr, std::memory_order_release,
+                 std::memory_order_relaxed));
+    if (owner.remote_balance.fetch_add(1, std::memory_order_acq_rel) == -1) {
+        DestroyArena(&owner);
+    }
+}
+
+static void* Allocate(size_t bytes) {
+    if (Pooled(bytes)) {
+        return PoolAlloc(bytes);
+    }
+    if (s_scope_depth > 0) {
+        ++LocalArena().stats.system_allocations;
+    }
+    return s_prev_alloc(bytes);
+}
+
+static void Free(void* ptr, size_t bytes) {
+    if (!ptr) {
+        return;
+    }
+    Arena* owner = SlabOwner(ptr);
+    if (!owner) {
+        s_prev_free(ptr, bytes);
+    } else if (owner == s_arena) {
+        PoolFreeLocal(*owner, ptr, SizeClass(bytes));
+    } else {
+        PoolFreeRemote(*owner, ptr, bytes);
+    }
+}
+
+static void* Reallocate(void* ptr, size_t old_bytes, size_t new_bytes) {
+    if (!ptr) {
+        return Allocate(new_bytes);
+    }
+    Arena* owner = SlabOwner(ptr);
+    if (owner && owner == s_arena && Pooled(new_bytes) &&
+        SizeClass(old_bytes) == SizeClass(new_bytes)) {
+        return ptr;
+    }
+    if (!owner && !Pooled(new_bytes)) {
+        return s_prev_realloc(ptr, old_bytes, new_bytes);
+    }
+    void* result = Allocate(new_bytes);
+    std::memcpy(result, ptr, std::min(old_bytes, new_bytes));
+    Free(ptr, old_bytes);
+    return result;
+}
+
+void InstallArithmeticPool() {
+    static std::once_flag installed;
+    std::call_once(installed, []() {
+        mp_get_memory_functions(&s_prev_alloc, &s_prev_realloc, &s_prev_free);
+        mp_set_memory_functions(Allocate, Reallocate, Free);
+    });
+}
+
+bool arithmetic_pool_active() {
+    return s_scope_depth > 0;
+}
+
+ArithmeticPoolStats arithmetic_pool_stats() {
+    ArithmeticPoolStats stats;
+    if (s_arena) {
+        stats = s_arena->stats;
+    } else {
+        std::memset(&stats, 0, sizeof(stats));
+    }
+    return stats;
+}
+
+void ResetArithmeticPoolStats() {
+    if (!s_arena) {
+        return;
+    }
+    ArithmeticPoolStats& stats = s_arena->stats;
+    stats.peak_bytes = stats.bytes_in_use;
+    stats.pooled_allocations = 0;
+    stats.recycled_allocations = 0;
+    stats.system_allocations = 0;
+}
+
+bool ReleaseArithmeticPool() {
+    if (!s_arena) {
+        return true;
+    }
+    if (s_scope_depth > 0) {
+        return false;
+    }
+    DrainRemoteFrees(*s_arena);
+    if (s_arena->live_blocks != 0) {
+        return false;
+    }
+    // Every block is back, but a thread that pushed one may not have counted
+    // it yet.
+    while (s_arena->remote_balance.load(std::memory_order_acquire) !=
+           kOwnerBias) {
+        std::this_thread::yield();
+    }
+    DestroyArena(s_arena);
+    s_arena = nullptr;
+    return true;
+}
+
+ArithmeticPoolScope::ArithmeticPoolScope() {
+    InstallArithmeticPool();
+    ++s_scope_depth;
+}
+
+ArithmeticPoolScope::~ArithmeticPoolScope() {
+    --s_scope_depth;
+}
+
+} // namespace DDAD
@@ -0,0 +1,94 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Thread-local size-class pools for the limbs of integer and rational
+ * temporaries.
+ *
+ * Installing the pool replaces the MPIR memory functions once for the whole
+ * process. Requests are only served from the pool on threads inside an
+ * ArithmeticPoolScope; everywhere else they are forwarded to the allocator
+ * that was installed before. Blocks can be freed from any thread, which
+ * hands them back to the pool they came from, and blocks obtained from the
+ * system allocator can be freed inside a scope, so values may freely outlive
+ * the scope that created them.
+ */
+
+#ifndef GE_MEMPOOL_H
+#define GE_MEMPOOL_H
+
+#include "common.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Interface: ArithmeticPool
+//=============================================================================
+
+/*!
+ * @brief Counters for the pool of the calling thread.
+ *
+ * \c pooled_allocations is the number of requests that did not reach the
+ * system allocator; \c recycled_allocations of those were served from a
+ * free list rather than carved from a fresh slab. Byte counts are in units of
+ * size-class blocks. Blocks freed by another thread are subtracted from
+ * \c bytes_in_use once the owning thread next allocates from its pool.
+ */
+struct ArithmeticPoolStats {
+    uint64_t bytes_in_use;
+    uint64_t peak_bytes;
+    uint64_t pooled_allocations;
+    uint64_t recycled_allocations;
+    uint64_t system_allocations;
+    uint64_t slab_bytes;
+};
+
+/*!
+ * @brief Serves MPIR allocations on the calling thread from its pool for the
+ * lifetime of the object. Scopes nest. The first scope in the process
+ * installs the pool, which should happen before other threads start doing
+ * integer arithmetic.
+ */
+class ArithmeticPoolScope {
+public:
+    ArithmeticPoolScope();
+    ~ArithmeticPoolScope();
+
+private:
+    ArithmeticPoolScope(const ArithmeticPoolScope&);
+    ArithmeticPoolScope& operator=(const ArithmeticPoolScope&);
+};
+
+//! @brief Installs the MPIR memory functions. Idempotent.
+void InstallArithmeticPool();
+
+//! @brief True if the calling thread is inside an ArithmeticPoolScope.
+bool arithmetic_pool_active();
+
+ArithmeticPoolStats arithmetic_pool_stats();
+
+//! @brief Zeroes the counters of the calling thread; peak restarts at the
+//! current usage.
+void ResetArithmeticPoolStats();
+
+/*!
+ * @brief Returns the slabs of the calling thread to the system. Fails, and
+ * keeps the pool, while a scope is active or a pooled block is still live.
+ */
+bool ReleaseArithmeticPool();
+
+} // namespace DDAD
+
+#endif // GE_MEMPOOL_H
@@ -0,0 +1,419 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "modular.h"
+#include "bareiss.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Implementation: Floating-point filter
+//=============================================================================
+
+// epsilon = 2^-53; mpz_get_d truncates, so conversions cost two epsilons.
+static const double kEpsilon = 1.1102230246251565e-16;
+static const int kFilterMaxDimension = 5;
+static const int kFilterMaxBits = 1000;
+
+/*!
+ * @brief Determinant and permanent of rows [row, n) restricted to the
+ * columns set in columns, by cofactor expansion along the first row.
+ */
+static void LaplaceExpansion(const double* a, const int n, const int row,
+                             const unsigned columns, double& det,
+                             double& permanent) {
+    if (row == n-1) {
+        int c = 0;
+        while (!(columns & (1u << c))) {
+            ++c;
+        }
+        det = a[row*n+c];
+        permanent = std::fabs(det);
+        return;
+    }
+    det = 0.0;
+    permanent = 0.0;
+    double sign = 1.0;
+    for (int c = 0; c < n; ++c) {
+        if (!(columns & (1u << c))) {
+            continue;
+        }
+        double minor, minor_permanent;
+        LaplaceExpansion(a, n, row+1, columns & ~(1u << c), minor,
+                         minor_permanent);
+        det += sign*a[row*n+c]*minor;
+        permanent += std::fabs(a[row*n+c])*minor_permanent;
+        sign = -sign;
+    }
+}
+
+/*!
+ * @brief Decides the sign in double precision if the rounding error, at most
+ * one epsilon per operation along the deepest chain times the permanent,
+ * cannot flip it. An m x m expansion adds m additions and one product to the
+ * chain of its minors.
+ */
+static bool FilteredSign(const integer* entries, const int n, Sign& sign) {
+    if (n > kFilterMaxDimension) {
+        return false;
+    }
+    double a[kFilterMaxDimension*kFilterMaxDimension];
+    for (int i = 0; i < n*n; ++i) {
+        mpz_srcptr z = entries[i].get_mpz_t();
+        if (mpz_sizeinbase(z, 2) > static_cast<size_t>(kFilterMaxBits)) {
+            return false;
+        }
+        a[i] = mpz_get_d(z);
+    }
+
+    double det, permanent;
+    LaplaceExpansion(a, n, 0, (1u << n)-1, det, permanent);
+    if (!std::isfinite(permanent)) {
+        return false;
+    }
+    if (permanent == 0.0) {
+        // every term of the expansion has a zero factor
+        sign = SIGN_ZERO;
+        return true;
+    }
+
+    int chain = 2;
+    for (int m = 2; m <= n; ++m) {
+        chain += m+1;
+    }
+    double errbound = 2.0*chain*kEpsilon*permanent;
+    if (det > errbound) {
+        sign = SIGN_POSITIVE;
+        return true;
+    } else if (-det > errbound) {
+        sign = SIGN_NEGATIVE;
+        return true;
+    }
+    return false;
+}
+
+//=============================================================================
+// Implementation: Exact fallback
+//=============================================================================
+
+/*!
+ * @brief Hadamard's bound: b with |det| < 2^b, or -1 if a row vanishes and
+ * the determinant is zero. |x| < 2^k for every entry x of a row bounds its
+ * Euclidean norm by sqrt(n)*2^k.
+ */
+static int DeterminantBitBound(const integer* entries, const int n) {
+    int bits = 0;
+    for (int i = 0; i < n; ++i) {
+        int row_bits = 0;
+        for (int j = 0; j < n; ++j) {
+            mpz_srcptr z = entries[i*n+j].get_mpz_t();
+            if (mpz_sgn(z) != 0) {
+                row_bits = std::max(row_bits, static_cast<int>(
+                    mpz_sizeinbase(z, 2)));
+            }
+        }
+        if (row_bits == 0) {
+            return -1;
+        }
+        bits += row_bits;
+    }
+    int log2n = 0;
+    while ((1 << log2n) < n) {
+        ++log2n;
+    }
+    return bits+(n*log2n+1)/2;
+}
+
+//=============================================================================
+// Implementation: Residue arithmetic
+//=============================================================================
+
+#if DDAD_HAS_INT128
+
+typedef unsigned __int128 uint128_t;
+
+// The largest primes below 2^62. Products of two residues stay below 2^124,
+// so Montgomery reduction with R = 2^64 never overflows 128 bits. Each prime
+// exceeds 2^61, so k of them make a modulus of more than 61k bits.
+static const int kPrimeCount = 32;
+static const int kBitsPerPrime = 61;
+static const uint64_t kPrimes[kPrimeCount] = {
+    4611686018427387847ULL, 4611686018427387817ULL, 4611686018427387787ULL,
+    4611686018427387761ULL, 4611686018427387751ULL, 4611686018427387737ULL,
+    4611686018427387733ULL, 4611686018427387709ULL, 4611686018427387701ULL,
+    4611686018427387631ULL, 4611686018427387617ULL, 4611686018427387587ULL,
+    4611686018427387461ULL, 4611686018427387421ULL, 4611686018427387409ULL,
+    4611686018427387329ULL, 4611686018427387323ULL, 4611686018427387301ULL,
+    4611686018427387271ULL, 4611686018427387241ULL, 4611686018427387139ULL,
+    4611686018427387131ULL, 4611686018427387127ULL, 4611686018427387113ULL,
+    4611686018427387091ULL, 4611686018427387073ULL, 4611686018427386981ULL,
+    4611686018427386923ULL, 4611686018427386911ULL, 4611686018427386903ULL,
+    4611686018427386897ULL, 4611686018427386887ULL
+};
+
+//! @brief Montgomery constants of one prime. Residues in Montgomery form
+//! represent x as x*R mod p.
+struct Modulus {
+    uint64_t p;
+    uint64_t neg_inv; // -p^-1 mod R
+    uint64_t one;     // R mod p
+    uint64_t r2;      // R^2 mod p
+    uint64_t radix;   // 2^GMP_NUMB_BITS in Montgomery form
+};
+
+//! @brief t/R mod p for t < p*R.
+static inline uint64_t Redc(const Modulus& m, const uint128_t t) {
+    uint64_t q = static_cast<uint64_t>(t)*m.neg_inv;
+    uint64_t u = static_cast<uint64_t>((t+static_cast<uint128_t>(q)*m.p) >> 64);
+    return u >= m.p ? u-m.p : u;
+}
+
+static inline uint64_t MontMul(const Modulus& m, const uint64_t a,
+                               const uint64_t b) {
+    return Redc(m, static_cast<uint128_t>(a)*b);
+}
+
+//! @brief Montgomery form of any 64-bit x.
+static inline uint64_t ToMont(const Modulus& m, const uint64_t x) {
+    return MontMul(m, x, m.r2);
+}
+
+static inline uint64_t FromMont(const Modulus& m, const uint64_t x) {
+    return Redc(m, x);
+}
+
+static inline uint64_t AddMod(const Modulus& m, const uint64_t a,
+                              const uint64_t b) {
+    uint64_t s = a+b;
+    return s >= m.p ? s-m.p : s;
+}
+
+static inline uint64_t SubMod(const Modulus& m, const uint64_t a,
+                              const uint64_t b) {
+    return a >= b ? a-b : a+m.p-b;
+}
+
+//! @brief a^-1 mod p for 0 < a < p < 2^63, by the extended Euclidean
+//! algorithm.
+static uint64_t InverseMod(const uint64_t a, const uint64_t p) {
+    int64_t t = 0, new_t = 1;
+    uint64_t r = p, new_r = a;
+    while (new_r != 0) {
+        uint64_t q = r/new_r;
+        int64_t next_t = t-static_cast<int64_t>(q)*new_t;
+        t = new_t;
+        new_t = next_t;
+        uint64_t next_r = r-q*new_r;
+        r = new_r;
+        new_r = next_r;
+    }
+    return t < 0 ? static_cast<uint64_t>(t+static_cast<int64_t>(p))
+                 : static_cast<uint64_t>(t);
+}
+
+struct ModularTables {
+    Modulus moduli[kPrimeCount];
+    //! @brief garner[i][j] = p_j^-1 mod p_i in Montgomery form, for j < i.
+    uint64_t garner[kPrimeCount][kPrimeCount];
+
+    ModularTables() {
+        for (int i = 0; i < kPrimeCount; ++i) {
+            Modulus& m = moduli[i];
+            m.p = kPrimes[i];
+            // p*p = 1 mod 8; each Newton step doubles the correct bits
+            uint64_t inv = m.p;
+            for (int k = 0; k < 5; ++k) {
+                inv *= 2-m.p*inv;
+            }
+            m.neg_inv = 0-inv;
+            m.one = static_cast<uint64_t>((static_cast<uint128_t>(1) << 64) %
+                                          m.p);
+            m.r2 = static_cast<uint64_t>(static_cast<uint128_t>(m.one)*m.one %
+                                         m.p);
+            m.radix = ToMont(m, static_cast<uint64_t>(
+                (static_cast<uint128_t>(1) << GMP_NUMB_BITS) % m.p));
+            for (int j = 0; j < i; ++j) {
+                garner[i][j] = ToMont(m, InverseMod(kPrimes[j] % m.p, m.p));
+            }
+        }
+    }
+};
+
+static const ModularTables& modular_tables() {
+    static const ModularTables tables;
+    return tables;
+}
+
+static int PrimesFor(const int bits) {
+    // the modulus must exceed 2|det| to tell negative residues apart
+    return (bits+1+kBitsPerPrime-1)/kBitsPerPrime;
+}
+
+//! @brief x mod p in Montgomery form, by Horner's rule over the limbs of x.
+static uint64_t Reduce(const Modulus& m, const integer& x) {
+    mpz_srcptr z = x.get_mpz_t();
+    uint64_t r = 0;
+    for (size_t i = mpz_size(z); i-- > 0; ) {
+        r = AddMod(m, MontMul(m, r, m.radix), ToMont(m, mpz_getlimbn(z, i)));
+    }
+    return mpz_sgn(z) < 0 && r != 0 ? m.p-r : r;
+}
+
+//! @brief Determinant of the residues in a, in Montgomery form; destroys a.
+static uint64_t DeterminantModP(const Modulus& m, uint64_t* a, const int n) {
+    uint64_t det = m.one;
+    for (int k = 0; k < n; ++k) {
+        int pivot = k;
+        while (pivot < n && a[pivot*n+k] == 0) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            return 0;
+        }
+        if (pivot != k) {
+            std::swap_ranges(a+k*n, a+(k+1)*n, a+pivot*n);
+            det = m.p-det;
+        }
+        det = MontMul(m, det, a[k*n+k]);
+        uint64_t inverse = ToMont(m, InverseMod(FromMont(m, a[k*n+k]), m.p));
+        for (int i = k+1; i < n; ++i) {
+            if (a[i*n+k] == 0) {
+                continue;
+            }
+            uint64_t factor = MontMul(m, a[i*n+k], inverse);
+            for (int j = k+1; j < n; ++j) {
+                a[i*n+j] = SubMod(m, a[i*n+j], MontMul(m, factor, a[k*n+j]));
+            }
+        }
+    }
+    return det;
+}
+
+/*!
+ * @brief Mixed radix digits of the determinant modulo the first k primes,
+ * det = d_0 + d_1*p_0 + d_2*p_0*p_1 + ... with 0 <= d_i < p_i.
+ */
+static void ModularDigits(const integer* entries, const int n, const int k,
+                          uint64_t* digits) {
+    const ModularTables& tables = modular_tables();
+    uint64_t stack[kModularStackDimension*kModularStackDimension];
+    std::vector<uint64_t> heap;
+    uint64_t* work = stack;
+    if (n > kModularStackDimension) {
+        heap.resize(n*n);
+        work = heap.data();
+    }
+
+    for (int i = 0; i < k; ++i) {
+        const Modulus& m = tables.moduli[i];
+        for (int e = 0; e < n*n; ++e) {
+            work[e] = Reduce(m, entries[e]);
+        }
+        uint64_t residue = DeterminantModP(m, work, n);
+        for (int j = 0; j < i; ++j) {
+            residue = MontMul(m, SubMod(m, residue, ToMont(m, digits[j])),
+                              tables.garner[i][j]);
+        }
+        digits[i] = FromMont(m, residue);
+    }
+}
+
+/*!
+ * @brief Sign of the symmetric residue. With M the product of the primes,
+ * the residue x in [0, M) stands for x if x <= (M-1)/2 and x-M otherwise.
+ * The digits of (M-1)/2 are all (p_i-1)/2, and mixed radix numbers compare
+ * lexicographically from the top digit.
+ */
+static Sign SignOfDigits(const uint64_t* digits, const int k) {
+    if (std::all_of(digits, digits+k, [](uint64_t d) { return d == 0; })) {
+        return SIGN_ZERO;
+    }
+    for (int i = k-1; i >= 0; --i) {
+        uint64_t half = kPrimes[i]/2;
+        if (digits[i] != half) {
+            return digits[i] < half ? SIGN_POSITIVE : SIGN_NEGATIVE;
+        }
+    }
+    return SIGN_POSITIVE;
+}
+
+static void SetUint64(integer& x, const uint64_t value) {
+    mpz_import(x.get_mpz_t(), 1, -1, sizeof(value), 0, 0, &value);
+}
+
+#endif // DDAD_HAS_INT128
+
+//=============================================================================
+// Implementation: Modular determinants
+//=============================================================================
+
+Sign ModularSignOfDeterminant(const integer* entries, const int n) {
+    if (n <= 0) {
+        return SIGN_POSITIVE;
+    }
+    Sign sign;
+    if (FilteredSign(entries, n, sign)) {
+        return sign;
+    }
+    int bits = DeterminantBitBound(entries, n);
+    if (bits < 0) {
+        return SIGN_ZERO;
+    }
+#if DDAD_HAS_INT128
+    int k = PrimesFor(bits);
+    if (k <= kPrimeCount) {
+        uint64_t digits[kPrimeCount];
+        ModularDigits(entries, n, k, digits);
+        return SignOfDigits(digits, k);
+    }
+#endif
+    DDAD_PROFILE_SITE("ModularSignOfDeterminant (Bareiss)");
+    return BareissSignOfDeterminant(entries, n);
+}
+
+integer ModularDeterminant(const integer* entries, const int n) {
+    if (n <= 0) {
+        return integer(1);
+    }
+    int bits = DeterminantBitBound(entries, n);
+    if (bits < 0) {
+        return integer(0);
+    }
+#if DDAD_HAS_INT128
+    int k = PrimesFor(bits);
+    if (k <= kPrimeCount) {
+        uint64_t digits[kPrimeCount];
+        ModularDigits(entries, n, k, digits);
+
+        integer det(0), modulus(1), p, digit;
+        for (int i = k-1; i >= 0; --i) {
+            SetUint64(p, kPrimes[i]);
+            SetUint64(digit, digits[i]);
+            det *= p;
+            det += digit;
+            modulus *= p;
+        }
+        if (SignOfDigits(digits, k) == SIGN_NEGATIVE) {
+            det -= modulus;
+        }
+        return det;
+    }
+#endif
+    DDAD_PROFILE_SITE("ModularDeterminant (Bareiss)");
+    return BareissDeterminant(entries, n);
+}
+
+} // namespace DDAD
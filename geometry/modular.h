@@ -0,0 +1,53 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Integer determinants by multi-modular arithmetic.
+ *
+ * The sign is first estimated in double precision, and returned if a forward
+ * error bound certifies it. Otherwise the determinant is computed modulo as
+ * many 62-bit primes as the Hadamard bound requires, each by Gaussian
+ * elimination in Montgomery form, and the residues are combined into mixed
+ * radix digits (Garner's algorithm). The sign is read off the digits without
+ * reconstructing the determinant, so apart from reading the entries no GMP
+ * arithmetic and, up to kModularStackDimension, no allocation takes place.
+ *
+ * Entries may be given in row- or column-major order, since the determinant
+ * of the transpose is the same. Without 128-bit integers, or when the
+ * Hadamard bound exceeds the prime table, both functions fall back to
+ * fraction-free elimination, see bareiss.h.
+ */
+
+#ifndef GE_MODULAR_H
+#define GE_MODULAR_H
+
+#include "common.h"
+#include "arithmetic.h"
+
+namespace DDAD {
+
+//! @brief Largest dimension whose residues are kept on the stack.
+static const int kModularStackDimension = 6;
+
+//! @brief Sign of the determinant of the n x n matrix in entries.
+Sign ModularSignOfDeterminant(const integer* entries, const int n);
+
+//! @brief Determinant of the n x n matrix in entries, reconstructed from its
+//! residues by the Chinese remainder theorem.
+integer ModularDeterminant(const integer* entries, const int n);
+
+} // namespace DDAD
+
+#endif // GE_MODULAR_H
@@ -1,28 +1,84 @@
 /*
- * This file is part of RationalCAD.
+ * This file is part of DDAD.
  *
- * RationalCAD is free software: you can redistribute it and/or modify it under
+ * DDAD is free software: you can redistribute it and/or modify it under
  * the terms of the GNU General Public License as published by the Free
  * Software Foundation, either version 3 of the License, or (at your option)
  * any later version.
  *
- * RationalCAD is distributed in the hope that it will be useful, but WITHOUT
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
  * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
  * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
  * more details. You should have received a copy of the GNU General Public
- * License along with RationalCAD. If not, see <http://www.gnu.org/licenses/>.
- */
-
-/*!
- * @author Clinton Freeman <freeman@cs.unc.edu>
- * @date 2013-07-20
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
  */
 
 #include "common.h"
 #include "observer.h"
 
-namespace RCAD {
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace DDAD {
+
+//=============================================================================
+// Implementation: Point observer registry
+//=============================================================================
+
+//! @brief Never destroyed, since points may notify during static destruction.
+struct ObserverRegistry {
+    std::mutex mutex;
+    std::unordered_map<uint32_t, std::vector<IPointObserver*>> observers;
+};
+
+//! @brief Number of points with observers, readable without the mutex.
+static std::atomic<size_t> s_observed_points(0);
+
+static ObserverRegistry& observer_registry() {
+    static ObserverRegistry* r = new ObserverRegistry;
+    return *r;
+}
+
+void AddPointObserver(const uint32_t unique_id, IPointObserver* o) {
+    if (unique_id == 0 || !o) {
+        return;
+    }
+    ObserverRegistry& r = observer_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto& observers = r.observers[unique_id];
+    if (observers.empty()) {
+        ++s_observed_points;
+    }
+    observers.push_back(o);
+}
+
+void RemovePointObserver(const uint32_t unique_id, IPointObserver* o) {
+    ObserverRegistry& r = observer_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = r.observers.find(unique_id);
+    if (it == r.observers.end()) {
+        return;
+    }
+    auto& observers = it->second;
+    observers.erase(std::remove(begin(observers), end(observers), o),
+                    end(observers));
+    if (observers.empty()) {
+        r.observers.erase(it);
+        --s_observed_points;
+    }
+}
 
+bool point_observers_attached() {
+    return s_observed_points.load(std::memory_order_relaxed) > 0;
+}
 
+std::vector<IPointObserver*> PointObservers(const uint32_t unique_id) {
+    ObserverRegistry& r = observer_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = r.observers.find(unique_id);
+    return it == r.observers.end() ? std::vector<IPointObserver*>()
+                                   : it->second;
+}
 
-} // namespace RCAD
+} // namespace DDAD
@@ -1,33 +1,70 @@
 /*
- * This file is part of RationalCAD.
+ * This file is part of DDAD.
  *
- * RationalCAD is free software: you can redistribute it and/or modify it under
+ * DDAD is free software: you can redistribute it and/or modify it under
  * the terms of the GNU General Public License as published by the Free
  * Software Foundation, either version 3 of the License, or (at your option)
  * any later version.
  *
- * RationalCAD is distributed in the hope that it will be useful, but WITHOUT
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
  * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
  * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
  * more details. You should have received a copy of the GNU General Public
- * License along with RationalCAD. If not, see <http://www.gnu.org/licenses/>.
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
  */
 
 /*!
- * @author Clinton Freeman <freeman@cs.unc.edu>
- * @date 07/17/2013
+ * @brief Side table of point observers, keyed by unique id.
+ *
+ * Points carry no observer state of their own; Point_2r::AddObserver and
+ * friends forward here. Only points the visualization has registered, i.e.
+ * given a nonzero unique id, can be observed, and copies of a point share
+ * its observers since they share its id. While nothing is attached,
+ * notification costs a single atomic load.
  */
 
-#ifndef KL_OBSERVER_H
-#define KL_OBSERVER_H
+#ifndef GE_OBSERVER_H
+#define GE_OBSERVER_H
 
 #include "common.h"
+#include "arithmetic.h"
+
+namespace DDAD {
+
+template <class T, size_t N> class Point;
+typedef Point<rational, 2> Point_2r;
+typedef Point<rational, 3> Point_3r;
+
+struct IPointObserver {
+    virtual void SlotPositionChanged_2r(const Point_2r& p) = 0;
+    virtual void SlotPositionChanged_3r(const Point_3r& p) = 0;
 
+    //! @brief Dispatches on dimension, for Point<T, N>::SigPositionChanged.
+    void SlotPositionChanged(const Point_2r& p) {
+        SlotPositionChanged_2r(p);
+    }
+    void SlotPositionChanged(const Point_3r& p) {
+        SlotPositionChanged_3r(p);
+    }
+};
 
-namespace RCAD {
+//=============================================================================
+// Interface: Point observer registry
+//=============================================================================
 
+//! @brief Ignored for unique_id 0, which marks unregistered points.
+void AddPointObserver(const uint32_t unique_id, IPointObserver* o);
+void RemovePointObserver(const uint32_t unique_id, IPointObserver* o);
 
+//! @brief True if any point has an observer.
+bool point_observers_attached();
+
+/*!
+ * @brief Observers of the point with the given unique id, copied so that
+ * they may add or remove observers while being notified.
+ */
+std::vector<IPointObserver*> PointObservers(const uint32_t unique_id);
 
-}
+} // namespace DDAD
 
-#endif // KL_OBSERVER_H
+#endif // GE_OBSERVER_H
@@ -14,23 +14,32 @@
  */
 
 /*!
- * @brief Integer, floating-point, and rational point types for 2D and 3D.
+ * @brief Points parameterized on number type and dimension. The integer,
+ * floating-point, and rational 2D and 3D points are aliases of Point<T, N>.
  */
 
 #ifndef GE_POINT_H
 #define GE_POINT_H
 
+#include <type_traits>
+
 #include "common.h"
 #include "arithmetic.h"
+#include "observer.h"
 
 namespace DDAD {
 
-class Point_2i;
-class Point_2f;
-class Point_2r;
-class Point_3i;
-class Point_3f;
-class Point_3r;
+template <class T, size_t N> class Point;
+template <class T, size_t N> class Vec;
+
+typedef Point<integer, 2> Point_2i;
+typedef Point<float, 2> Point_2f;
+typedef Point<rational, 2> Point_2r;
+typedef Point<integer, 3> Point_3i;
+typedef Point<float, 3> Point_3f;
+typedef Point<rational, 3> Point_3r;
+//! @brief Grid points in machine integers, see IntegerKernel_2.
+typedef Point<int64_t, 2> Point_2l;
 
 typedef std::shared_ptr<Point_2i> SharedPoint_2i;
 typedef std::shared_ptr<Point_2f> SharedPoint_2f;
@@ -39,362 +48,238 @@ typedef std::shared_ptr<Point_3i> SharedPoint_3i;
 typedef std::shared_ptr<Point_3f> SharedPoint_3f;
 typedef std::shared_ptr<Point_3r> SharedPoint_3r;
 
-struct IPointObserver {
-    virtual void SlotPositionChanged_2r(const Point_2r& p) = 0;
-    virtual void SlotPositionChanged_3r(const Point_3r& p) = 0;
-};
-
 //=============================================================================
-// Interface: Point_2i
+// Interface: IsWidening
 //=============================================================================
 
-class Point_2i {
-public:
-    Point_2i();
-    Point_2i(const Point_2i& p);
-    Point_2i(const integer& x, const integer& y);
-
-    Point_2i& operator=(const Point_2i& rhs);
-    const integer& operator[](const size_t i) const;
-
-    const integer& x() const;
-    const integer& y() const;
-    const std::array<integer, 2>& elements() const;
-    const uint32_t unique_id() const;
-    void set_x(const integer& x);
-    void set_y(const integer& y);
-    void set_elements(const std::array<integer, 2>& elements);
-    void set_unique_id(const uint32_t unique_id);
-
-private:
-    std::array<integer, 2> elements_;
-    uint32_t unique_id_;
-};
-
-bool operator==(const Point_2i& lhs, const Point_2i& rhs);
-bool operator!=(const Point_2i& lhs, const Point_2i& rhs);
-std::ostream& operator<<(std::ostream& o, const Point_2i& p);
-std::string to_string(const Point_2i& p);
-
-//=============================================================================
-// Interface: Point_2f
-//=============================================================================
-
-class Point_2f {
-public:
-    Point_2f();
-    Point_2f(const Point_2f& p);
-    Point_2f(const float x, const float y);
-
-    Point_2f& operator=(const Point_2f& rhs);
-    const float operator[](const size_t i) const;
-
-    const float x() const;
-    const float y() const;
-    const std::array<float, 2>& elements() const;
-    const uint32_t unique_id() const;
-    void set_x(const float x);
-    void set_y(const float y);
-    void set_elements(const std::array<float, 2>& elements);
-    void set_unique_id(const uint32_t unique_id);
+/*!
+ * @brief True if every From is exactly representable as a To. Points,
+ * vectors, and matrices convert implicitly only along such conversions.
+ */
+template <class From, class To>
+struct IsWidening : std::is_same<From, To> {};
 
-private:
-    std::array<float, 2> elements_;
-    uint32_t unique_id_;
-};
+template <>
+struct IsWidening<integer, rational> : std::true_type {};
 
-bool operator==(const Point_2f& lhs, const Point_2f& rhs);
-bool operator!=(const Point_2f& lhs, const Point_2f& rhs);
-std::ostream& operator<<(std::ostream& o, const Point_2f& p);
-std::string to_string(const Point_2f& v);
+template <>
+struct IsWidening<float, rational> : std::true_type {};
 
 //=============================================================================
-// Interface: Point_2r
+// Interface: Point
 //=============================================================================
 
-class Point_2r {
+/*!
+ * @brief Point with N coordinates of type T.
+ *
+ * Operators are friends defined in the class, so that, like the functions
+ * of a concrete type, they accept arguments that convert to it.
+ */
+template <class T, size_t N>
+class Point {
 public:
-    Point_2r();
-    Point_2r(const Point_2r& p);
-    Point_2r(const Point_2i& p);
-    Point_2r(const Point_2f& p);
-    Point_2r(const rational& x, const rational& y);
+    typedef T Scalar;
+
+    constexpr Point();
+    constexpr Point(const T& x, const T& y);
+    constexpr Point(const T& x, const T& y, const T& z);
+    constexpr Point(T&& x, T&& y);
+    constexpr Point(T&& x, T&& y, T&& z);
+    explicit Point(const std::array<T, N>& elements);
+    explicit Point(std::array<T, N>&& elements);
+    template <class U, size_t M, typename std::enable_if<
+        (M == N && IsWidening<U, T>::value) ||
+        (M+1 == N && std::is_same<U, T>::value), int>::type = 0>
+    Point(const Point<U, M>& p);
 
     void AddObserver(IPointObserver* o);
     void RemoveObserver(IPointObserver* o);
     void SigPositionChanged() const;
 
-    Point_2r& operator=(const Point_2r& rhs);
-    const rational& operator[](const size_t i) const;
+    const T& operator[](const size_t i) const;
 
-    const rational& x() const;
-    const rational& y() const;
-    const std::array<rational, 2>& elements() const;
+    const T& x() const;
+    const T& y() const;
+    const T& z() const;
+    const std::array<T, N>& elements() const;
     const uint32_t unique_id() const;
-    void set_x(const rational& x);
-    void set_y(const rational& y);
-    void set_elements(const std::array<rational, 2>& elements);
+    void set_x(const T& x);
+    void set_x(T&& x);
+    void set_y(const T& y);
+    void set_y(T&& y);
+    void set_z(const T& z);
+    void set_z(T&& z);
+    void set_elements(const std::array<T, N>& elements);
     void set_unique_id(const uint32_t unique_id);
 
-private:
-    std::array<rational, 2> elements_;
-    std::vector<IPointObserver*> observers_;
-    uint32_t unique_id_;
-};
-
-bool operator==(const Point_2r& lhs, const Point_2r& rhs);
-bool operator!=(const Point_2r& lhs, const Point_2r& rhs);
-std::ostream& operator<<(std::ostream& o, const Point_2r& p);
-std::string to_string(const Point_2r& p);
-
-namespace Construction {
-Point_2r Z2Neighbor(const Point_2r& p, Quadrant quad);
-}
-
-//=============================================================================
-// Implementation: Point_2i
-//=============================================================================
-
-inline Point_2i::Point_2i() {
-    set_x(0);
-    set_y(0);
-    set_unique_id(0);
-}
+    //! @brief Sequentially calls operator== element-wise.
+    friend bool operator==(const Point& lhs, const Point& rhs) {
+        return lhs.elements_ == rhs.elements_;
+    }
 
-inline Point_2i::Point_2i(const Point_2i& p) {
-    *this = p;
-}
+    //! @brief Sequentially calls operator!= element-wise.
+    friend bool operator!=(const Point& lhs, const Point& rhs) {
+        return lhs.elements_ != rhs.elements_;
+    }
 
-inline Point_2i::Point_2i(const integer& x, const integer& y) {
-    set_x(x);
-    set_y(y);
-    set_unique_id(0);
-}
+    friend std::ostream& operator<<(std::ostream& o, const Point& p) {
+        return o << to_string(p);
+    }
 
-inline Point_2i& Point_2i::operator=(const Point_2i& rhs) {
-    set_x(rhs.x());
-    set_y(rhs.y());
-    set_unique_id(rhs.unique_id());
-    return *this;
-}
+    //! @brief Represents this point using parentheses (x, y[, z]).
+    friend std::string to_string(const Point& p) {
+        std::stringstream ss;
+        ss << "(" << p.elements_[0];
+        for (size_t i = 1; i < N; ++i) {
+            ss << ", " << p.elements_[i];
+        }
+        ss << ")";
+        return ss.str();
+    }
 
-//! @brief Index-based access operator without elegant out-of-bounds handling.
-inline const integer& Point_2i::operator[](const size_t i) const {
-    assert(i < 2);
-    return elements_[i];
-}
+    //! @brief Point - Point = Vector
+    friend Vec<T, N> operator-(const Point& lhs, const Point& rhs) {
+        std::array<T, N> elements;
+        for (size_t i = 0; i < N; ++i) {
+            elements[i] = lhs.elements_[i]-rhs.elements_[i];
+        }
+        return Vec<T, N>(std::move(elements));
+    }
 
-//! @brief Sequentially calls operator== element-wise.
-inline bool operator==(const Point_2i& lhs, const Point_2i& rhs) {
-    return lhs.elements() == rhs.elements();
-}
+    friend Point& operator+=(Point& lhs, const Vec<T, N>& rhs) {
+        for (size_t i = 0; i < N; ++i) {
+            lhs.elements_[i] += rhs[i];
+        }
+        return lhs;
+    }
 
-//! @brief Sequentially calls operator!= element-wise.
-inline bool operator!=(const Point_2i& lhs, const Point_2i& rhs) {
-    return lhs.elements() != rhs.elements();
-}
+    friend Point& operator-=(Point& lhs, const Vec<T, N>& rhs) {
+        for (size_t i = 0; i < N; ++i) {
+            lhs.elements_[i] -= rhs[i];
+        }
+        return lhs;
+    }
 
-inline std::ostream& operator<<(std::ostream& o, const Point_2i& p) {
-    return o << to_string(p);
-}
+    //! @brief Point + Vector = Point
+    friend Point operator+(const Point& lhs, const Vec<T, N>& rhs) {
+        Point p(lhs.elements_);
+        p += rhs;
+        return p;
+    }
 
-//! @brief Represents this point using parentheses (x, y).
-inline std::string to_string(const Point_2i& p) {
-    std::stringstream ss;
-    ss << "(" << p.x() << ", " << p.y() << ")";
-    return ss.str();
-}
+    //! @brief Point - Vector = Point
+    friend Point operator-(const Point& lhs, const Vec<T, N>& rhs) {
+        Point p(lhs.elements_);
+        p -= rhs;
+        return p;
+    }
 
-// Accessors/Mutators =========================================================
+private:
+    std::array<T, N> elements_;
+    uint32_t unique_id_;
+};
 
-inline const integer& Point_2i::x() const {
-    return elements_[0];
-}
-inline const integer& Point_2i::y() const {
-    return elements_[1];
-}
-inline const std::array<integer, 2>& Point_2i::elements() const {
-    return elements_;
-}
-inline const uint32_t Point_2i::unique_id() const {
-    return unique_id_;
-}
-inline void Point_2i::set_x(const integer& x) {
-    elements_[0] = x;
-}
-inline void Point_2i::set_y(const integer& y) {
-    elements_[1] = y;
-}
-inline void Point_2i::set_elements(const std::array<integer, 2>& elements) {
-    elements_ = elements;
-}
-inline void Point_2i::set_unique_id(const uint32_t unique_id) {
-    unique_id_ = unique_id;
+namespace Construction {
+Point_2r Z2Neighbor(const Point_2r& p, Quadrant quad);
 }
 
 //=============================================================================
-// Implementation: Point_2f
+// Implementation: Point
 //=============================================================================
 
-inline Point_2f::Point_2f() {
-    set_x(0);
-    set_y(0);
-    set_unique_id(0);
-}
+//! @brief Sets all elements and unique id to zero.
+template <class T, size_t N>
+inline constexpr Point<T, N>::Point() :
+    elements_(),
+    unique_id_(0) {}
 
-inline Point_2f::Point_2f(const Point_2f& p) {
-    *this = p;
+template <class T, size_t N>
+inline constexpr Point<T, N>::Point(const T& x, const T& y) :
+    elements_{{x, y}},
+    unique_id_(0) {
+    static_assert(N == 2, "Point: two coordinates for a non-2D point");
 }
 
-inline Point_2f::Point_2f(const float x, const float y) {
-    set_x(x);
-    set_y(y);
-    set_unique_id(0);
+template <class T, size_t N>
+inline constexpr Point<T, N>::Point(const T& x, const T& y, const T& z) :
+    elements_{{x, y, z}},
+    unique_id_(0) {
+    static_assert(N == 3, "Point: three coordinates for a non-3D point");
 }
 
-inline Point_2f& Point_2f::operator=(const Point_2f& rhs) {
-    set_x(rhs.x());
-    set_y(rhs.y());
-    set_unique_id(rhs.unique_id());
-    return *this;
+//! @brief static_cast rather than std::move, which is not constexpr in
+//! C++11.
+template <class T, size_t N>
+inline constexpr Point<T, N>::Point(T&& x, T&& y) :
+    elements_{{static_cast<T&&>(x), static_cast<T&&>(y)}},
+    unique_id_(0) {
+    static_assert(N == 2, "Point: two coordinates for a non-2D point");
 }
 
-//! @brief Index-based access operator without elegant out-of-bounds handling.
-inline const float Point_2f::operator[](const size_t i) const {
-    assert(i < 2);
-    return elements_[i];
+template <class T, size_t N>
+inline constexpr Point<T, N>::Point(T&& x, T&& y, T&& z) :
+    elements_{{static_cast<T&&>(x), static_cast<T&&>(y),
+                static_cast<T&&>(z)}},
+    unique_id_(0) {
+    static_assert(N == 3, "Point: three coordinates for a non-3D point");
 }
 
-//! @brief Sequentially calls operator== element-wise.
-inline bool operator==(const Point_2f& lhs, const Point_2f& rhs) {
-    return lhs.elements() == rhs.elements();
-}
+template <class T, size_t N>
+inline Point<T, N>::Point(const std::array<T, N>& elements) :
+    elements_(elements),
+    unique_id_(0) {}
 
-//! @brief Sequentially calls operator!= element-wise.
-inline bool operator!=(const Point_2f& lhs, const Point_2f& rhs) {
-    return lhs.elements() != rhs.elements();
-}
+template <class T, size_t N>
+inline Point<T, N>::Point(std::array<T, N>&& elements) :
+    elements_(std::move(elements)),
+    unique_id_(0) {}
 
-inline std::ostream& operator<<(std::ostream& o, const Point_2f& p) {
-    return o << to_string(p);
-}
-
-//! @brief Represents this point using parentheses (x, y).
-inline std::string to_string(const Point_2f& p) {
-    std::stringstream ss;
-    ss << "(" << p.x() << ", " << p.y() << ")";
-    return ss.str();
-}
-
-// Accessors/Mutators =========================================================
-
-inline const float Point_2f::x() const {
-    return elements_[0];
-}
-inline const float Point_2f::y() const {
-    return elements_[1];
-}
-inline const std::array<float, 2>& Point_2f::elements() const {
-    return elements_;
-}
-inline const uint32_t Point_2f::unique_id() const {
-    return unique_id_;
-}
-inline void Point_2f::set_x(const float x) {
-    elements_[0] = x;
-}
-inline void Point_2f::set_y(const float y) {
-    elements_[1] = y;
-}
-inline void Point_2f::set_elements(const std::array<float, 2>& elements) {
-    elements_ = elements;
-}
-inline void Point_2f::set_unique_id(const uint32_t unique_id) {
-    unique_id_ = unique_id;
-}
-
-//=============================================================================
-// Implementation: Point_2r
-//=============================================================================
-
-inline Point_2r::Point_2r() {
-    set_x(0);
-    set_y(0);
-    set_unique_id(0);
-}
-
-inline Point_2r::Point_2r(const Point_2r& p) {
-    *this = p;
-}
-
-//! @brief Allow implicit conversion from integer point.
-inline Point_2r::Point_2r(const Point_2i& p) {
-    set_x(p.x());
-    set_y(p.y());
-    set_unique_id(p.unique_id());
-}
-
-//! @brief Allow implicit conversion from float point.
-inline Point_2r::Point_2r(const Point_2f& p) {
-    set_x(p.x());
-    set_y(p.y());
-    set_unique_id(p.unique_id());
-}
-
-inline Point_2r::Point_2r(const rational& x, const rational& y) {
-    set_x(x);
-    set_y(y);
-    set_unique_id(0);
+/*!
+ * @brief Allow implicit conversion from a point of narrower type, e.g.
+ * Point_2i to Point_2r, or from a point one dimension lower, which is placed
+ * at z = 0. The unique id is kept.
+ */
+template <class T, size_t N>
+template <class U, size_t M, typename std::enable_if<
+    (M == N && IsWidening<U, T>::value) ||
+    (M+1 == N && std::is_same<U, T>::value), int>::type>
+inline Point<T, N>::Point(const Point<U, M>& p) :
+    elements_(),
+    unique_id_(p.unique_id()) {
+    for (size_t i = 0; i < M; ++i) {
+        elements_[i] = p.elements()[i];
+    }
 }
 
-inline void Point_2r::AddObserver(IPointObserver* o) {
-    observers_.push_back(o);
+//! @brief The point must have a nonzero unique id, see observer.h.
+template <class T, size_t N>
+inline void Point<T, N>::AddObserver(IPointObserver* o) {
+    AddPointObserver(unique_id(), o);
 }
 
-inline void Point_2r::RemoveObserver(IPointObserver* o) {
-    std::remove(begin(observers_), end(observers_), o);
+template <class T, size_t N>
+inline void Point<T, N>::RemoveObserver(IPointObserver* o) {
+    RemovePointObserver(unique_id(), o);
 }
 
-inline void Point_2r::SigPositionChanged() const {
-    for(auto i = begin(observers_); i != end(observers_); ++i) {
-        (*i)->SlotPositionChanged_2r(*this);
+//! @brief Only rational points can be observed.
+template <class T, size_t N>
+inline void Point<T, N>::SigPositionChanged() const {
+    if (!point_observers_attached() || !unique_id()) {
+        return;
+    }
+    for (auto o : PointObservers(unique_id())) {
+        o->SlotPositionChanged(*this);
     }
-}
-
-inline Point_2r& Point_2r::operator=(const Point_2r& rhs) {
-    set_x(rhs.x());
-    set_y(rhs.y());
-    set_unique_id(rhs.unique_id());
-    return *this;
 }
 
 //! @brief Index-based access operator without elegant out-of-bounds handling.
-inline const rational& Point_2r::operator[](const size_t i) const {
-    assert(i < 2);
+template <class T, size_t N>
+inline const T& Point<T, N>::operator[](const size_t i) const {
+    assert(i < N);
     return elements_[i];
 }
 
-//! @brief Sequentially calls operator== element-wise.
-inline bool operator==(const Point_2r& lhs, const Point_2r& rhs) {
-    return lhs.elements() == rhs.elements();
-}
-
-//! @brief Sequentially calls operator!= element-wise.
-inline bool operator!=(const Point_2r& lhs, const Point_2r& rhs) {
-    return lhs.elements() != rhs.elements();
-}
-
-inline std::ostream& operator<<(std::ostream& o, const Point_2r& p) {
-    return o << to_string(p);
-}
-
-//! @brief Represents this point using parentheses (x, y).
-inline std::string to_string(const Point_2r& p) {
-    std::stringstream ss;
-    ss << "(" << p.x() << ", " << p.y() << ")";
-    return ss.str();
-}
-
 // Constructions ==============================================================
 
 inline Point_2r Construction::Z2Neighbor(const Point_2r& p, Quadrant quad) {
@@ -409,465 +294,59 @@ inline Point_2r Construction::Z2Neighbor(const Point_2r& p, Quadrant quad) {
 
 // Accessors/Mutators =========================================================
 
-inline const rational& Point_2r::x() const {
-    return elements_[0];
-}
-inline const rational& Point_2r::y() const {
-    return elements_[1];
-}
-inline const std::array<rational, 2>& Point_2r::elements() const {
-    return elements_;
-}
-inline const uint32_t Point_2r::unique_id() const {
-    return unique_id_;
-}
-inline void Point_2r::set_x(const rational& x) {
-    elements_[0] = x;
-}
-inline void Point_2r::set_y(const rational& y) {
-    elements_[1] = y;
-}
-inline void Point_2r::set_elements(const std::array<rational, 2>& elements) {
-    elements_ = elements;
-}
-inline void Point_2r::set_unique_id(const uint32_t unique_id) {
-    unique_id_ = unique_id;
-}
-
-//=============================================================================
-// Interface: Point_3i
-//=============================================================================
-
-class Point_3i {
-public:
-    Point_3i();
-    Point_3i(const Point_3i& p);
-    Point_3i(const Point_2i& p);
-    Point_3i(const integer& x, const integer& y, const integer& z);
-
-    Point_3i& operator=(const Point_3i& rhs);
-    const integer& operator[](const size_t i) const;
-
-    const integer& x() const;
-    const integer& y() const;
-    const integer& z() const;
-    const std::array<integer, 3>& elements() const;
-    const uint32_t unique_id() const;
-    void set_x(const integer& x);
-    void set_y(const integer& y);
-    void set_z(const integer& z);
-    void set_elements(const std::array<integer, 3>& elements);
-    void set_unique_id(const uint32_t unique_id);
-
-private:
-    std::array<integer, 3> elements_;
-    uint32_t unique_id_;
-};
-
-bool operator==(const Point_3i& lhs, const Point_3i& rhs);
-bool operator!=(const Point_3i& lhs, const Point_3i& rhs);
-std::ostream& operator<<(std::ostream& o, const Point_3i& p);
-std::string to_string(const Point_3i& p);
-
-//=============================================================================
-// Interface: Point_3f
-//=============================================================================
-
-class Point_3f {
-public:
-    Point_3f();
-    Point_3f(const Point_3f& p);
-    Point_3f(const Point_2f& p);
-    Point_3f(const float x, const float y, const float z);
-
-    Point_3f& operator=(const Point_3f& rhs);
-    const float operator[](const size_t i) const;
-
-    const float x() const;
-    const float y() const;
-    const float z() const;
-    const std::array<float, 3>& elements() const;
-    const uint32_t unique_id() const;
-    void set_x(const float x);
-    void set_y(const float y);
-    void set_z(const float z);
-    void set_elements(const std::array<float, 3>& elements);
-    void set_unique_id(const uint32_t unique_id);
-
-private:
-    std::array<float, 3> elements_;
-    uint32_t unique_id_;
-};
-
-bool operator==(const Point_3f& lhs, const Point_3f& rhs);
-bool operator!=(const Point_3f& lhs, const Point_3f& rhs);
-std::ostream& operator<<(std::ostream& o, const Point_3f& p);
-std::string to_string(const Point_3f& p);
-
-//=============================================================================
-// Interface: Point_3r
-//=============================================================================
-
-class Point_3r {
-public:
-    Point_3r();
-    Point_3r(const Point_3r& p);
-    Point_3r(const Point_2r& p);
-    Point_3r(const Point_3i& p);
-    Point_3r(const Point_3f& p);
-    Point_3r(const rational& x, const rational& y, const rational& z);
-
-    void AddObserver(IPointObserver* o);
-    void RemoveObserver(IPointObserver* o);
-    void SigPositionChanged() const;
-
-    Point_3r& operator=(const Point_3r& rhs);
-    const rational& operator[](const size_t i) const;
-
-    const rational& x() const;
-    const rational& y() const;
-    const rational& z() const;
-    const std::array<rational, 3>& elements() const;
-    const uint32_t unique_id() const;
-    void set_x(const rational& x);
-    void set_y(const rational& y);
-    void set_z(const rational& z);
-    void set_elements(const std::array<rational, 3>& elements);
-    void set_unique_id(const uint32_t unique_id);
-
-private:
-    std::array<rational, 3> elements_;
-    std::vector<IPointObserver*> observers_;
-    uint32_t unique_id_;
-};
-
-bool operator==(const Point_3r& lhs, const Point_3r& rhs);
-bool operator!=(const Point_3r& lhs, const Point_3r& rhs);
-std::ostream& operator<<(std::ostream& o, const Point_3r& p);
-std::string to_string(const Point_3r& p);
-
-//=============================================================================
-// Implementation: Point_3i
-//=============================================================================
-
-//! @brief Sets both elements and unique id to zero.
-inline Point_3i::Point_3i() {
-    set_x(0);
-    set_y(0);
-    set_z(0);
-    set_unique_id(0);
-}
-
-inline Point_3i::Point_3i(const Point_3i& p) {
-    *this = p;
-}
-
-inline Point_3i::Point_3i(const Point_2i& p) {
-    set_x(p.x());
-    set_y(p.y());
-    set_z(0);
-    set_unique_id(p.unique_id());
-}
-
-inline Point_3i::Point_3i(const integer& x, const integer& y,
-                          const integer& z) {
-    set_x(x);
-    set_y(y);
-    set_z(z);
-    set_unique_id(0);
-}
-
-inline Point_3i& Point_3i::operator=(const Point_3i& rhs) {
-    set_x(rhs.x());
-    set_y(rhs.y());
-    set_z(rhs.z());
-    set_unique_id(rhs.unique_id());
-    return *this;
-}
-
-//! @brief Index-based access operator without elegant out-of-bounds handling.
-inline const integer& Point_3i::operator[](const size_t i) const {
-    assert(i < 3);
-    return elements_[i];
-}
-
-//! @brief Sequentially calls operator== element-wise.
-inline bool operator==(const Point_3i& lhs, const Point_3i& rhs) {
-    return lhs.elements() == rhs.elements();
-}
-
-//! @brief Sequentially calls operator!= element-wise.
-inline bool operator!=(const Point_3i& lhs, const Point_3i& rhs) {
-    return lhs.elements() != rhs.elements();
-}
-
-inline std::ostream& operator<<(std::ostream& o, const Point_3i& p) {
-    return o << to_string(p);
-}
-
-//! @brief Represents this point using parentheses (x, y).
-inline std::string to_string(const Point_3i& p) {
-    std::stringstream ss;
-    ss << "(" << p.x() << ", " << p.y() << ", " << p.z() << ")";
-    return ss.str();
-}
-
-// Accessors/Mutators =========================================================
-
-inline const integer& Point_3i::x() const {
+template <class T, size_t N>
+inline const T& Point<T, N>::x() const {
     return elements_[0];
 }
-inline const integer& Point_3i::y() const {
+template <class T, size_t N>
+inline const T& Point<T, N>::y() const {
     return elements_[1];
 }
-inline const integer& Point_3i::z() const {
+template <class T, size_t N>
+inline const T& Point<T, N>::z() const {
+    static_assert(N >= 3, "Point: z() of a 2D point");
     return elements_[2];
 }
-inline const std::array<integer, 3>& Point_3i::elements() const {
+template <class T, size_t N>
+inline const std::array<T, N>& Point<T, N>::elements() const {
     return elements_;
 }
-inline const uint32_t Point_3i::unique_id() const {
+template <class T, size_t N>
+inline const uint32_t Point<T, N>::unique_id() const {
     return unique_id_;
 }
-inline void Point_3i::set_x(const integer& x) {
+template <class T, size_t N>
+inline void Point<T, N>::set_x(const T& x) {
     elements_[0] = x;
 }
-inline void Point_3i::set_y(const integer& y) {
-    elements_[1] = y;
-}
-inline void Point_3i::set_z(const integer& z) {
-    elements_[2] = z;
-}
-inline void Point_3i::set_elements(const std::array<integer, 3>& elements) {
-    elements_ = elements;
+template <class T, size_t N>
+inline void Point<T, N>::set_x(T&& x) {
+    elements_[0] = std::move(x);
 }
-inline void Point_3i::set_unique_id(const uint32_t unique_id) {
-    unique_id_ = unique_id;
-}
-
-//=============================================================================
-// Implementation: Point_3f
-//=============================================================================
-
-inline Point_3f::Point_3f() {
-    set_x(0);
-    set_y(0);
-    set_z(0);
-    set_unique_id(0);
-}
-
-inline Point_3f::Point_3f(const Point_3f& p) {
-    *this = p;
-}
-
-inline Point_3f::Point_3f(const Point_2f& p) {
-    set_x(p.x());
-    set_y(p.y());
-    set_z(0);
-    set_unique_id(p.unique_id());
-}
-
-inline Point_3f::Point_3f(const float x, const float y, const float z) {
-    set_x(x);
-    set_y(y);
-    set_z(z);
-    set_unique_id(0);
-}
-
-inline Point_3f& Point_3f::operator=(const Point_3f& rhs) {
-    set_x(rhs.x());
-    set_y(rhs.y());
-    set_z(rhs.z());
-    set_unique_id(rhs.unique_id());
-    return *this;
-}
-
-//! @brief Index-based access operator without elegant out-of-bounds handling.
-inline const float Point_3f::operator[](const size_t i) const {
-    assert(i < 3);
-    return elements_[i];
-}
-
-//! @brief Sequentially calls operator== element-wise.
-inline bool operator==(const Point_3f& lhs, const Point_3f& rhs) {
-    return lhs.elements() == rhs.elements();
-}
-
-//! @brief Sequentially calls operator!= element-wise.
-inline bool operator!=(const Point_3f& lhs, const Point_3f& rhs) {
-    return lhs.elements() != rhs.elements();
-}
-
-inline std::ostream& operator<<(std::ostream& o, const Point_3f& p) {
-    return o << to_string(p);
-}
-
-//! @brief Represents this point using parentheses (x, y).
-inline std::string to_string(const Point_3f& p) {
-    std::stringstream ss;
-    ss << "(" << p.x() << ", " << p.y() << ", " << p.z() << ")";
-    return ss.str();
-}
-
-// Accessors/Mutators =========================================================
-
-inline const float Point_3f::x() const {
-    return elements_[0];
-}
-inline const float Point_3f::y() const {
-    return elements_[1];
-}
-inline const float Point_3f::z() const {
-    return elements_[2];
-}
-inline const std::array<float, 3>& Point_3f::elements() const {
-    return elements_;
-}
-inline const uint32_t Point_3f::unique_id() const {
-    return unique_id_;
-}
-inline void Point_3f::set_x(const float x) {
-    elements_[0] = x;
-}
-inline void Point_3f::set_y(const float y) {
+template <class T, size_t N>
+inline void Point<T, N>::set_y(const T& y) {
     elements_[1] = y;
 }
-inline void Point_3f::set_z(const float z) {
-    elements_[2] = z;
-}
-inline void Point_3f::set_elements(const std::array<float, 3>& elements) {
-    elements_ = elements;
-}
-inline void Point_3f::set_unique_id(const uint32_t unique_id) {
-    unique_id_ = unique_id;
-}
-
-//=============================================================================
-// Implementation: Point_3r
-//=============================================================================
-
-inline Point_3r::Point_3r() {
-    set_x(0);
-    set_y(0);
-    set_z(0);
-    set_unique_id(0);
-}
-
-inline Point_3r::Point_3r(const Point_3r& p) {
-    *this = p;
-}
-
-inline Point_3r::Point_3r(const Point_2r& p) {
-    set_x(p.x());
-    set_y(p.y());
-    set_z(0);
-    set_unique_id(p.unique_id());
-}
-
-//! @brief Allow implicit conversion from integer point.
-inline Point_3r::Point_3r(const Point_3i& p) {
-    set_x(p.x());
-    set_y(p.y());
-    set_z(p.z());
-    set_unique_id(p.unique_id());
-}
-
-//! @brief Allow implicit conversion from float point.
-inline Point_3r::Point_3r(const Point_3f& p) {
-    set_x(p.x());
-    set_y(p.y());
-    set_z(p.z());
-    set_unique_id(p.unique_id());
-}
-
-inline Point_3r::Point_3r(const rational& x, const rational& y,
-                          const rational& z) {
-    set_x(x);
-    set_y(y);
-    set_z(z);
-    set_unique_id(0);
-}
-
-inline void Point_3r::AddObserver(IPointObserver* o) {
-    observers_.push_back(o);
-}
-
-inline void Point_3r::RemoveObserver(IPointObserver* o) {
-    std::remove(begin(observers_), end(observers_), o);
-}
-
-inline void Point_3r::SigPositionChanged() const {
-    for(auto i = begin(observers_); i != end(observers_); ++i) {
-        (*i)->SlotPositionChanged_3r(*this);
-    }
-}
-
-inline Point_3r& Point_3r::operator=(const Point_3r& rhs) {
-    set_x(rhs.x());
-    set_y(rhs.y());
-    set_z(rhs.z());
-    set_unique_id(rhs.unique_id());
-    return *this;
-}
-
-//! @brief Index-based access operator without elegant out-of-bounds handling.
-inline const rational& Point_3r::operator[](const size_t i) const {
-    assert(i < 3);
-    return elements_[i];
-}
-
-//! @brief Sequentially calls operator== element-wise.
-inline bool operator==(const Point_3r& lhs, const Point_3r& rhs) {
-    return lhs.elements() == rhs.elements();
-}
-
-//! @brief Sequentially calls operator!= element-wise.
-inline bool operator!=(const Point_3r& lhs, const Point_3r& rhs) {
-    return lhs.elements() != rhs.elements();
-}
-
-
-inline std::ostream& operator<<(std::ostream& o, const Point_3r& p) {
-    return o << to_string(p);
+template <class T, size_t N>
+inline void Point<T, N>::set_y(T&& y) {
+    elements_[1] = std::move(y);
 }
-
-//! @brief Represents this point using parentheses (x, y).
-inline std::string to_string(const Point_3r& p) {
-    std::stringstream ss;
-    ss << "(" << p.x() << ", " << p.y() << ", " << p.z() << ")";
-    return ss.str();
-}
-
-// Accessors/Mutators =========================================================
-
-inline const rational& Point_3r::x() const {
-    return elements_[0];
-}
-inline const rational& Point_3r::y() const {
-    return elements_[1];
-}
-inline const rational& Point_3r::z() const {
-    return elements_[2];
-}
-inline const std::array<rational, 3>& Point_3r::elements() const {
-    return elements_;
-}
-inline const uint32_t Point_3r::unique_id() const {
-    return unique_id_;
-}
-inline void Point_3r::set_x(const rational& x) {
-    elements_[0] = x;
-}
-inline void Point_3r::set_y(const rational& y) {
-    elements_[1] = y;
-}
-inline void Point_3r::set_z(const rational& z) {
+template <class T, size_t N>
+inline void Point<T, N>::set_z(const T& z) {
+    static_assert(N >= 3, "Point: set_z() of a 2D point");
     elements_[2] = z;
 }
-inline void Point_3r::set_elements(const std::array<rational, 3>& elements) {
+template <class T, size_t N>
+inline void Point<T, N>::set_z(T&& z) {
+    static_assert(N >= 3, "Point: set_z() of a 2D point");
+    elements_[2] = std::move(z);
+}
+template <class T, size_t N>
+inline void Point<T, N>::set_elements(const std::array<T, N>& elements) {
     elements_ = elements;
 }
-inline void Point_3r::set_unique_id(const uint32_t unique_id) {
+template <class T, size_t N>
+inline void Point<T, N>::set_unique_id(const uint32_t unique_id) {
     unique_id_ = unique_id;
 }
 
@@ -0,0 +1,404 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Structure-of-arrays point containers for batch kernels.
+ *
+ * A PointBuffer keeps one contiguous array per coordinate and names its
+ * points by index, so a million points cost N allocations rather than a
+ * million shared_ptr control blocks. Buffers carry no unique ids and no
+ * observers; materialize a Point_2r etc. with point(i) where visualization
+ * needs one. A PointBufferView is a non-owning window onto a buffer or a
+ * range of it and is what batch algorithms take. Views are invalidated by
+ * anything that reallocates the buffer, as with std::vector iterators.
+ */
+
+#ifndef GE_POINTBUFFER_H
+#define GE_POINTBUFFER_H
+
+#include "common.h"
+#include "point.h"
+
+namespace DDAD {
+
+//! @brief Handle of a point in a PointBuffer.
+typedef uint32_t PointIndex;
+
+//! @brief The point class with coordinates of type T in N dimensions.
+template <class T, size_t N>
+struct PointOf {
+    typedef Point<T, N> type;
+};
+
+template <class Point, class T>
+inline Point MakePoint(const std::array<const T*, 2>& axes, const size_t i) {
+    return Point(axes[0][i], axes[1][i]);
+}
+
+template <class Point, class T>
+inline Point MakePoint(const std::array<const T*, 3>& axes, const size_t i) {
+    return Point(axes[0][i], axes[1][i], axes[2][i]);
+}
+
+//=============================================================================
+// Interface: PointBufferView
+//=============================================================================
+
+template <class T, size_t N>
+class PointBufferView {
+public:
+    typedef typename PointOf<T, N>::type Point;
+
+    PointBufferView();
+    PointBufferView(const std::array<const T*, N>& axes, const size_t size);
+
+    //! @brief The count points starting at begin, without copying.
+    PointBufferView slice(const size_t begin, const size_t count) const;
+    Point point(const size_t i) const;
+
+    const T& coord(const size_t i, const size_t axis) const;
+    const T& x(const size_t i) const;
+    const T& y(const size_t i) const;
+    const T& z(const size_t i) const;
+    //! @brief Contiguous array of the given coordinate of all points.
+    const T* data(const size_t axis) const;
+    size_t size() const;
+    bool empty() const;
+
+private:
+    std::array<const T*, N> axes_;
+    size_t size_;
+};
+
+//=============================================================================
+// Interface: PointBuffer
+//=============================================================================
+
+template <class T, size_t N>
+class PointBuffer {
+public:
+    typedef typename PointOf<T, N>::type Point;
+    typedef PointBufferView<T, N> View;
+
+    PointBuffer();
+    //! @brief count points at the origin.
+    explicit PointBuffer(const size_t count);
+
+    PointIndex push_back(const Point& p);
+    PointIndex push_back(const std::array<T, N>& coords);
+    void pop_back();
+    void reserve(const size_t count);
+    void resize(const size_t count);
+    void clear();
+
+    Point point(const PointIndex i) const;
+    void set_point(const PointIndex i, const Point& p);
+
+    const T& coord(const PointIndex i, const size_t axis) const;
+    T& coord(const PointIndex i, const size_t axis);
+    const T& x(const PointIndex i) const;
+    const T& y(const PointIndex i) const;
+    const T& z(const PointIndex i) const;
+    const std::vector<T>& coords(const size_t axis) const;
+    T* data(const size_t axis);
+    size_t size() const;
+    bool empty() const;
+
+    View view() const;
+    View view(const size_t begin, const size_t count) const;
+
+private:
+    std::array<std::vector<T>, N> coords_;
+};
+
+typedef PointBuffer<integer, 2> PointBuffer_2i;
+typedef PointBuffer<float, 2> PointBuffer_2f;
+typedef PointBuffer<rational, 2> PointBuffer_2r;
+typedef PointBuffer<integer, 3> PointBuffer_3i;
+typedef PointBuffer<float, 3> PointBuffer_3f;
+typedef PointBuffer<rational, 3> PointBuffer_3r;
+
+typedef PointBufferView<integer, 2> PointBufferView_2i;
+typedef PointBufferView<float, 2> PointBufferView_2f;
+typedef PointBufferView<rational, 2> PointBufferView_2r;
+typedef PointBufferView<integer, 3> PointBufferView_3i;
+typedef PointBufferView<float, 3> PointBufferView_3f;
+typedef PointBufferView<rational, 3> PointBufferView_3r;
+
+//! @brief Copies every coordinate into a buffer of type U, e.g. float or
+//! integer points into rational ones, which is exact.
+template <class U, class T, size_t N>
+PointBuffer<U, N> ConvertPointBuffer(const PointBufferView<T, N>& points);
+
+/*!
+ * @brief Appends one record per line until the end of the stream, the format
+ * of the workbench point set files. A record is the first N whitespace-
+ * separated fields of its line; later fields, such as the "r g b" of an
+ * "x y z r g b" file, are skipped, and so are blank lines. Returns false at
+ * the first line with fewer than N coordinates; the records read before it
+ * are kept.
+ */
+template <class T, size_t N>
+bool ReadPointBuffer(std::istream& in, PointBuffer<T, N>& points);
+
+//! @brief Writes one record of N coordinates per line.
+template <class T, size_t N>
+void WritePointBuffer(std::ostream& out, const PointBufferView<T, N>& points);
+
+//=============================================================================
+// Implementation: PointBufferView
+//=============================================================================
+
+template <class T, size_t N>
+inline PointBufferView<T, N>::PointBufferView() :
+    size_(0) {
+    axes_.fill(nullptr);
+}
+
+template <class T, size_t N>
+inline PointBufferView<T, N>::PointBufferView(
+        const std::array<const T*, N>& axes, const size_t size) :
+    axes_(axes),
+    size_(size) {}
+
+template <class T, size_t N>
+inline PointBufferView<T, N> PointBufferView<T, N>::slice(
+        const size_t begin, const size_t count) const {
+    assert(begin+count <= size_);
+    std::array<const T*, N> axes = axes_;
+    for (auto& axis : axes) {
+        axis += begin;
+    }
+    return PointBufferView(axes, count);
+}
+
+template <class T, size_t N>
+inline typename PointBufferView<T, N>::Point
+PointBufferView<T, N>::point(const size_t i) const {
+    assert(i < size_);
+    return MakePoint<Point>(axes_, i);
+}
+
+// Accessors/Mutators =========================================================
+
+template <class T, size_t N>
+inline const T& PointBufferView<T, N>::coord(const size_t i,
+                                             const size_t axis) const {
+    assert(i < size_ && axis < N);
+    return axes_[axis][i];
+}
+template <class T, size_t N>
+inline const T& PointBufferView<T, N>::x(const size_t i) const {
+    return coord(i, 0);
+}
+template <class T, size_t N>
+inline const T& PointBufferView<T, N>::y(const size_t i) const {
+    return coord(i, 1);
+}
+template <class T, size_t N>
+inline const T& PointBufferView<T, N>::z(const size_t i) const {
+    static_assert(N >= 3, "z() of a two-dimensional point buffer");
+    return coord(i, 2);
+}
+template <class T, size_t N>
+inline const T* PointBufferView<T, N>::data(const size_t axis) const {
+    return axes_[axis];
+}
+template <class T, size_t N>
+inline size_t PointBufferView<T, N>::size() const {
+    return size_;
+}
+template <class T, size_t N>
+inline bool PointBufferView<T, N>::empty() const {
+    return size_ == 0;
+}
+
+//=============================================================================
+// Implementation: PointBuffer
+//=============================================================================
+
+template <class T, size_t N>
+inline PointBuffer<T, N>::PointBuffer() {}
+
+template <class T, size_t N>
+inline PointBuffer<T, N>::PointBuffer(const size_t count) {
+    resize(count);
+}
+
+template <class T, size_t N>
+inline PointIndex PointBuffer<T, N>::push_back(const Point& p) {
+    for (size_t axis = 0; axis < N; ++axis) {
+        coords_[axis].push_back(p[axis]);
+    }
+    return static_cast<PointIndex>(size()-1);
+}
+
+template <class T, size_t N>
+inline PointIndex PointBuffer<T, N>::push_back(const std::array<T, N>& c) {
+    for (size_t axis = 0; axis < N; ++axis) {
+        coords_[axis].push_back(c[axis]);
+    }
+    return static_cast<PointIndex>(size()-1);
+}
+
+template <class T, size_t N>
+inline void PointBuffer<T, N>::pop_back() {
+    for (auto& axis : coords_) {
+        axis.pop_back();
+    }
+}
+
+template <class T, size_t N>
+inline void PointBuffer<T, N>::reserve(const size_t count) {
+    for (auto& axis : coords_) {
+        axis.reserve(count);
+    }
+}
+
+template <class T, size_t N>
+inline void PointBuffer<T, N>::resize(const size_t count) {
+    for (auto& axis : coords_) {
+        axis.resize(count, T(0));
+    }
+}
+
+template <class T, size_t N>
+inline void PointBuffer<T, N>::clear() {
+    for (auto& axis : coords_) {
+        axis.clear();
+    }
+}
+
+template <class T, size_t N>
+inline typename PointBuffer<T, N>::Point
+PointBuffer<T, N>::point(const PointIndex i) const {
+    return view().point(i);
+}
+
+template <class T, size_t N>
+inline void PointBuffer<T, N>::set_point(const PointIndex i, const Point& p) {
+    for (size_t axis = 0; axis < N; ++axis) {
+        coords_[axis][i] = p[axis];
+    }
+}
+
+template <class T, size_t N>
+inline typename PointBuffer<T, N>::View PointBuffer<T, N>::view() const {
+    std::array<const T*, N> axes;
+    for (size_t axis = 0; axis < N; ++axis) {
+        axes[axis] = coords_[axis].data();
+    }
+    return View(axes, size());
+}
+
+template <class T, size_t N>
+inline typename PointBuffer<T, N>::View PointBuffer<T, N>::view(
+        const size_t begin, const size_t count) const {
+    return view().slice(begin, count);
+}
+
+// Accessors/Mutators =========================================================
+
+template <class T, size_t N>
+inline const T& PointBuffer<T, N>::coord(const PointIndex i,
+                                         const size_t axis) const {
+    return coords_[axis][i];
+}
+template <class T, size_t N>
+inline T& PointBuffer<T, N>::coord(const PointIndex i, const size_t axis) {
+    return coords_[axis][i];
+}
+template <class T, size_t N>
+inline const T& PointBuffer<T, N>::x(const PointIndex i) const {
+    return coords_[0][i];
+}
+template <class T, size_t N>
+inline const T& PointBuffer<T, N>::y(const PointIndex i) const {
+    return coords_[1][i];
+}
+template <class T, size_t N>
+inline const T& PointBuffer<T, N>::z(const PointIndex i) const {
+    static_assert(N >= 3, "z() of a two-dimensional point buffer");
+    return coords_[2][i];
+}
+template <class T, size_t N>
+inline const std::vector<T>& PointBuffer<T, N>::coords(
+        const size_t axis) const {
+    return coords_[axis];
+}
+template <class T, size_t N>
+inline T* PointBuffer<T, N>::data(const size_t axis) {
+    return coords_[axis].data();
+}
+template <class T, size_t N>
+inline size_t PointBuffer<T, N>::size() const {
+    return coords_[0].size();
+}
+template <class T, size_t N>
+inline bool PointBuffer<T, N>::empty() const {
+    return coords_[0].empty();
+}
+
+//=============================================================================
+// Implementation: Bulk conversion and I/O
+//=============================================================================
+
+template <class U, class T, size_t N>
+inline PointBuffer<U, N> ConvertPointBuffer(
+        const PointBufferView<T, N>& points) {
+    PointBuffer<U, N> result(points.size());
+    for (size_t axis = 0; axis < N; ++axis) {
+        const T* from = points.data(axis);
+        U* to = result.data(axis);
+        for (size_t i = 0; i < points.size(); ++i) {
+            to[i] = U(from[i]);
+        }
+    }
+    return result;
+}
+
+template <class T, size_t N>
+inline bool ReadPointBuffer(std::istream& in, PointBuffer<T, N>& points) {
+    std::array<T, N> record;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields(line);
+        for (size_t axis = 0; axis < N; ++axis) {
+            if (!(fields >> record[axis])) {
+                return false;
+            }
+        }
+        points.push_back(record);
+    }
+    return true;
+}
+
+template <class T, size_t N>
+inline void WritePointBuffer(std::ostream& out,
+                             const PointBufferView<T, N>& points) {
+    for (size_t i = 0; i < points.size(); ++i) {
+        for (size_t axis = 0; axis < N; ++axis) {
+            out << (axis > 0 ? " " : "") << points.coord(i, axis);
+        }
+        out << "\n";
+    }
+}
+
+} // namespace DDAD
+
+#endif // GE_POINTBUFFER_H
@@ -43,6 +43,14 @@ void PointSet_3r::add(SharedPoint_3r p) {
     SigPushVisualPoint_3r(*p, Visual::Point(mat_vertex_));
 }
 
+void PointSet_3r::add(const PointBufferView_3r& points) {
+    points_.reserve(points_.size()+points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        add(std::make_shared<Point_3r>(points.x(i), points.y(i),
+                                       points.z(i)));
+    }
+}
+
 SharedPoint_3r PointSet_3r::operator[](const size_t i) const {
     return points_[i];
 }
@@ -59,4 +67,13 @@ void PointSet_3r::set_mat_vertex(const Visual::Material mat_vertex) {
     mat_vertex_ = mat_vertex;
 }
 
+PointBuffer_3r ToPointBuffer(const PointSet_3r& pointset) {
+    PointBuffer_3r buffer;
+    buffer.reserve(pointset.size());
+    for (auto& point : pointset.points()) {
+        buffer.push_back(*point);
+    }
+    return buffer;
+}
+
 } // namespace DDAD
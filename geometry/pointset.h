@@ -19,6 +19,7 @@
 #include "common.h"
 #include "visual.h"
 #include "point.h"
+#include "pointbuffer.h"
 
 namespace DDAD {
 
@@ -33,6 +34,7 @@ public:
 
     void add(const Point_3r& p);
     void add(SharedPoint_3r p);
+    void add(const PointBufferView_3r& points);
 
     SharedPoint_3r operator[](const size_t i) const;
     const size_t size() const;
@@ -45,6 +47,9 @@ private:
     Visual::Material mat_vertex_;
 };
 
+//! @brief Coordinates of the set as one contiguous buffer.
+PointBuffer_3r ToPointBuffer(const PointSet_3r& pointset);
+
 } // namespace DDAD
 
 #endif // GE_POLYGON_H
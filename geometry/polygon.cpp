@@ -17,8 +17,14 @@
  * @brief Implementations of Polyline/Polygon types and related algorithms.
  */
 
+#include <algorithm>
+#include <functional>
+
 #include "common.h"
 #include "arithmetic.h"
+#include "homogeneous.h"
+#include "hull.h"
+#include "lattice.h"
 #include "line.h"
 #include "intersection.h"
 #include "polygon.h"
@@ -34,6 +40,41 @@ namespace DDAD {
 // Algorithms
 //=============================================================================
 
+/*!
+ * @brief Index deque for MelkmanIndices that mirrors every change into a
+ * Polygon_2r, so that its observers see the hull evolve.
+ */
+class ObservedHull_2r {
+public:
+    ObservedHull_2r(const Polyline_2r& P, Polygon_2r& hull) :
+        P_(P),
+        hull_(hull) {}
+
+    void push_back(const size_t i) {
+        indices_.push_back(i);
+        hull_.push_back(*P_[i]);
+    }
+    void push_front(const size_t i) {
+        indices_.push_front(i);
+        hull_.push_front(*P_[i]);
+    }
+    void pop_back() {
+        indices_.pop_back();
+        hull_.pop_back();
+    }
+    void pop_front() {
+        indices_.pop_front();
+        hull_.pop_front();
+    }
+    size_t operator[](const size_t i) const { return indices_[i]; }
+    size_t size() const { return indices_.size(); }
+
+private:
+    const Polyline_2r& P_;
+    Polygon_2r& hull_;
+    RingDeque<size_t> indices_;
+};
+
 /*!
  * @brief Melkman computes the convex hull of a simple polyline P in O(n) time.
  * @param P - simple polyline with n vertices.
@@ -51,34 +92,322 @@ Polygon_2r Melkman(const Polyline_2r& P, IGeometryObserver* obs) {
     hull.set_z_order(1);
     hull.AddObserver(obs);
 
-    // initialize hull
-    hull.push_back(*P[1]);
-    hull.push_back(*P[0]);
-    hull.push_back(*P[1]);
+    if (hull.observed()) {
+        ObservedHull_2r observed_hull(P, hull);
+        MelkmanIndices<RationalKernel_2>(P, observed_hull);
+    } else {
+        RingDeque<size_t> indices(P.size()+1);
+        MelkmanIndices<RationalKernel_2>(P, indices);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            hull.push_back(*P[indices[i]]);
+        }
+    }
 
-    for (size_t i = 2; i < P.size(); ++i) {
-        if (!RIsLeftOrInsidePQ(*hull.back(1), *hull.back(0), *P[i]) ||
-            !RIsLeftOrInsidePQ(*hull.front(0), *hull.front(1), *P[i])) {
-            while (!RIsLeftOrInsidePQ(*hull.back(1), *hull.back(0), *P[i])) {
-                hull.pop_back();
-            }
-            while (!RIsLeftOrInsidePQ(*hull.front(0), *hull.front(1), *P[i])) {
-                hull.pop_front();
+    return hull;
+}
+
+//=============================================================================
+// Integer hull
+//=============================================================================
+
+//! @brief n/d rounded toward -infinity.
+static integer FloorDiv(const integer& n, const integer& d) {
+    integer q;
+    mpz_fdiv_q(q.get_mpz_t(), n.get_mpz_t(), d.get_mpz_t());
+    return q;
+}
+
+//! @brief n/d rounded toward +infinity.
+static integer CeilDiv(const integer& n, const integer& d) {
+    integer q;
+    mpz_cdiv_q(q.get_mpz_t(), n.get_mpz_t(), d.get_mpz_t());
+    return q;
+}
+
+/*!
+ * @brief Sum of floor((a*i+b)/m) over 0 <= i < n, for m > 0. Each round
+ * reduces a and b mod m and then trades the roles of a and m as in Euclid's
+ * algorithm, so it takes O(log m) rounds however large n is.
+ */
+static integer FloorSum(integer n, integer m, integer a, integer b) {
+    integer sum = 0;
+    integer q;
+    while (true) {
+        mpz_fdiv_qr(q.get_mpz_t(), a.get_mpz_t(), a.get_mpz_t(),
+                    m.get_mpz_t());
+        sum += q*(n*(n-1)/2);
+        mpz_fdiv_qr(q.get_mpz_t(), b.get_mpz_t(), b.get_mpz_t(),
+                    m.get_mpz_t());
+        sum += q*n;
+
+        integer top = a*n+b;
+        if (top < m) {
+            return sum;
+        }
+        mpz_fdiv_qr(n.get_mpz_t(), b.get_mpz_t(), top.get_mpz_t(),
+                    m.get_mpz_t());
+        std::swap(m, a);
+    }
+}
+
+//! @brief Sum of floor((a*x+b)/m) over the integers first <= x <= last.
+static integer FloorSum(const integer& first, const integer& last,
+                        const integer& a, const integer& b,
+                        const integer& m) {
+    if (last < first) {
+        return 0;
+    }
+    return FloorSum(last-first+1, m, a, a*first+b);
+}
+
+static int CompareX(const Point_2h& p, const Point_2h& q) {
+    return sgn(p.x()*q.w()-q.x()*p.w());
+}
+
+static int CompareY(const Point_2h& p, const Point_2h& q) {
+    return sgn(p.y()*q.w()-q.y()*p.w());
+}
+
+//! @brief Vertices of the convex polygon P, counterclockwise and without
+//! repetition.
+static std::vector<Point_2h> ConvexBoundary(const Polygon_2r& P) {
+    std::vector<Point_2h> Q;
+    for (size_t i = 0; i < P.size(); ++i) {
+        Point_2h p(*P[i]);
+        if (Q.empty() || p != Q.back()) {
+            Q.push_back(p);
+        }
+    }
+    while (Q.size() > 1 && Q.back() == Q.front()) {
+        Q.pop_back();
+    }
+
+    // the turn at the leftmost vertex gives the orientation
+    size_t k = 0;
+    for (size_t i = 1; i < Q.size(); ++i) {
+        int dx = CompareX(Q[i], Q[k]);
+        if (dx < 0 || (dx == 0 && CompareY(Q[i], Q[k]) < 0)) {
+            k = i;
+        }
+    }
+    if (Q.size() > 2 &&
+        OrientationPQR(Q[(k+Q.size()-1)%Q.size()], Q[k],
+                       Q[(k+1)%Q.size()]) == ORIENTATION_RIGHT) {
+        std::reverse(Q.begin(), Q.end());
+    }
+    return Q;
+}
+
+//! @brief Lattice points x with det(d, x-z) >= k, i.e. at least k to the
+//! left of the line through z along d, as the nonnegative side of a line.
+static Line_2h LeftOf(const Point_2i& z, const Vector_2i& d,
+                      const integer& k) {
+    return Line_2h(-d.y(), d.x(), d.y()*z.x()-d.x()*z.y()-k);
+}
+
+//! @brief Part of the convex polygon Q on the nonnegative side of h, which
+//! may be empty or degenerate.
+static std::vector<Point_2h> Clip(const std::vector<Point_2h>& Q,
+                                  const Line_2h& h) {
+    std::vector<Point_2h> clipped;
+    for (size_t i = 0; i < Q.size(); ++i) {
+        const Point_2h& p = Q[i];
+        const Point_2h& q = Q[(i+1)%Q.size()];
+        int sp = sgn(Dot(h, p));
+        int sq = sgn(Dot(h, q));
+        if (sp >= 0) {
+            clipped.push_back(p);
+        }
+        if (sp*sq < 0) {
+            integer hp = Dot(h, p);
+            integer hq = Dot(h, q);
+            integer w = hp*q.w()-hq*p.w();
+            integer s = sgn(w);
+            clipped.push_back(Point_2h(s*(hp*q.x()-hq*p.x()),
+                                       s*(hp*q.y()-hq*p.y()), s*w));
+        }
+    }
+    return clipped;
+}
+
+/*!
+ * @brief Number of lattice points in the convex polygon Q, counted column
+ * by column: every column has floor(top)-ceil(bottom)+1 of them, and the
+ * tops and bottoms under one edge add up in a single FloorSum. Columns are
+ * charged to the edges over the half-open x-range [p, q) they span, with the
+ * column through the rightmost vertex, if any, handled on its own.
+ */
+static integer CountLatticePoints(const std::vector<Point_2h>& Q) {
+    if (Q.empty()) {
+        return 0;
+    }
+    size_t left = 0, right = 0;
+    for (size_t i = 1; i < Q.size(); ++i) {
+        if (CompareX(Q[i], Q[left]) < 0) {
+            left = i;
+        }
+        if (CompareX(Q[i], Q[right]) > 0) {
+            right = i;
+        }
+    }
+    integer x_min = CeilDiv(Q[left].x(), Q[left].w());
+    integer x_max = FloorDiv(Q[right].x(), Q[right].w());
+    if (x_max < x_min) {
+        return 0;
+    }
+
+    integer count = x_max-x_min+1;
+    for (size_t i = 0; i < Q.size(); ++i) {
+        const Point_2h& p = Q[i];
+        const Point_2h& q = Q[(i+1)%Q.size()];
+        int dir = CompareX(q, p);
+        if (dir == 0) {
+            continue;
+        }
+        const Point_2h& l = dir > 0 ? p : q;
+        const Point_2h& r = dir > 0 ? q : p;
+        integer first = CeilDiv(l.x(), l.w());
+        integer last = CeilDiv(r.x(), r.w())-1;
+
+        // on ax+by+c = 0, the top adds floor((-ax-c)/b) and the bottom
+        // subtracts ceil((-ax-c)/b), i.e. adds floor((ax+c)/b)
+        Line_2h pq(p, q);
+        integer s = dir*sgn(pq.b());
+        count += FloorSum(first, last, s*pq.a(), s*pq.c(), s*dir*pq.b());
+    }
+
+    if (x_max*Q[right].w() == Q[right].x()) {
+        const Point_2h* top = &Q[right];
+        const Point_2h* bottom = &Q[right];
+        for (const Point_2h& p : Q) {
+            if (CompareX(p, Q[right]) == 0) {
+                if (CompareY(p, *top) > 0) {
+                    top = &p;
+                }
+                if (CompareY(p, *bottom) < 0) {
+                    bottom = &p;
+                }
             }
-            hull.push_back(*P[i]);
-            hull.push_front(*P[i]);
         }
+        count += FloorDiv(top->y(), top->w())-
+                 CeilDiv(bottom->y(), bottom->w());
     }
+    return count;
+}
 
-    return hull;
+static bool HasLatticePoint(const std::vector<Point_2h>& Q) {
+    return CountLatticePoints(Q) > 0;
+}
+
+//! @brief Largest t >= 0 such that holds(t), given that holds is true at 0
+//! and false from some t on, by doubling and then bisection.
+static integer LastHolding(const std::function<bool(const integer&)>& holds) {
+    integer lo = 0, hi = 1;
+    while (holds(hi)) {
+        lo = hi;
+        hi *= 2;
+    }
+    while (hi-lo > 1) {
+        integer mid = (lo+hi)/2;
+        if (holds(mid)) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+//! @brief Largest t with z+t*d in the convex polygon Q, for z in Q.
+static integer StepsInside(const std::vector<Point_2h>& Q, const Point_2i& z,
+                           const Vector_2i& d) {
+    std::vector<Point_2h> chord = Clip(Clip(Q, LeftOf(z, d, 0)),
+                                       LeftOf(z, -d, 0));
+    integer steps = 0;
+    for (const Point_2h& p : chord) {
+        integer t = FloorDiv((p.x()-z.x()*p.w())*d.x()+
+                             (p.y()-z.y()*p.w())*d.y(),
+                             p.w()*Dot(d, d));
+        if (t > steps) {
+            steps = t;
+        }
+    }
+    return steps;
 }
 
 /*!
- * @brief IntegerHull computes the m-vertex integer hull of a n-vertex convex
- * polygon with diameter d in O(n + m log d) time.
- * @param P - convex polygon with n vertices.
+ * @brief Direction of the next integer hull edge after the hull vertex z,
+ * which the hull reached along d. Q1 is the part of the polygon strictly
+ * left of that line. With det(d, e) = 1, every lattice point of Q1 lies in
+ * a direction i*d+j*e from z with j >= 1, and the next edge takes the most
+ * clockwise one, the largest fraction i/j. The search keeps it inside a
+ * wedge between two neighbors lo and hi of the Stern-Brocot tree, and moves
+ * either side toward the other as far as it can go, by doubling. It stops
+ * once no lattice point of Q1 lies strictly clockwise of lo, after
+ * O(log d) lattice point counts.
+ */
+static Vector_2i NextHullDirection(const std::vector<Point_2h>& Q1,
+                                   const Point_2i& z, const Vector_2i& d,
+                                   WedgeStack_2r* wedges) {
+    integer s, t;
+    ExtendedGCD(d.x(), d.y(), s, t);
+    const Vector_2i e(-t, s);
+
+    auto direction = [&](const integer& i, const integer& j) {
+        return d*i+e*j;
+    };
+    // has Q1 a lattice point at least k clockwise of direction i*d+j*e?
+    auto reaches = [&](const integer& i, const integer& j, const integer& k) {
+        return HasLatticePoint(Clip(Q1, LeftOf(z, -direction(i, j), k)));
+    };
+
+    // -1/0 and 1/0 stand for the directions -d and d
+    integer lo_i = -1, lo_j = 0, hi_i = 1, hi_j = 0;
+    if (reaches(0, 1, 0)) {
+        lo_i = 0;
+        lo_j = 1;
+    } else {
+        hi_i = 0;
+        hi_j = 1;
+    }
+
+    while (lo_j == 0 || reaches(lo_i, lo_j, 1)) {
+        integer steps = LastHolding([&](const integer& k) {
+            return !reaches(hi_i+k*lo_i, hi_j+k*lo_j, 0);
+        });
+        hi_i += steps*lo_i;
+        hi_j += steps*lo_j;
+
+        steps = LastHolding([&](const integer& k) {
+            return reaches(lo_i+k*hi_i, lo_j+k*hi_j, 0);
+        });
+        lo_i += steps*hi_i;
+        lo_j += steps*hi_j;
+
+        if (wedges) {
+            if (!wedges->empty()) {
+                wedges->Pop();
+            }
+            wedges->Push(std::make_shared<Wedge_2r>(
+                Vector_2r(direction(hi_i, hi_j)),
+                Vector_2r(direction(lo_i, lo_j))));
+        }
+    }
+    return direction(lo_i, lo_j);
+}
+
+/*!
+ * @brief IntegerHull computes the m-vertex integer hull of a convex polygon
+ * by gift wrapping: from the lexicographically smallest lattice point, it
+ * finds each next vertex with NextHullDirection. The cost is O(m log d)
+ * exact lattice point counts in the n-vertex polygon, each O(n log d), for
+ * a polygon of diameter d, so it grows with the output and the bit length
+ * of the coordinates rather than with the area.
+ * @param P - convex polygon with n vertices, in either orientation.
  * @param obs - observer to recieve visualization events.
- * @return integer hull of P.
+ * @return integer hull of P, counterclockwise from its lexicographically
+ * smallest vertex, which is repeated at the back as in Melkman. Empty if P
+ * contains no lattice point.
  */
 Polygon_2r IntegerHull(const Polygon_2r& P, IGeometryObserver *obs) {
     Polygon_2r ihull;
@@ -91,74 +420,130 @@ Polygon_2r IntegerHull(const Polygon_2r& P, IGeometryObserver *obs) {
     ihull.set_z_order(1);
     ihull.AddObserver(obs);
 
-    /*
-    // canonicalize the boundary chain
-    boundary_.RotateToMaxX();
-
-    // grab the rightmost vertex
-    auto vert_itr_max_x = begin(boundary_.vertices());
-
-    // find the bottommost vertex
-    bool (*cmp)(const PolyChainVertex_2r&,
-                const PolyChainVertex_2r&) = Predicate::AIsBelowB;
-    auto vert_itr_min_y = std::min_element(begin(boundary_.vertices()),
-                                           end(boundary_.vertices()), cmp);
-
-    // construct an initial z and use it to init the tentative integer hull
-    Point_2r z(Floor(vert_itr_max_x->vertex().x()),
-               Floor(vert_itr_min_y->vertex().y()));
-    PolyChain_2r tentative_hull;
-    tentative_hull.AddObserver(this);
-    tentative_hull.AppendVertex(z);
-
-    // initialize wedge stack
-    WedgeStack_2r wstack;
-    wstack.AddObserver(this);
-    wstack.AttachToOrigin(tentative_hull.back().vertex_sptr());
-    wstack.Push(std::make_shared<Wedge_2r>(Vector_2r( 0, 1), Vector_2r(-1, 0)));
-    wstack.Push(std::make_shared<Wedge_2r>(Vector_2r( 1, 0), Vector_2r( 0, 1)));
-    wstack.Push(std::make_shared<Wedge_2r>(Vector_2r( 0,-1), Vector_2r( 1, 0)));
-    wstack.Push(std::make_shared<Wedge_2r>(Vector_2r(-1, 0), Vector_2r( 0,-1)));
-    wstack.Push(std::make_shared<Wedge_2r>(Vector_2r( 0, 1), Vector_2r(-1, 0)));
-    wstack.Push(std::make_shared<Wedge_2r>(Vector_2r( 1, 0), Vector_2r( 0, 1)));
-
-    auto vert_itr_P = vert_itr_max_x;
-    auto L = Line_2r(SLOPE_PINFINITY, vert_itr_P->vertex().x());
-
-    while (!wstack.empty()) {
-        auto wtop = wstack.Pop();
-        auto ray_zv = Ray_2r(tentative_hull.back().vertex_sptr(), wtop->v());
-        auto isect_L_zv = Intersection::Line_2rRay_2r(&L, &ray_zv);
-
-        if (Predicate::AreParallel(L, ray_zv) || !Predicate::IsEmpty(isect_L_zv)) {
-            while (Predicate::OrientationPQR(ray_zv, vert_itr_P->vertex()) != ORIENTATION_LEFT) {
-                if (vert_itr_P == std::prev(end(boundary_.vertices()))) {
-                    vert_itr_P = begin(boundary_.vertices());
-                } else {
-                    vert_itr_P++;
-                }
+    std::vector<Point_2h> Q = ConvexBoundary(P);
+    if (!HasLatticePoint(Q)) {
+        return ihull;
+    }
 
-                L = vert_itr_P->edge_prev().support();
+    // the leftmost column with a lattice point, found by doubling
+    integer x_min = CeilDiv(Q[0].x(), Q[0].w());
+    for (const Point_2h& p : Q) {
+        integer x = CeilDiv(p.x(), p.w());
+        if (x < x_min) {
+            x_min = x;
+        }
+    }
+    integer x = x_min+LastHolding([&](const integer& k) {
+        return !HasLatticePoint(Clip(Q, Line_2h(-1, 0, x_min+k-1)));
+    });
+    std::vector<Point_2h> column = Clip(Clip(Q, Line_2h(1, 0, -x)),
+                                        Line_2h(-1, 0, x));
+    const Point_2h* top = &column[0];
+    const Point_2h* bottom = &column[0];
+    for (const Point_2h& p : column) {
+        if (CompareY(p, *top) > 0) {
+            top = &p;
+        }
+        if (CompareY(p, *bottom) < 0) {
+            bottom = &p;
+        }
+    }
 
-                if (Predicate::AIsRightOfB(z, L)) {
-                    return;
-                }
+    // wrap counterclockwise, starting downward from the lowest point of the
+    // column so that all others lie to its left or above it
+    const Point_2i start(x, CeilDiv(bottom->y(), bottom->w()));
+    Point_2i z = start;
+    Vector_2i d(0, -1);
+    ihull.push_back(Point_2r(z));
+
+    WedgeStack_2r wedges;
+    wedges.AddObserver(obs);
+    while (true) {
+        std::vector<Point_2h> Q1 = Clip(Q, LeftOf(z, d, 1));
+        if (!HasLatticePoint(Q1)) {
+            // the lattice points are collinear; at the start, that means
+            // they all lie in the column
+            integer y_max = FloorDiv(top->y(), top->w());
+            if (ihull.size() == 1 && y_max > start.y()) {
+                ihull.push_back(Point_2r(Point_2i(x, y_max)));
             }
-            z = Construction::LastBefore(L, ray_zv);
-            tentative_hull.AppendVertex(z);
-            wstack.AttachToOrigin(tentative_hull.back().vertex_sptr());
-        } else {
-            wstack.Push(std::make_shared<Wedge_2r>(wtop->u()+wtop->v(), wtop->v()));
-            wstack.Push(std::make_shared<Wedge_2r>(wtop->u(), wtop->u()+wtop->v()));
+            break;
+        }
+        if (wedges.observed()) {
+            wedges.AttachToOrigin(ihull.back());
         }
+        d = NextHullDirection(Q1, z, d,
+                              wedges.observed() ? &wedges : nullptr);
+        z = z+d*StepsInside(Q, z, d);
+        if (z == start) {
+            break;
+        }
+        ihull.push_back(Point_2r(z));
     }
 
-    do {
-        tentative_hull.RemoveFront();
-    } while (begin(tentative_hull.vertices())->vertex() !=
-             std::prev(end(tentative_hull.vertices()))->vertex());
-             */
+    if (ihull.size() > 1) {
+        ihull.push_back(*ihull.front());
+    }
+    return ihull;
+}
+
+/*!
+ * @brief Reference for IntegerHull that tests every lattice point of the
+ * bounding box of P against the edges of P, keeping the lowest and highest
+ * of each column, and then hulls those. Its cost grows with the area of P;
+ * it is meant for checking and benchmarking.
+ * @return integer hull of P, in the same form as IntegerHull.
+ */
+Polygon_2r IntegerHullByLatticeScan(const Polygon_2r& P) {
+    Polygon_2r ihull;
+    std::vector<Point_2h> Q = ConvexBoundary(P);
+    if (Q.empty()) {
+        return ihull;
+    }
 
+    std::vector<Line_2h> edges;
+    integer x_min = CeilDiv(Q[0].x(), Q[0].w());
+    integer x_max = FloorDiv(Q[0].x(), Q[0].w());
+    integer y_min = CeilDiv(Q[0].y(), Q[0].w());
+    integer y_max = FloorDiv(Q[0].y(), Q[0].w());
+    for (size_t i = 0; i < Q.size(); ++i) {
+        const Point_2h& p = Q[i];
+        edges.push_back(Line_2h(p, Q[(i+1)%Q.size()]));
+        x_min = std::min(x_min, CeilDiv(p.x(), p.w()));
+        x_max = std::max(x_max, FloorDiv(p.x(), p.w()));
+        y_min = std::min(y_min, CeilDiv(p.y(), p.w()));
+        y_max = std::max(y_max, FloorDiv(p.y(), p.w()));
+    }
+
+    std::vector<Point_2i> extremes;
+    for (integer x = x_min; x <= x_max; x += 1) {
+        size_t found = 0;
+        for (integer y = y_min; y <= y_max; y += 1) {
+            Point_2h p(x, y);
+            bool inside = true;
+            for (const Line_2h& l : edges) {
+                if (sgn(Dot(l, p)) < 0) {
+                    inside = false;
+                    break;
+                }
+            }
+            if (inside) {
+                if (found++ < 2) {
+                    extremes.push_back(Point_2i(x, y));
+                } else {
+                    extremes.back() = Point_2i(x, y);
+                }
+            }
+        }
+    }
+
+    for (const Point_2i& v :
+         ParallelConvexHull<FilteredKernel_2>(extremes, 1)) {
+        ihull.push_back(Point_2r(v));
+    }
+    if (ihull.size() > 1) {
+        ihull.push_back(*ihull.front());
+    }
     return ihull;
 }
 
@@ -167,14 +552,29 @@ Polygon_2r IntegerHull(const Polygon_2r& P, IGeometryObserver *obs) {
 //=============================================================================
 
 Polygon_2r::Polygon_2r() :
-    z_order_(0) {
-    boundary_.AddObserver(this);
-}
+    z_order_(0) {}
 
 Polygon_2r::~Polygon_2r() {
     LOG(DEBUG) << "destroying polygon_2r...";
 }
 
+//! @note The boundary is only watched while the polygon itself is observed,
+//! so that an unobserved polygon sends no signals.
+void Polygon_2r::AddObserver(IGeometryObserver* geom_observer) {
+    bool was_observed = observed();
+    Geometry::AddObserver(geom_observer);
+    if (!was_observed && observed()) {
+        boundary_.AddObserver(this);
+    }
+}
+
+void Polygon_2r::RemoveObserver(IGeometryObserver* geom_observer) {
+    Geometry::RemoveObserver(geom_observer);
+    if (!observed()) {
+        boundary_.RemoveObserver(this);
+    }
+}
+
 void Polygon_2r::push_back(const Point_2r& v) {
     push_back(std::make_shared<Point_2r>(v.x(), v.y()));
 }
@@ -244,6 +644,10 @@ Polyline_2r::Polyline_2r(const Polyline_2r &copy) :
 Polyline_2r::~Polyline_2r() {
     LOG(DEBUG) << "destroying polyline...";
 
+    if (!observed()) {
+        return;
+    }
+
     SharedPoint_2r last_vertex;
     for (auto vertex : vertices_) {
         SigPopVisualPoint_2r(*vertex);
@@ -281,6 +685,10 @@ void Polyline_2r::push_back(const Point_2r& v) {
 void Polyline_2r::push_back(SharedPoint_2r v) {
     vertices_.push_back(v);
 
+    if (!observed()) {
+        return;
+    }
+
     SigRegisterPoint_2r(*v);
     SigPushVisualPoint_2r(*v, Visual::Point(mat_vertex_, z_order_));
 
@@ -291,11 +699,13 @@ void Polyline_2r::push_back(SharedPoint_2r v) {
 }
 
 void Polyline_2r::pop_back() {
-    if (vertices_.size() > 1) {
-        SigPopVisualSegment_2r(Segment_2r(back(1), back(0)));
-    }
+    if (observed()) {
+        if (vertices_.size() > 1) {
+            SigPopVisualSegment_2r(Segment_2r(back(1), back(0)));
+        }
 
-    SigPopVisualPoint_2r(*back(0));
+        SigPopVisualPoint_2r(*back(0));
+    }
 
     vertices_.pop_back();
 }
@@ -311,6 +721,10 @@ void Polyline_2r::push_front(const Point_2r& v) {
 void Polyline_2r::push_front(SharedPoint_2r v) {
     vertices_.push_front(v);
 
+    if (!observed()) {
+        return;
+    }
+
     SigRegisterPoint_2r(*v);
     SigPushVisualPoint_2r(*v, Visual::Point(mat_vertex_, z_order_));
 
@@ -321,11 +735,13 @@ void Polyline_2r::push_front(SharedPoint_2r v) {
 }
 
 void Polyline_2r::pop_front() {
-    if (vertices_.size() > 1) {
-        SigPopVisualSegment_2r(Segment_2r(front(0), front(1)));
-    }
+    if (observed()) {
+        if (vertices_.size() > 1) {
+            SigPopVisualSegment_2r(Segment_2r(front(0), front(1)));
+        }
 
-    SigPopVisualPoint_2r(*front(0));
+        SigPopVisualPoint_2r(*front(0));
+    }
 
     vertices_.pop_front();
 }
@@ -25,6 +25,9 @@
 #include "point.h"
 #include "line.h"
 #include "triangle.h"
+#include "kernel.h"
+#include "ringdeque.h"
+#include "indexpolygon.h"
 
 namespace DDAD {
 
@@ -82,6 +85,9 @@ public:
     Polygon_2r();
     ~Polygon_2r();
 
+    void AddObserver(Visual::IGeometryObserver* geom_observer) override;
+    void RemoveObserver(Visual::IGeometryObserver* geom_observer) override;
+
     void push_back(const Point_2r& v);
     void push_back(SharedPoint_2r v);
     void pop_back();
@@ -112,6 +118,369 @@ private:
 
 Polygon_2r Melkman(const Polyline_2r& P, Visual::IGeometryObserver* observer = nullptr);
 Polygon_2r IntegerHull(const Polygon_2r& P, Visual::IGeometryObserver* observer = nullptr);
+Polygon_2r IntegerHullByLatticeScan(const Polygon_2r& P);
+
+/*!
+ * @brief Melkman on the predicates of Kernel, e.g. MelkmanIndices<
+ * FloatKernel_2>(P, hull). P is a simple polyline given as any sequence
+ * with size() and operator[] whose elements are Kernel::Point_2 or point
+ * pointers. hull is a deque of indices into P, e.g. a RingDeque<size_t>,
+ * and receives the hull in counterclockwise order, with its first vertex
+ * repeated at the back as in Melkman above. It never holds more than n+1
+ * indices, so a hull reserved to that size is built without allocating.
+ */
+template <class Kernel, class Chain, class Hull>
+void MelkmanIndices(const Chain& P, Hull& hull);
+
+//! @brief Counterclockwise hull vertices of P, without repetition, using
+//! the predicates of Kernel.
+template <class Kernel>
+std::vector<typename Kernel::Point_2> Melkman(
+    const std::vector<typename Kernel::Point_2>& P);
+
+//! @brief Hull of P over the vertex pool of P, counterclockwise and without
+//! repetition. Allocates the hull deque and the result once each.
+template <class Kernel>
+IndexPolygon<typename Kernel::Point_2> Melkman(
+    const IndexPolyline<typename Kernel::Point_2>& P);
+
+//=============================================================================
+// Interface: OnlineMelkman
+//=============================================================================
+
+/*!
+ * @brief Melkman over a polyline fed one vertex at a time, for chains too
+ * large to hold in memory. Only the hull deque is kept, so memory is
+ * proportional to the largest hull seen rather than to the input, and the
+ * hull of the vertices so far can be read at any point.
+ *
+ * Unlike Melkman, the input need not be a simple polyline: GPS tracks and
+ * other trajectories cross themselves. A vertex that Melkman drops for
+ * lying in the wedge of the hull at its last vertex is checked against the
+ * hull by a binary search, in O(log h) for a hull of h vertices. Only input
+ * that comes round behind the hull fails the check, and the hull is then
+ * rebuilt around it in O(h). A simple polyline still costs O(1) amortized
+ * per vertex beyond that search, and gives the same hull as Melkman.
+ */
+template <class Kernel>
+class OnlineMelkman {
+public:
+    typedef typename Kernel::Point_2 Point_2;
+
+    OnlineMelkman();
+
+    void push_back(const Point_2& p);
+
+    //! @brief Feeds [first, last), e.g. a chunk of a memory-mapped file.
+    template <class InputIterator>
+    void Append(InputIterator first, InputIterator last);
+    void Append(const PointBufferView<typename Kernel::Number, 2>& chunk);
+
+    /*!
+     * @brief Feeds the vertices produced by source, a callable taking a
+     * Point_2& that returns false when it has no more. Returns the number
+     * of vertices read.
+     */
+    template <class Source>
+    size_t AppendFrom(Source source);
+
+    void clear();
+
+    //! @brief Counterclockwise hull of the vertices fed so far, without
+    //! repetition.
+    std::vector<Point_2> hull() const;
+    const Point_2& vertex(const size_t i) const;
+    size_t size() const;
+    //! @brief Number of vertices fed so far.
+    size_t count() const;
+
+private:
+    void AddIfOutside(const Point_2& r);
+
+    RingDeque<Point_2> hull_;
+    size_t count_;
+};
+
+//=============================================================================
+// Implementation: Kernel-templated algorithms
+//=============================================================================
+
+template <class T>
+inline const T& ChainPoint(const T& p) {
+    return p;
+}
+
+template <class T>
+inline const T& ChainPoint(const T* p) {
+    return *p;
+}
+
+template <class T>
+inline const T& ChainPoint(const std::shared_ptr<T>& p) {
+    return *p;
+}
+
+/*!
+ * @brief One step of Melkman: adds the chain vertex named by entry to a
+ * nonempty hull deque, where point(entry) is the vertex an entry stands
+ * for. The deque starts out as the first vertex. Repeats of it are skipped,
+ * and while the chain stays on one line the deque is [b, a, b] for the
+ * extreme vertices a and b seen so far, so Melkman proper only starts at the
+ * first vertex off that line. Returns false if the vertex was dropped for
+ * lying in the wedge of the hull at its last vertex, which for a simple
+ * polyline means inside the hull. Other input gives an unspecified hull,
+ * but never fewer than two entries in the deque.
+ */
+template <class Kernel, class Hull, class Entry, class Resolve>
+bool MelkmanStep(Hull& hull, const Entry& entry, Resolve point) {
+    typedef typename Kernel::Point_2 Point;
+
+    auto back = [&](size_t k) -> const Point& {
+        return point(hull[hull.size()-1-k]);
+    };
+    auto front = [&](size_t k) -> const Point& {
+        return point(hull[k]);
+    };
+
+    const Point& r = point(entry);
+    if (hull.size() == 1) {
+        if (!(r == front(0))) {
+            hull.push_front(entry);
+            hull.push_back(entry);
+        }
+        return true;
+    }
+    if (hull.size() == 3 && Kernel::OrientationPQR(front(1), front(0), r) ==
+                            ORIENTATION_COLINEAR) {
+        if (Kernel::RIsLeftOrInsidePQ(front(1), front(0), r)) {
+            return true;
+        }
+        // r replaces whichever of a and b now lies between the other two
+        bool past_b = Kernel::RIsLeftOrInsidePQ(front(1), r, front(0));
+        hull.pop_front();
+        if (past_b) {
+            hull.pop_back();
+        } else {
+            hull.pop_front();
+        }
+        hull.push_front(entry);
+        hull.push_back(entry);
+        return true;
+    }
+    if (Kernel::RIsLeftOrInsidePQ(back(1), back(0), r) &&
+        Kernel::RIsLeftOrInsidePQ(front(0), front(1), r)) {
+        return false;
+    }
+    while (hull.size() > 2 && !Kernel::RIsLeftOrInsidePQ(back(1), back(0), r)) {
+        hull.pop_back();
+    }
+    while (hull.size() > 2 &&
+           !Kernel::RIsLeftOrInsidePQ(front(0), front(1), r)) {
+        hull.pop_front();
+    }
+    hull.push_back(entry);
+    hull.push_front(entry);
+    return true;
+}
+
+template <class Kernel, class Chain, class Hull>
+void MelkmanIndices(const Chain& P, Hull& hull) {
+    typedef typename Kernel::Point_2 Point;
+    const size_t n = P.size();
+
+    if (n == 0) {
+        return;
+    }
+
+    // initialize hull
+    hull.push_back(0);
+
+    auto point = [&](size_t i) -> const Point& {
+        return ChainPoint(P[i]);
+    };
+    for (size_t i = 1; i < n; ++i) {
+        MelkmanStep<Kernel>(hull, i, point);
+    }
+}
+
+template <class Kernel>
+std::vector<typename Kernel::Point_2> Melkman(
+        const std::vector<typename Kernel::Point_2>& P) {
+    RingDeque<size_t> hull(P.size()+1);
+    MelkmanIndices<Kernel>(P, hull);
+    if (hull.size() > 1) {
+        hull.pop_back();
+    }
+
+    std::vector<typename Kernel::Point_2> vertices;
+    vertices.reserve(hull.size());
+    for (size_t i = 0; i < hull.size(); ++i) {
+        vertices.push_back(P[hull[i]]);
+    }
+    return vertices;
+}
+
+template <class Kernel>
+IndexPolygon<typename Kernel::Point_2> Melkman(
+        const IndexPolyline<typename Kernel::Point_2>& P) {
+    RingDeque<PointIndex> hull(P.size()+1);
+    MelkmanIndices<Kernel>(P, hull);
+    if (hull.size() > 1) {
+        hull.pop_back();
+    }
+
+    IndexPolygon<typename Kernel::Point_2> polygon(P.pool());
+    polygon.reserve(hull.size());
+    for (size_t i = 0; i < hull.size(); ++i) {
+        polygon.push_back(P.index(hull[i]));
+    }
+    return polygon;
+}
+
+//=============================================================================
+// Implementation: OnlineMelkman
+//=============================================================================
+
+template <class Kernel>
+inline OnlineMelkman<Kernel>::OnlineMelkman() :
+    count_(0) {}
+
+template <class Kernel>
+void OnlineMelkman<Kernel>::push_back(const Point_2& p) {
+    if (hull_.empty()) {
+        // the first vertex initializes the deque as in MelkmanIndices
+        hull_.push_back(p);
+    } else if (!MelkmanStep<Kernel>(hull_, p,
+                                    [](const Point_2& q) -> const Point_2& {
+                                        return q;
+                                    })) {
+        AddIfOutside(p);
+    }
+    ++count_;
+}
+
+template <class Kernel>
+template <class InputIterator>
+void OnlineMelkman<Kernel>::Append(InputIterator first, InputIterator last) {
+    for (; first != last; ++first) {
+        push_back(*first);
+    }
+}
+
+template <class Kernel>
+void OnlineMelkman<Kernel>::Append(
+        const PointBufferView<typename Kernel::Number, 2>& chunk) {
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        push_back(chunk.point(i));
+    }
+}
+
+template <class Kernel>
+template <class Source>
+size_t OnlineMelkman<Kernel>::AppendFrom(Source source) {
+    size_t read = 0;
+    Point_2 p;
+    while (source(p)) {
+        push_back(p);
+        ++read;
+    }
+    return read;
+}
+
+/*!
+ * @brief Adds r, which lies in the wedge of the hull at its last vertex d,
+ * if it is outside the hull. The hull vertices v[1], ..., v[m-2] of the
+ * deque d, v[1], ..., v[m-2], d fan out counterclockwise around d, so a
+ * binary search finds the edge v[i] v[i+1] facing r. If r is outside it,
+ * the edges r sees form a run around that one that does not reach d, and
+ * the deque is rebuilt as r, the hull from the end of that run round to its
+ * start, and r again.
+ */
+template <class Kernel>
+void OnlineMelkman<Kernel>::AddIfOutside(const Point_2& r) {
+    const size_t m = hull_.size();
+    assert(m >= 4);
+    const Point_2& d = hull_[0];
+
+    // largest i with r not to the right of the ray from d through v[i]
+    size_t i = 1;
+    size_t hi = m-2;
+    while (i < hi) {
+        size_t mid = (i+hi+1)/2;
+        if (Kernel::OrientationPQR(d, hull_[mid], r) != ORIENTATION_RIGHT) {
+            i = mid;
+        } else {
+            hi = mid-1;
+        }
+    }
+    if (i == m-2 || Kernel::RIsLeftOrInsidePQ(hull_[i], hull_[i+1], r)) {
+        return;
+    }
+
+    size_t first = i;
+    size_t last = i+1;
+    while (first > 1 &&
+           !Kernel::RIsLeftOrInsidePQ(hull_[first-1], hull_[first], r)) {
+        --first;
+    }
+    while (last < m-2 &&
+           !Kernel::RIsLeftOrInsidePQ(hull_[last], hull_[last+1], r)) {
+        ++last;
+    }
+
+    std::vector<Point_2> vertices;
+    vertices.reserve(m-(last-first)+2);
+    vertices.push_back(r);
+    for (size_t k = last; k < m-1; ++k) {
+        vertices.push_back(hull_[k]);
+    }
+    for (size_t k = 0; k <= first; ++k) {
+        vertices.push_back(hull_[k]);
+    }
+    vertices.push_back(r);
+
+    hull_.clear();
+    for (const Point_2& v : vertices) {
+        hull_.push_back(v);
+    }
+}
+
+template <class Kernel>
+inline void OnlineMelkman<Kernel>::clear() {
+    hull_.clear();
+    count_ = 0;
+}
+
+// Accessors/Mutators =========================================================
+
+template <class Kernel>
+std::vector<typename OnlineMelkman<Kernel>::Point_2>
+OnlineMelkman<Kernel>::hull() const {
+    std::vector<Point_2> vertices;
+    vertices.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        vertices.push_back(hull_[i]);
+    }
+    return vertices;
+}
+
+template <class Kernel>
+inline const typename OnlineMelkman<Kernel>::Point_2&
+OnlineMelkman<Kernel>::vertex(const size_t i) const {
+    assert(i < size());
+    return hull_[i];
+}
+
+template <class Kernel>
+inline size_t OnlineMelkman<Kernel>::size() const {
+    // the deque repeats its front vertex at the back
+    return hull_.size() > 1 ? hull_.size()-1 : hull_.size();
+}
+
+template <class Kernel>
+inline size_t OnlineMelkman<Kernel>::count() const {
+    return count_;
+}
 
 } // namespace DDAD
 
@@ -16,9 +16,11 @@
 #include "common.h"
 #include "arithmetic.h"
 #include "matrix.h"
+#include "lattice.h"
 #include "polytope.h"
 #include "intersection.h"
 #include "quadedge.h"
+#include "mempool.h"
 
 namespace DDAD {
 
@@ -447,221 +449,6 @@ Polytope_3r IntegerHull(const Polytope_3r& P) {
     return Polytope_3r();
 }
 
-/*!
- * Input: A vector v whose components are relatively prime. A 3x3 unimodular
- * matrix B whose rows form a basis for Z^3.
- *
- * Output: Either a unimodular matrix B' with one row equal to v, or the
- * identity matrix if no such matrix can be found.
- *
- * Invariants: Every matrix given to a recursive call is unimodular.
- *
- * Notes: Unimodular means det(B) = +-1. split basis into 6 tetrahedra.
- * rewrite vector in terms of input basis. sort vector coordinates by
- * magnitude. use the ordering to determine which of the 6 tetrahedra the
- * vector lies within, and branch accordingly.
- */
-Matrix_3x3i UnimodularBasisForVector_r(const Vector_3i& v,
-                                       const Matrix_3x3i& B) {
-
-    // base case: the input basis contains the vector
-    if (RowVec(B, 0) == v || RowVec(B, 1) == v || RowVec(B, 2) == v) {
-        assert(Determinant(B) == 1 || Determinant(B) == -1);
-        assert(GCD(RowVec(B, 0)) == 1);
-        assert(GCD(RowVec(B, 1)) == 1);
-        assert(GCD(RowVec(B, 2)) == 1);
-        return B;
-    }
-
-    Vector_3i vPrime = v*Inverse(B);
-    Matrix_3x3i BPrime = B;
-
-    // sort vPrime's components and keep track of indices
-    std::array<std::pair<integer, size_t>, 3> vPrimeElts;
-    vPrimeElts[0].first = vPrime.x(); vPrimeElts[0].second = 0;
-    vPrimeElts[1].first = vPrime.y(); vPrimeElts[1].second = 1;
-    vPrimeElts[2].first = vPrime.z(); vPrimeElts[2].second = 2;
-    std::sort(begin(vPrimeElts), end(vPrimeElts), []
-    (const std::pair<integer, size_t>& lhs,
-     const std::pair<integer, size_t>& rhs) {
-        return lhs.first < rhs.first;
-    });
-
-    BPrime(vPrimeElts[0].second, 0) += BPrime(vPrimeElts[2].second, 0);
-    BPrime(vPrimeElts[0].second, 1) += BPrime(vPrimeElts[2].second, 1);
-    BPrime(vPrimeElts[0].second, 2) += BPrime(vPrimeElts[2].second, 2);
-
-    BPrime(vPrimeElts[0].second, 0) += BPrime(vPrimeElts[1].second, 0);
-    BPrime(vPrimeElts[0].second, 1) += BPrime(vPrimeElts[1].second, 1);
-    BPrime(vPrimeElts[0].second, 2) += BPrime(vPrimeElts[1].second, 2);
-
-    BPrime(vPrimeElts[1].second, 0) += BPrime(vPrimeElts[2].second, 0);
-    BPrime(vPrimeElts[1].second, 1) += BPrime(vPrimeElts[2].second, 1);
-    BPrime(vPrimeElts[1].second, 2) += BPrime(vPrimeElts[2].second, 2);
-
-    return UnimodularBasisForVector_r(v, BPrime);
-}
-
-/*!
- * See comments for recursive function above.
- */
-Matrix_3x3i UnimodularBasisForVector(const Vector_3i& v) {
-    // correctly orient starting basis
-    Matrix_3x3i signMat(v.x() < 0 ? -1 : 1, 0, 0,
-                        0, v.y() < 0 ? -1 : 1, 0,
-                        0, 0, v.z() < 0 ? -1 : 1);
-
-    // recursively find a basis starting with the identity
-    return UnimodularBasisForVector_r(RemoveGCD(v), signMat);
-}
-
-Matrix_2x2i UnimodularBasisForVector_r(const Vector_2i& v,
-                                       const Matrix_2x2i& B) {
-    // base case: the input basis contains the vector
-    if (RowVec(B, 0) == v || RowVec(B, 1) == v) {
-        assert(Determinant(B) == 1 || Determinant(B) == -1);
-        assert(GCD(RowVec(B, 0)) == 1);
-        assert(GCD(RowVec(B, 1)) == 1);
-        return B;
-    }
-
-    Vector_2i vPrime = v*Inverse(B);
-    Matrix_2x2i BPrime = B;
-
-    if (vPrime.x() > vPrime.y()) {
-        BPrime(1, 0) += BPrime(0, 0);
-        BPrime(1, 1) += BPrime(0, 1);
-    } else {
-        BPrime(0, 0) += BPrime(1, 0);
-        BPrime(0, 1) += BPrime(1, 1);
-    }
-
-    return UnimodularBasisForVector_r(v, BPrime);
-}
-
-Matrix_2x2i UnimodularBasisForVector(const Vector_2i& v) {
-    // correctly orient starting basis
-    Matrix_2x2i signMat(v.x() < 0 ? -1 : 1, 0,
-                        0, v.y() < 0 ? -1 : 1);
-
-    // recursively find a basis starting with the identity
-    return UnimodularBasisForVector_r(RemoveGCD(v), signMat);
-}
-
-/*!
- * Iterative version of unimodular basis for vector.
- */
-Matrix_3x3i UnimodularBasisForVectorItr(const Vector_3i& v) {
-    auto shortV = RemoveGCD(v);
-
-    // correctly orient starting basis
-    Matrix_3x3i basis(shortV.x() < 0 ? -1 : 1, 0, 0,
-                      0, shortV.y() < 0 ? -1 : 1, 0,
-                      0, 0, shortV.z() < 0 ? -1 : 1);
-
-    while (RowVec(basis, 0) != shortV && RowVec(basis, 1) != shortV &&
-           RowVec(basis, 2) != shortV) {
-        // rewrite v in the newest basis
-        Vector_3i vPrime = shortV*Inverse(basis);
-
-        // sort vPrime's components and keep track of indices
-        std::array<std::pair<integer, size_t>, 3> vPrimeElts;
-        vPrimeElts[0].first = vPrime.x(); vPrimeElts[0].second = 0;
-        vPrimeElts[1].first = vPrime.y(); vPrimeElts[1].second = 1;
-        vPrimeElts[2].first = vPrime.z(); vPrimeElts[2].second = 2;
-        std::sort(begin(vPrimeElts), end(vPrimeElts), []
-        (const std::pair<integer, size_t>& lhs,
-         const std::pair<integer, size_t>& rhs) {
-            return lhs.first < rhs.first;
-        });
-
-//        basis(vPrimeElts[0].second, 0) += basis(vPrimeElts[2].second, 0);
-//        basis(vPrimeElts[0].second, 1) += basis(vPrimeElts[2].second, 1);
-//        basis(vPrimeElts[0].second, 2) += basis(vPrimeElts[2].second, 2);
-
-//        basis(vPrimeElts[0].second, 0) += basis(vPrimeElts[1].second, 0);
-//        basis(vPrimeElts[0].second, 1) += basis(vPrimeElts[1].second, 1);
-//        basis(vPrimeElts[0].second, 2) += basis(vPrimeElts[1].second, 2);
-
-        basis(vPrimeElts[1].second, 0) += basis(vPrimeElts[2].second, 0);
-        basis(vPrimeElts[1].second, 1) += basis(vPrimeElts[2].second, 1);
-        basis(vPrimeElts[1].second, 2) += basis(vPrimeElts[2].second, 2);
-    }
-
-    // permute the rows such that v is always the first
-    /*
-    int row;
-    if (RowVec(basis, 0) == shortV) {
-        row = 0;
-    } else if (RowVec(basis, 1) == shortV) {
-        row = 1;
-    } else {
-        row = 2;
-    }
-    */
-
-    // verify output assumptions
-    assert(Determinant(basis) == 1 || Determinant(basis) == -1);
-    assert(GCD(RowVec(basis, 0)) == 1);
-    assert(GCD(RowVec(basis, 1)) == 1);
-    assert(GCD(RowVec(basis, 2)) == 1);
-
-    // two rows must be bounded by input length
-
-    return basis;
-}
-
-Matrix_2x2i UnimodularBasisForVectorItr(const Vector_2i& v) {
-    auto shortV = RemoveGCD(v);
-
-    // correctly orient starting basis
-    Matrix_2x2i basis(shortV.x() < 0 ? -1 : 1, 0,
-                      0, shortV.y() < 0 ? -1 : 1);
-
-    while (RowVec(basis, 0) != shortV && RowVec(basis, 1) != shortV) {
-        Vector_2i vPrime = shortV*Inverse(basis);
-
-        if (vPrime.x() > vPrime.y()) {
-            basis(1, 0) += basis(0, 0);
-            basis(1, 1) += basis(0, 1);
-        } else {
-            basis(0, 0) += basis(1, 0);
-            basis(0, 1) += basis(1, 1);
-        }
-    }
-
-    // verify output assumptions
-    assert(Determinant(basis) == 1 || Determinant(basis) == -1);
-    assert(GCD(RowVec(basis, 0)) == 1);
-    assert(GCD(RowVec(basis, 1)) == 1);
-
-    return basis;
-}
-
-Matrix_3x3i UnimodularBasisForPlane(const Vector_3i& u, const Vector_3i& v) {
-    std::cout << "Starting UnimodularBasisForPlane with u = "
-              << u << " and v = " << v << std::endl;
-
-    // bring u into a unimodular basis
-    auto basisU = UnimodularBasisForVectorItr(u);
-    std::cout << "UnimodularBasisForVectorItr produced basisU = \n"
-              << basisU << std::endl;
-
-    // rewrite v in terms of u's basis
-    auto vPrime = v*Inverse(basisU);
-    std::cout << "vPrime " << vPrime << std::endl;
-
-    // bring v into a unimodular basis
-    auto basisV = UnimodularBasisForVectorItr(Vector_2i(vPrime.y(),
-                                                        vPrime.z()));
-    std::cout << "UnimodularBasisForVectorItr produced basisV = \n"
-              << basisV << std::endl;
-
-    return Matrix_3x3i(1, 0, 0,
-                       0, basisV(0,0), basisV(0,1),
-                       0, basisV(1,0), basisV(1,1))*basisU;
-}
-
 
 
 namespace Construction {
@@ -694,6 +481,7 @@ Polytope_3r IntegerHull(const Polytope_3r& P) {
  * of the original region.
  */
 void ihull() {
+    ArithmeticPoolScope pool;
 
     // create plane P from three rational points
     auto planeptP0 = std::make_shared<Point_3r>(1, 2, 0);
@@ -736,15 +524,18 @@ void ihull() {
 
     // compute a basis in which L is the x axis and P is parallel to the
     // xy coordinate plane
-    auto basisFinal = UnimodularBasisForPlane(linevecL, spanvecP0);
-    std::cout << "UnimodularBasisForPlane produced \n" << basisFinal << std::endl;
-
-    auto inverseBasis = Inverse(basisFinal);
+    UnimodularTransform_3i transform(UnimodularBasisForPlane(linevecL,
+                                                             spanvecP0));
+    std::cout << "UnimodularBasisForPlane produced \n" << transform.basis()
+              << std::endl;
 
     // rewrite P's points
-    auto planeptP0Prime = std::make_shared<Point_3r>(*planeptP0*inverseBasis);
-    auto planeptP1Prime = std::make_shared<Point_3r>(*planeptP1*inverseBasis);
-    auto planeptP2Prime = std::make_shared<Point_3r>(*planeptP2*inverseBasis);
+    auto planeptP0Prime = std::make_shared<Point_3r>(
+        transform.ToBasis(*planeptP0));
+    auto planeptP1Prime = std::make_shared<Point_3r>(
+        transform.ToBasis(*planeptP1));
+    auto planeptP2Prime = std::make_shared<Point_3r>(
+        transform.ToBasis(*planeptP2));
 
     std::cout << "planeptP0Prime: " << *planeptP0Prime << std::endl;
     std::cout << "planeptP1Prime: " << *planeptP1Prime << std::endl;
@@ -759,9 +550,12 @@ void ihull() {
     // todo : compute line
 
     // rewrite Q's points
-    auto planeptQ0Prime = std::make_shared<Point_3r>(*planeptQ0*inverseBasis);
-    auto planeptQ1Prime = std::make_shared<Point_3r>(*planeptQ1*inverseBasis);
-    auto planeptQ2Prime = std::make_shared<Point_3r>(*planeptQ2*inverseBasis);
+    auto planeptQ0Prime = std::make_shared<Point_3r>(
+        transform.ToBasis(*planeptQ0));
+    auto planeptQ1Prime = std::make_shared<Point_3r>(
+        transform.ToBasis(*planeptQ1));
+    auto planeptQ2Prime = std::make_shared<Point_3r>(
+        transform.ToBasis(*planeptQ2));
 
     std::cout << "planeptQ0Prime: " << *planeptQ0Prime << std::endl;
     std::cout << "planeptQ1Prime: " << *planeptQ1Prime << std::endl;
@@ -780,7 +574,7 @@ void ihull() {
 
 
     // compute a unimodular basis with L's direction vector
-    auto basisL = UnimodularBasisForVectorItr(linevecL);
+    auto basisL = UnimodularCompletion(linevecL);
     std::cout << "basisL\n" << basisL << std::endl;
 
 
@@ -798,7 +592,7 @@ void ihull() {
     Matrix_3x3i basis3P0;
     if (RowVec(basisL, 0) == linevecL) {
         std::cout << "row0" << std::endl;
-        basis2P0 = UnimodularBasisForVectorItr(Vector_2i(spanvecP0Prime.y(),
+        basis2P0 = UnimodularCompletion(Vector_2i(spanvecP0Prime.y(),
                                                          spanvecP0Prime.z()));
         basis3P0 = Matrix_3x3i(1, 0, 0,
                                0, basis2P0(0,0), basis2P0(0,1),
@@ -807,7 +601,7 @@ void ihull() {
 
     } else if (RowVec(basisL, 1) == linevecL) {
         std::cout << "row1" << std::endl;
-        basis2P0 = UnimodularBasisForVectorItr(Vector_2i(spanvecP0Prime.x(),
+        basis2P0 = UnimodularCompletion(Vector_2i(spanvecP0Prime.x(),
                                                          spanvecP0Prime.z()));
         basis3P0 = Matrix_3x3i(0, basis2P0(0,0), basis2P0(0,1),
                                1, 0, 0,
@@ -815,7 +609,7 @@ void ihull() {
         assert(Determinant(basis3P0) == 1 || Determinant(basis3P0) == -1);
     } else {
         std::cout << "row2" << std::endl;
-        basis2P0 = UnimodularBasisForVectorItr(Vector_2i(spanvecP0Prime.x(),
+        basis2P0 = UnimodularCompletion(Vector_2i(spanvecP0Prime.x(),
                                                          spanvecP0Prime.y()));
         basis3P0 = Matrix_3x3i(0, basis2P0(0,0), basis2P0(0,1),
                                0, basis2P0(1,0), basis2P0(1,1),
@@ -904,7 +698,7 @@ void ihull() {
 
     // first we consider just one vector, it can be either but we choose V0.
 
-    auto V0Basis = UnimodularBasisForVector(planeV0);
+    auto V0Basis = UnimodularCompletion(planeV0);
     std::cout << "V0Basis\n" << V0Basis << std::endl;
 
     auto invV0Basis = Inverse(V0Basis);
@@ -916,13 +710,13 @@ void ihull() {
 
     Matrix_2x2i V1Basis2;
     if (planeV0prime.x() != 0) {
-        V1Basis2 = UnimodularBasisForVector(Vector_2i(planeV1prime.y(),
+        V1Basis2 = UnimodularCompletion(Vector_2i(planeV1prime.y(),
                                                       planeV1prime.z()));
     } else if (planeV0prime.y() != 0) {
-        V1Basis2 = UnimodularBasisForVector(Vector_2i(planeV1prime.x(),
+        V1Basis2 = UnimodularCompletion(Vector_2i(planeV1prime.x(),
                                                       planeV1prime.z()));
     } else {
-        V1Basis2 = UnimodularBasisForVector(Vector_2i(planeV1prime.x(),
+        V1Basis2 = UnimodularCompletion(Vector_2i(planeV1prime.x(),
                                                       planeV1prime.y()));
     }
 
@@ -17,27 +17,264 @@
 #include "point.h"
 #include "matrix.h"
 #include "predicate.h"
+#include "expansion.h"
+#include "vectorexpr.h"
+
+#include <atomic>
 
 namespace DDAD {
 
 namespace Predicate {
 
-Orientation OrientationPQR(const Point_2i &p, const Point_2i &q,
-                           const Point_2i &r) {
-    rational det = Determinant(Matrix_2x2r(q.x()-p.x(), q.y()-p.y(),
-                                           r.x()-p.x(), r.y()-p.y()));
+//=============================================================================
+// Implementation: Filtered evaluation
+//=============================================================================
 
-    if (det > 0) {
+// Error bound coefficients from Shewchuk, "Adaptive Precision Floating-Point
+// Arithmetic and Fast Robust Geometric Predicates", with epsilon = 2^-53.
+static const double kEpsilon = 1.1102230246251565e-16;
+static const double kOrientErrBound = (3.0+16.0*kEpsilon)*kEpsilon;
+static const double kInCircleErrBound = (10.0+96.0*kEpsilon)*kEpsilon;
+
+static std::atomic<bool> s_filtering_enabled(true);
+static thread_local FilterStats s_filter_stats[FILTERED_PREDICATE_COUNT];
+
+void set_filtering_enabled(const bool enabled) {
+    s_filtering_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool filtering_enabled() {
+    return s_filtering_enabled.load(std::memory_order_relaxed);
+}
+
+FilterStats filter_stats(const FilteredPredicate predicate) {
+    return s_filter_stats[predicate];
+}
+
+void ResetFilterStats() {
+    for (auto& stats : s_filter_stats) {
+        stats.evaluations = 0;
+        stats.failures = 0;
+    }
+}
+
+//! @brief Converts x to a double if that can be done without rounding.
+static bool ToExactDouble(const integer& x, double& d) {
+    if (mpz_sizeinbase(x.get_mpz_t(), 2) > 53) {
+        return false;
+    }
+    d = mpz_get_d(x.get_mpz_t());
+    return true;
+}
+
+#ifdef DDAD_SMALL_RATIONAL
+static bool ToExactDouble(const SmallRational& x, double& d) {
+    if (!x.is_small() || !x.is_integer()) {
+        return false;
+    }
+    d = x.get_d();
+    return std::fabs(d) < 9007199254740992.0; // 2^53
+}
+#else
+static bool ToExactDouble(const mpq_class& x, double& d) {
+    if (mpz_cmp_ui(x.get_den_mpz_t(), 1) != 0 ||
+        mpz_sizeinbase(x.get_num_mpz_t(), 2) > 53) {
+        return false;
+    }
+    d = mpz_get_d(x.get_num_mpz_t());
+    return true;
+}
+#endif
+
+template <class T>
+static bool ToExactDouble(const Profiled<T>& x, double& d) {
+    return ToExactDouble(x.value(), d);
+}
+
+template <class Point>
+static bool ToExactDouble(const Point& p, double& x, double& y) {
+    return ToExactDouble(p.x(), x) && ToExactDouble(p.y(), y);
+}
+
+/*!
+ * @brief Sign of (ax-cx)(by-cy)-(ay-cy)(bx-cx) evaluated in double precision.
+ * \return false if the sign cannot be certified.
+ */
+static bool FilteredOrient2D(const double ax, const double ay,
+                             const double bx, const double by,
+                             const double cx, const double cy, Sign& sign) {
+    double detl = (ax-cx)*(by-cy);
+    double detr = (ay-cy)*(bx-cx);
+    double det = detl-detr;
+    double errbound = kOrientErrBound*(std::fabs(detl)+std::fabs(detr));
+
+    if (det > errbound) {
+        sign = SIGN_POSITIVE;
+        return true;
+    } else if (-det > errbound) {
+        sign = SIGN_NEGATIVE;
+        return true;
+    }
+    return false;
+}
+
+/*!
+ * @brief Sign of the lifted incircle determinant evaluated in double
+ * precision. \return false if the sign cannot be certified.
+ */
+static bool FilteredInCircle(const double ax, const double ay,
+                             const double bx, const double by,
+                             const double cx, const double cy,
+                             const double dx, const double dy, Sign& sign) {
+    double adx = ax-dx, ady = ay-dy;
+    double bdx = bx-dx, bdy = by-dy;
+    double cdx = cx-dx, cdy = cy-dy;
+
+    double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy;
+    double cdxady = cdx*ady, adxcdy = adx*cdy;
+    double adxbdy = adx*bdy, bdxady = bdx*ady;
+    double alift = adx*adx+ady*ady;
+    double blift = bdx*bdx+bdy*bdy;
+    double clift = cdx*cdx+cdy*cdy;
+
+    double det = alift*(bdxcdy-cdxbdy)+
+                 blift*(cdxady-adxcdy)+
+                 clift*(adxbdy-bdxady);
+    double permanent = (std::fabs(bdxcdy)+std::fabs(cdxbdy))*alift+
+                       (std::fabs(cdxady)+std::fabs(adxcdy))*blift+
+                       (std::fabs(adxbdy)+std::fabs(bdxady))*clift;
+    double errbound = kInCircleErrBound*permanent;
+
+    if (det > errbound) {
+        sign = SIGN_POSITIVE;
+        return true;
+    } else if (-det > errbound) {
+        sign = SIGN_NEGATIVE;
+        return true;
+    }
+    return false;
+}
+
+static Orientation ToOrientation(const Sign sign) {
+    switch (sign) {
+    case SIGN_POSITIVE:
         return ORIENTATION_LEFT;
-    } else if (det < 0) {
+    case SIGN_NEGATIVE:
         return ORIENTATION_RIGHT;
-    } else {
+    default:
         return ORIENTATION_COLINEAR;
     }
 }
 
+static Sign ToSign(const rational& x) {
+    int s = sgn(x);
+    return s > 0 ? SIGN_POSITIVE : (s < 0 ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+//=============================================================================
+// Implementation: Integer evaluation
+//=============================================================================
+
+// Largest coordinate bit lengths the fixed-width integer predicates accept.
+static const int kOrientInt64Bits =
+    MaxInputBits<PREDICATE_ORIENT_2D, 64>::value;
+static const int kInCircleInt64Bits =
+    MaxInputBits<PREDICATE_IN_CIRCLE, 64>::value;
+static_assert(kOrientInt64Bits == 30 && kInCircleInt64Bits == 13,
+              "int64 predicate budgets changed");
+#if DDAD_HAS_INT128
+static const int kOrientInt128Bits =
+    MaxInputBits<PREDICATE_ORIENT_2D, 128>::value;
+static const int kInCircleInt128Bits =
+    MaxInputBits<PREDICATE_IN_CIRCLE, 128>::value;
+static_assert(kOrientInt128Bits == 62 && kInCircleInt128Bits == 29,
+              "int128 predicate budgets changed");
+#endif
+
+//! @brief True if |x|, |y| < 2^bits for every point.
+template <class Point>
+static bool CoordinatesFit(const int bits, const Point& a, const Point& b,
+                           const Point& c) {
+    return IntegerFits(a.x(), bits) && IntegerFits(a.y(), bits) &&
+           IntegerFits(b.x(), bits) && IntegerFits(b.y(), bits) &&
+           IntegerFits(c.x(), bits) && IntegerFits(c.y(), bits);
+}
+
+template <class Point>
+static bool CoordinatesFit(const int bits, const Point& a, const Point& b,
+                           const Point& c, const Point& d) {
+    return CoordinatesFit(bits, a, b, c) &&
+           IntegerFits(d.x(), bits) && IntegerFits(d.y(), bits);
+}
+
+//! @brief Copies x and y of p into out if both are integers.
+static bool ToIntegerXY(const Point_3r& p, Point_3i& out) {
+    if (p.x().get_den() != 1 || p.y().get_den() != 1) {
+        return false;
+    }
+    out.set_x(p.x().get_num());
+    out.set_y(p.y().get_num());
+    return true;
+}
+
+//=============================================================================
+// Implementation: Predicates
+//=============================================================================
+
+/*!
+ * Coordinates below 2^30 are decided exactly in 64-bit integers without
+ * consulting the filter. Otherwise the filter runs first, then 128-bit
+ * integers where available, then integer arithmetic.
+ */
+Orientation OrientationPQR(const Point_2i &p, const Point_2i &q,
+                           const Point_2i &r) {
+    DDAD_PROFILE_SITE("Predicate::OrientationPQR(Point_2i)");
+    if (CoordinatesFit(kOrientInt64Bits, p, q, r)) {
+        return OrientationPQR<kOrientInt64Bits>(p, q, r);
+    }
+
+    FilterStats& stats = s_filter_stats[FILTERED_ORIENTATION_PQR];
+    ++stats.evaluations;
+
+    double px, py, qx, qy, rx, ry;
+    Sign sign;
+    if (filtering_enabled() &&
+        ToExactDouble(p, px, py) &&
+        ToExactDouble(q, qx, qy) &&
+        ToExactDouble(r, rx, ry) &&
+        FilteredOrient2D(qx, qy, rx, ry, px, py, sign)) {
+        return ToOrientation(sign);
+    }
+    ++stats.failures;
+
+#if DDAD_HAS_INT128
+    if (CoordinatesFit(kOrientInt128Bits, p, q, r)) {
+        return OrientationPQR<kOrientInt128Bits>(p, q, r);
+    }
+#endif
+    return ToOrientation(SignOfDeterminant(Matrix_2x2i(
+        q.x()-p.x(), q.y()-p.y(),
+        r.x()-p.x(), r.y()-p.y()
+    )));
+}
+
 Orientation OrientationPQR(const Point_2r &p, const Point_2r &q,
                            const Point_2r &r) {
+    DDAD_PROFILE_SITE("Predicate::OrientationPQR(Point_2r)");
+    FilterStats& stats = s_filter_stats[FILTERED_ORIENTATION_PQR];
+    ++stats.evaluations;
+
+    double px, py, qx, qy, rx, ry;
+    Sign sign;
+    if (filtering_enabled() &&
+        ToExactDouble(p, px, py) &&
+        ToExactDouble(q, qx, qy) &&
+        ToExactDouble(r, rx, ry) &&
+        FilteredOrient2D(qx, qy, rx, ry, px, py, sign)) {
+        return ToOrientation(sign);
+    }
+    ++stats.failures;
+
     rational det = Determinant(Matrix_2x2r(q.x()-p.x(), q.y()-p.y(),
                                            r.x()-p.x(), r.y()-p.y()));
 
@@ -52,16 +289,19 @@ Orientation OrientationPQR(const Point_2r &p, const Point_2r &q,
 
 Orientation OrientationPQR(const Point_2f &p, const Point_2f &q,
                            const Point_2f &r) {
-    rational det = Determinant(Matrix_2x2r(q.x()-p.x(), q.y()-p.y(),
-                                           r.x()-p.x(), r.y()-p.y()));
+    DDAD_PROFILE_SITE("Predicate::OrientationPQR(Point_2f)");
+    FilterStats& stats = s_filter_stats[FILTERED_ORIENTATION_PQR];
+    ++stats.evaluations;
 
-    if (det > 0) {
-        return ORIENTATION_LEFT;
-    } else if (det < 0) {
-        return ORIENTATION_RIGHT;
-    } else {
-        return ORIENTATION_COLINEAR;
+    Sign sign;
+    if (filtering_enabled() &&
+        FilteredOrient2D(q.x(), q.y(), r.x(), r.y(), p.x(), p.y(), sign)) {
+        return ToOrientation(sign);
     }
+    ++stats.failures;
+
+    // exact on float input without resorting to rationals
+    return ToOrientation(Orient2DSign(p, q, r));
 }
 
 bool RIsLeftOrInsidePQ(const Point_2r &p, const Point_2r &q,
@@ -70,16 +310,145 @@ bool RIsLeftOrInsidePQ(const Point_2r &p, const Point_2r &q,
 
     bool is_left = orientation == ORIENTATION_LEFT;
 
-    auto v0 = q-p;
-    auto v1 = r-p;
-    auto dist = Dot(v0, v1);
-    //LOG(INFO) << v0 << v1 << dist;
-
-    bool is_inside = orientation == ORIENTATION_COLINEAR && dist >= 0 && dist <= Dot(v0, v0);
+    // r lies inside pq iff 0 <= (q-p).(r-p) <= (q-p).(q-p)
+    bool is_inside = false;
+    if (orientation == ORIENTATION_COLINEAR) {
+        rational dist = Dot(Expr(q)-Expr(p), Expr(r)-Expr(p));
+        is_inside = dist >= 0 &&
+                    dist <= Dot(Expr(q)-Expr(p), Expr(q)-Expr(p));
+    }
 
     return is_left || is_inside;
 }
 
+Sign Orient2DSign(const Point_3r& a, const Point_3r& b, const Point_3r& c) {
+    DDAD_PROFILE_SITE("Predicate::Orient2DSign");
+    FilterStats& stats = s_filter_stats[FILTERED_ORIENT_2D];
+    ++stats.evaluations;
+
+    double ax, ay, bx, by, cx, cy;
+    Sign sign;
+    if (filtering_enabled() &&
+        ToExactDouble(a, ax, ay) &&
+        ToExactDouble(b, bx, by) &&
+        ToExactDouble(c, cx, cy) &&
+        FilteredOrient2D(ax, ay, bx, by, cx, cy, sign)) {
+        return sign;
+    }
+    ++stats.failures;
+
+    Point_3i ai, bi, ci;
+    if (ToIntegerXY(a, ai) && ToIntegerXY(b, bi) && ToIntegerXY(c, ci)) {
+        return Orient2DSign(ai, bi, ci);
+    }
+    return ToSign(Orient2D(a, b, c));
+}
+
+Sign InCircleSign(const Point_3r& a, const Point_3r& b, const Point_3r& c,
+                  const Point_3r& d) {
+    DDAD_PROFILE_SITE("Predicate::InCircleSign");
+    FilterStats& stats = s_filter_stats[FILTERED_IN_CIRCLE];
+    ++stats.evaluations;
+
+    double ax, ay, bx, by, cx, cy, dx, dy;
+    Sign sign;
+    if (filtering_enabled() &&
+        ToExactDouble(a, ax, ay) &&
+        ToExactDouble(b, bx, by) &&
+        ToExactDouble(c, cx, cy) &&
+        ToExactDouble(d, dx, dy) &&
+        FilteredInCircle(ax, ay, bx, by, cx, cy, dx, dy, sign)) {
+        return sign;
+    }
+    ++stats.failures;
+
+    Point_3i ai, bi, ci, di;
+    if (ToIntegerXY(a, ai) && ToIntegerXY(b, bi) && ToIntegerXY(c, ci) &&
+        ToIntegerXY(d, di)) {
+        return InCircleSign(ai, bi, ci, di);
+    }
+    rational m00 = a.x()-d.x();
+    rational m01 = a.y()-d.y();
+    rational m10 = b.x()-d.x();
+    rational m11 = b.y()-d.y();
+    rational m20 = c.x()-d.x();
+    rational m21 = c.y()-d.y();
+    return SignOfDeterminant(Matrix_3x3r(
+        m00, m01, m00*m00+m01*m01,
+        m10, m11, m10*m10+m11*m11,
+        m20, m21, m20*m20+m21*m21
+    ));
+}
+
+//! The sign of det[a-d; b-d; c-d].
+Sign Orient3DSign(const Point_3r& a, const Point_3r& b, const Point_3r& c,
+                  const Point_3r& d) {
+    DDAD_PROFILE_SITE("Predicate::Orient3DSign");
+    return SignOfDeterminant(Matrix_3x3r(
+        a.x()-d.x(), a.y()-d.y(), a.z()-d.z(),
+        b.x()-d.x(), b.y()-d.y(), b.z()-d.z(),
+        c.x()-d.x(), c.y()-d.y(), c.z()-d.z()
+    ));
+}
+
+//! The sign of the 4x4 determinant with rows (p-e, |p-e|^2) for p = a, b,
+//! c, d.
+Sign InSphereSign(const Point_3r& a, const Point_3r& b, const Point_3r& c,
+                  const Point_3r& d, const Point_3r& e) {
+    DDAD_PROFILE_SITE("Predicate::InSphereSign");
+    const Point_3r* rows[4] = { &a, &b, &c, &d };
+    Matrix_4x4r mat;
+    for (int i = 0; i < 4; ++i) {
+        rational& lift = mat(i,3);
+        lift = 0;
+        for (int j = 0; j < 3; ++j) {
+            mat(i,j) = (*rows[i])[j]-e[j];
+            lift += mat(i,j)*mat(i,j);
+        }
+    }
+    return SignOfDeterminant(mat);
+}
+
+Sign Orient2DSign(const Point_3i& a, const Point_3i& b, const Point_3i& c) {
+    DDAD_PROFILE_SITE("Predicate::Orient2DSign(Point_3i)");
+    if (CoordinatesFit(kOrientInt64Bits, a, b, c)) {
+        return Orient2DSign<kOrientInt64Bits>(a, b, c);
+    }
+#if DDAD_HAS_INT128
+    if (CoordinatesFit(kOrientInt128Bits, a, b, c)) {
+        return Orient2DSign<kOrientInt128Bits>(a, b, c);
+    }
+#endif
+    return SignOfDeterminant(Matrix_2x2i(
+        a.x()-c.x(), a.y()-c.y(),
+        b.x()-c.x(), b.y()-c.y()
+    ));
+}
+
+Sign InCircleSign(const Point_3i& a, const Point_3i& b, const Point_3i& c,
+                  const Point_3i& d) {
+    DDAD_PROFILE_SITE("Predicate::InCircleSign(Point_3i)");
+    if (CoordinatesFit(kInCircleInt64Bits, a, b, c, d)) {
+        return InCircleSign<kInCircleInt64Bits>(a, b, c, d);
+    }
+#if DDAD_HAS_INT128
+    if (CoordinatesFit(kInCircleInt128Bits, a, b, c, d)) {
+        return InCircleSign<kInCircleInt128Bits>(a, b, c, d);
+    }
+#endif
+    integer m00 = a.x()-d.x();
+    integer m01 = a.y()-d.y();
+    integer m10 = b.x()-d.x();
+    integer m11 = b.y()-d.y();
+    integer m20 = c.x()-d.x();
+    integer m21 = c.y()-d.y();
+    return SignOfDeterminant(Matrix_3x3i(
+        m00, m01, m00*m00+m01*m01,
+        m10, m11, m10*m10+m11*m11,
+        m20, m21, m20*m20+m21*m21
+    ));
+}
+
 } // namespace Predicate
 
 } // namespace DDAD
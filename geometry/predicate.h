@@ -17,6 +17,7 @@
 #define GE_PREDICATE_H
 
 #include "common.h"
+#include "arithmetic.h"
 #include "point.h"
 #include "matrix.h"
 
@@ -41,6 +42,193 @@ Orientation OrientationPQR(const Point_2r& p, const Point_2r& q,
 
 bool RIsLeftOrInsidePQ(const Point_2r& p, const Point_2r& q, const Point_2r& r);
 
+Sign Orient2DSign(const Point_3r& a, const Point_3r& b, const Point_3r& c);
+Sign InCircleSign(const Point_3r& a, const Point_3r& b, const Point_3r& c,
+                  const Point_3r& d);
+
+//! @brief Exact counterparts of the Point_3f versions in expansion.h, with
+//! the same sign conventions.
+Sign Orient3DSign(const Point_3r& a, const Point_3r& b, const Point_3r& c,
+                  const Point_3r& d);
+Sign InSphereSign(const Point_3r& a, const Point_3r& b, const Point_3r& c,
+                  const Point_3r& d, const Point_3r& e);
+
+//! @brief Integer versions of the above; only x and y are read. Evaluated
+//! in machine integers when the coordinates are small enough, otherwise in
+//! integer arithmetic, and never in rationals.
+Sign Orient2DSign(const Point_3i& a, const Point_3i& b, const Point_3i& c);
+Sign InCircleSign(const Point_3i& a, const Point_3i& b, const Point_3i& c,
+                  const Point_3i& d);
+
+//=============================================================================
+// Interface: Filtered evaluation
+//=============================================================================
+
+/*!
+ * @brief Predicates that first evaluate their sign in double precision and
+ * fall back to exact rational arithmetic only when the sign is uncertain.
+ */
+enum FilteredPredicate {
+    FILTERED_ORIENTATION_PQR,
+    FILTERED_ORIENT_2D,
+    FILTERED_IN_CIRCLE,
+    FILTERED_PREDICATE_COUNT
+};
+
+/*!
+ * @brief Per-thread counters for a filtered predicate. \c failures counts
+ * the evaluations that took the exact path, either because the filter could
+ * not certify the sign or because an input is not exactly representable as a
+ * double.
+ */
+struct FilterStats {
+    uint64_t evaluations;
+    uint64_t failures;
+};
+
+/*!
+ * @brief Enables or disables the floating-point filter for all threads. With
+ * the filter disabled every evaluation takes the exact path. Enabled by
+ * default.
+ */
+void set_filtering_enabled(const bool enabled);
+bool filtering_enabled();
+
+//! @brief Counters of the calling thread for the given predicate.
+FilterStats filter_stats(const FilteredPredicate predicate);
+
+//! @brief Resets the counters of the calling thread for all predicates.
+void ResetFilterStats();
+
+//=============================================================================
+// Interface: Degree traits
+//=============================================================================
+
+enum PredicateKind {
+    PREDICATE_ORIENTATION_PQR,
+    PREDICATE_R_IS_LEFT_OR_INSIDE_PQ,
+    PREDICATE_ORIENT_2D,
+    PREDICATE_IN_CIRCLE,
+    PREDICATE_ORIENT_3D,
+    PREDICATE_IN_SPHERE
+};
+
+/*!
+ * @brief PredicateTraits - algebraic shape of a predicate. Its sign is that
+ * of a sum of at most terms monomials, each a product of degree coordinate
+ * differences of its input points; see PredicateBits.
+ */
+template <PredicateKind Kind>
+struct PredicateTraits;
+
+template <>
+struct PredicateTraits<PREDICATE_ORIENTATION_PQR> {
+    static constexpr int degree = 2;
+    static constexpr int terms = 2;
+    static constexpr int inputs = 3;
+};
+
+//! @brief The orientation, then (q-p).(q-p)-(q-p).(r-p) if colinear.
+template <>
+struct PredicateTraits<PREDICATE_R_IS_LEFT_OR_INSIDE_PQ> {
+    static constexpr int degree = 2;
+    static constexpr int terms = 4;
+    static constexpr int inputs = 3;
+};
+
+template <>
+struct PredicateTraits<PREDICATE_ORIENT_2D> {
+    static constexpr int degree = 2;
+    static constexpr int terms = 2;
+    static constexpr int inputs = 3;
+};
+
+//! @brief The lifted 3x3 determinant.
+template <>
+struct PredicateTraits<PREDICATE_IN_CIRCLE> {
+    static constexpr int degree = 4;
+    static constexpr int terms = 12;
+    static constexpr int inputs = 4;
+};
+
+template <>
+struct PredicateTraits<PREDICATE_ORIENT_3D> {
+    static constexpr int degree = 3;
+    static constexpr int terms = 6;
+    static constexpr int inputs = 4;
+};
+
+//! @brief The lifted 4x4 determinant: 4 lifts of 3 squares times 6-term
+//! minors.
+template <>
+struct PredicateTraits<PREDICATE_IN_SPHERE> {
+    static constexpr int degree = 5;
+    static constexpr int terms = 72;
+    static constexpr int inputs = 5;
+};
+
+//! @brief Bits needed to evaluate Kind exactly on |x| < 2^InputBits.
+template <PredicateKind Kind, int InputBits>
+struct PredicateBudget {
+    static constexpr int bits = PredicateBits<InputBits,
+        PredicateTraits<Kind>::degree, PredicateTraits<Kind>::terms>::value;
+};
+
+//! @brief Largest input bound for which Kind fits in Bits bits; the inverse
+//! of PredicateBudget.
+template <PredicateKind Kind, int Bits>
+struct MaxInputBits {
+    static constexpr int value =
+        (Bits-CeilLog2<PredicateTraits<Kind>::terms>::value-1)/
+        PredicateTraits<Kind>::degree-1;
+};
+
+//! @brief Narrowest machine integer evaluating Kind exactly on |x| <
+//! 2^InputBits. Fails to compile if there is none.
+template <PredicateKind Kind, int InputBits>
+struct PredicateInteger {
+    typedef typename FixedWidthInteger<
+        PredicateBudget<Kind, InputBits>::bits>::type type;
+};
+
+//=============================================================================
+// Interface: IntegerKernel
+//=============================================================================
+
+/*!
+ * @brief Predicates on integer points whose coordinates the caller declares
+ * to be below 2^InputBits in magnitude. Each predicate runs in the
+ * narrowest machine integer its degree allows for that bound, chosen at
+ * compile time, with no size checks, filter or allocation at run time.
+ * Members are instantiated on use, so with IntegerKernel<20> the
+ * orientation compiles to 64-bit arithmetic while InCircleSign, which
+ * would overflow 128 bits, fails to compile. Unbounded input goes to the
+ * untemplated overloads.
+ */
+template <int InputBits>
+struct IntegerKernel {
+    static_assert(InputBits > 0, "IntegerKernel: input bound must be positive");
+
+    template <PredicateKind Kind>
+    struct Integer {
+        typedef typename PredicateInteger<Kind, InputBits>::type type;
+    };
+
+    static Orientation OrientationPQR(const Point_2i& p, const Point_2i& q,
+                                      const Point_2i& r);
+    static bool RIsLeftOrInsidePQ(const Point_2i& p, const Point_2i& q,
+                                  const Point_2i& r);
+    static Sign Orient2DSign(const Point_3i& a, const Point_3i& b,
+                             const Point_3i& c);
+    static Sign InCircleSign(const Point_3i& a, const Point_3i& b,
+                             const Point_3i& c, const Point_3i& d);
+    static Sign Orient3DSign(const Point_3i& a, const Point_3i& b,
+                             const Point_3i& c, const Point_3i& d);
+    static Sign InSphereSign(const Point_3i& a, const Point_3i& b,
+                             const Point_3i& c, const Point_3i& d,
+                             const Point_3i& e);
+};
+
 inline bool AIsLeftOfB(const Point_2i& a, const Point_2i& b) {
     return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
 }
@@ -65,17 +253,244 @@ inline bool AIsBelowB(const Point_2r& a, const Point_2r& b) {
     return a.y() < b.y() || (a.y() == b.y() && a.x() < b.x());
 }
 
+/*!
+ * @brief OrientationPQR - orientation of r relative to the directed line pq
+ * for points with coordinates |x| < 2^InputBits, e.g. OrientationPQR<24>.
+ * The determinant is evaluated in the narrowest machine integer that cannot
+ * overflow for that budget, so the call never allocates. A budget that does
+ * not fit in a machine integer fails to compile.
+ */
+template <int InputBits>
+Orientation OrientationPQR(const Point_2i& p, const Point_2i& q,
+                           const Point_2i& r) {
+    typedef typename PredicateInteger<PREDICATE_ORIENTATION_PQR,
+                                      InputBits>::type Integer;
+
+    assert(IntegerFits(p.x(), InputBits) && IntegerFits(p.y(), InputBits) &&
+           IntegerFits(q.x(), InputBits) && IntegerFits(q.y(), InputBits) &&
+           IntegerFits(r.x(), InputBits) && IntegerFits(r.y(), InputBits));
+
+    Integer px = static_cast<Integer>(ToInt64(p.x()));
+    Integer py = static_cast<Integer>(ToInt64(p.y()));
+    Integer qx = static_cast<Integer>(ToInt64(q.x()));
+    Integer qy = static_cast<Integer>(ToInt64(q.y()));
+    Integer rx = static_cast<Integer>(ToInt64(r.x()));
+    Integer ry = static_cast<Integer>(ToInt64(r.y()));
+
+    Integer det = (qx-px)*(ry-py)-(qy-py)*(rx-px);
+
+    if (det > 0) {
+        return ORIENTATION_LEFT;
+    } else if (det < 0) {
+        return ORIENTATION_RIGHT;
+    } else {
+        return ORIENTATION_COLINEAR;
+    }
+}
+
+//! @brief Orient2DSign for |x|, |y| < 2^InputBits in a machine integer;
+//! see OrientationPQR<InputBits>.
+template <int InputBits>
+Sign Orient2DSign(const Point_3i& a, const Point_3i& b, const Point_3i& c) {
+    typedef typename PredicateInteger<PREDICATE_ORIENT_2D,
+                                      InputBits>::type Integer;
+
+    assert(IntegerFits(a.x(), InputBits) && IntegerFits(a.y(), InputBits) &&
+           IntegerFits(b.x(), InputBits) && IntegerFits(b.y(), InputBits) &&
+           IntegerFits(c.x(), InputBits) && IntegerFits(c.y(), InputBits));
+
+    Integer cx = static_cast<Integer>(ToInt64(c.x()));
+    Integer cy = static_cast<Integer>(ToInt64(c.y()));
+    Integer acx = static_cast<Integer>(ToInt64(a.x()))-cx;
+    Integer acy = static_cast<Integer>(ToInt64(a.y()))-cy;
+    Integer bcx = static_cast<Integer>(ToInt64(b.x()))-cx;
+    Integer bcy = static_cast<Integer>(ToInt64(b.y()))-cy;
+
+    Integer det = acx*bcy-acy*bcx;
+    return det > 0 ? SIGN_POSITIVE : (det < 0 ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+/*!
+ * @brief InCircleSign for |x|, |y| < 2^InputBits in a machine integer. The
+ * lifted determinant expands to 12 monomials of degree 4 in the coordinates,
+ * so 64 bits only cover InCircleSign<13>.
+ */
+template <int InputBits>
+Sign InCircleSign(const Point_3i& a, const Point_3i& b, const Point_3i& c,
+                  const Point_3i& d) {
+    typedef typename PredicateInteger<PREDICATE_IN_CIRCLE,
+                                      InputBits>::type Integer;
+
+    assert(IntegerFits(a.x(), InputBits) && IntegerFits(a.y(), InputBits) &&
+           IntegerFits(b.x(), InputBits) && IntegerFits(b.y(), InputBits) &&
+           IntegerFits(c.x(), InputBits) && IntegerFits(c.y(), InputBits) &&
+           IntegerFits(d.x(), InputBits) && IntegerFits(d.y(), InputBits));
+
+    Integer dx = static_cast<Integer>(ToInt64(d.x()));
+    Integer dy = static_cast<Integer>(ToInt64(d.y()));
+    Integer m00 = static_cast<Integer>(ToInt64(a.x()))-dx;
+    Integer m01 = static_cast<Integer>(ToInt64(a.y()))-dy;
+    Integer m02 = m00*m00+m01*m01;
+    Integer m10 = static_cast<Integer>(ToInt64(b.x()))-dx;
+    Integer m11 = static_cast<Integer>(ToInt64(b.y()))-dy;
+    Integer m12 = m10*m10+m11*m11;
+    Integer m20 = static_cast<Integer>(ToInt64(c.x()))-dx;
+    Integer m21 = static_cast<Integer>(ToInt64(c.y()))-dy;
+    Integer m22 = m20*m20+m21*m21;
+
+    Integer det = m00*(m11*m22-m12*m21)-
+                  m01*(m10*m22-m12*m20)+
+                  m02*(m10*m21-m11*m20);
+    return det > 0 ? SIGN_POSITIVE : (det < 0 ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+//! @brief RIsLeftOrInsidePQ on integer points in a machine integer; see
+//! OrientationPQR<InputBits>.
+template <int InputBits>
+bool RIsLeftOrInsidePQ(const Point_2i& p, const Point_2i& q,
+                       const Point_2i& r) {
+    typedef typename PredicateInteger<PREDICATE_R_IS_LEFT_OR_INSIDE_PQ,
+                                      InputBits>::type Integer;
+
+    Orientation orientation = OrientationPQR<InputBits>(p, q, r);
+    if (orientation != ORIENTATION_COLINEAR) {
+        return orientation == ORIENTATION_LEFT;
+    }
+
+    // r lies inside pq iff 0 <= (q-p).(r-p) <= (q-p).(q-p)
+    Integer px = static_cast<Integer>(ToInt64(p.x()));
+    Integer py = static_cast<Integer>(ToInt64(p.y()));
+    Integer qpx = static_cast<Integer>(ToInt64(q.x()))-px;
+    Integer qpy = static_cast<Integer>(ToInt64(q.y()))-py;
+    Integer rpx = static_cast<Integer>(ToInt64(r.x()))-px;
+    Integer rpy = static_cast<Integer>(ToInt64(r.y()))-py;
+    Integer dist = qpx*rpx+qpy*rpy;
+    return dist >= 0 && dist <= qpx*qpx+qpy*qpy;
+}
+
+//! @brief Orient3DSign for |x|, |y|, |z| < 2^InputBits in a machine
+//! integer, the sign of det[a-d; b-d; c-d].
+template <int InputBits>
+Sign Orient3DSign(const Point_3i& a, const Point_3i& b, const Point_3i& c,
+                  const Point_3i& d) {
+    typedef typename PredicateInteger<PREDICATE_ORIENT_3D,
+                                      InputBits>::type Integer;
+
+    const Point_3i* rows[3] = { &a, &b, &c };
+    Integer m[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            assert(IntegerFits((*rows[i])[j], InputBits) &&
+                   IntegerFits(d[j], InputBits));
+            m[i][j] = static_cast<Integer>(ToInt64((*rows[i])[j]))-
+                      static_cast<Integer>(ToInt64(d[j]));
+        }
+    }
+
+    Integer det = m[0][0]*(m[1][1]*m[2][2]-m[1][2]*m[2][1])-
+                  m[0][1]*(m[1][0]*m[2][2]-m[1][2]*m[2][0])+
+                  m[0][2]*(m[1][0]*m[2][1]-m[1][1]*m[2][0]);
+    return det > 0 ? SIGN_POSITIVE : (det < 0 ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+/*!
+ * @brief InSphereSign for |x|, |y|, |z| < 2^InputBits in a machine integer,
+ * expanded along the lifted column. Degree 5, so 128 bits cover
+ * InSphereSign<23>.
+ */
+template <int InputBits>
+Sign InSphereSign(const Point_3i& a, const Point_3i& b, const Point_3i& c,
+                  const Point_3i& d, const Point_3i& e) {
+    typedef typename PredicateInteger<PREDICATE_IN_SPHERE,
+                                      InputBits>::type Integer;
+
+    const Point_3i* rows[4] = { &a, &b, &c, &d };
+    Integer m[4][3];
+    Integer lift[4];
+    for (int i = 0; i < 4; ++i) {
+        lift[i] = 0;
+        for (int j = 0; j < 3; ++j) {
+            assert(IntegerFits((*rows[i])[j], InputBits) &&
+                   IntegerFits(e[j], InputBits));
+            m[i][j] = static_cast<Integer>(ToInt64((*rows[i])[j]))-
+                      static_cast<Integer>(ToInt64(e[j]));
+            lift[i] += m[i][j]*m[i][j];
+        }
+    }
+
+    // minor of the xyz columns without row i, times the cofactor sign of
+    // entry (i, 3)
+    Integer det = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int r0 = i == 0 ? 1 : 0;
+        const int r1 = i <= 1 ? 2 : 1;
+        const int r2 = i <= 2 ? 3 : 2;
+        Integer minor = m[r0][0]*(m[r1][1]*m[r2][2]-m[r1][2]*m[r2][1])-
+                        m[r0][1]*(m[r1][0]*m[r2][2]-m[r1][2]*m[r2][0])+
+                        m[r0][2]*(m[r1][0]*m[r2][1]-m[r1][1]*m[r2][0]);
+        if (i % 2 == 0) {
+            det -= lift[i]*minor;
+        } else {
+            det += lift[i]*minor;
+        }
+    }
+    return det > 0 ? SIGN_POSITIVE : (det < 0 ? SIGN_NEGATIVE : SIGN_ZERO);
+}
+
+//=============================================================================
+// Implementation: IntegerKernel
+//=============================================================================
+
+template <int InputBits>
+inline Orientation IntegerKernel<InputBits>::OrientationPQR(
+        const Point_2i& p, const Point_2i& q, const Point_2i& r) {
+    return Predicate::OrientationPQR<InputBits>(p, q, r);
+}
+
+template <int InputBits>
+inline bool IntegerKernel<InputBits>::RIsLeftOrInsidePQ(
+        const Point_2i& p, const Point_2i& q, const Point_2i& r) {
+    return Predicate::RIsLeftOrInsidePQ<InputBits>(p, q, r);
+}
+
+template <int InputBits>
+inline Sign IntegerKernel<InputBits>::Orient2DSign(
+        const Point_3i& a, const Point_3i& b, const Point_3i& c) {
+    return Predicate::Orient2DSign<InputBits>(a, b, c);
+}
+
+template <int InputBits>
+inline Sign IntegerKernel<InputBits>::InCircleSign(
+        const Point_3i& a, const Point_3i& b, const Point_3i& c,
+        const Point_3i& d) {
+    return Predicate::InCircleSign<InputBits>(a, b, c, d);
+}
+
+template <int InputBits>
+inline Sign IntegerKernel<InputBits>::Orient3DSign(
+        const Point_3i& a, const Point_3i& b, const Point_3i& c,
+        const Point_3i& d) {
+    return Predicate::Orient3DSign<InputBits>(a, b, c, d);
+}
+
+template <int InputBits>
+inline Sign IntegerKernel<InputBits>::InSphereSign(
+        const Point_3i& a, const Point_3i& b, const Point_3i& c,
+        const Point_3i& d, const Point_3i& e) {
+    return Predicate::InSphereSign<InputBits>(a, b, c, d, e);
+}
+
 inline rational InCircle(const Point_3r& a, const Point_3r& b,
                          const Point_3r& c, const Point_3r& d) {
-    auto m00 = a.x()-d.x();
-    auto m01 = a.y()-d.y();
-    auto m02 = m00*m00+m01*m01;
-    auto m10 = b.x()-d.x();
-    auto m11 = b.y()-d.y();
-    auto m12 = m10*m10+m11*m11;
-    auto m20 = c.x()-d.x();
-    auto m21 = c.y()-d.y();
-    auto m22 = m20*m20+m21*m21;
+    rational m00 = a.x()-d.x();
+    rational m01 = a.y()-d.y();
+    rational m02 = m00*m00+m01*m01;
+    rational m10 = b.x()-d.x();
+    rational m11 = b.y()-d.y();
+    rational m12 = m10*m10+m11*m11;
+    rational m20 = c.x()-d.x();
+    rational m21 = c.y()-d.y();
+    rational m22 = m20*m20+m21*m21;
     return Determinant(Matrix_3x3r(
         m00, m01, m02,
         m10, m11, m12,
@@ -0,0 +1,145 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "profile.h"
+
+#include <iomanip>
+#include <mutex>
+
+namespace DDAD {
+
+//=============================================================================
+// Implementation: ProfileSite
+//=============================================================================
+
+static const char* kOpNames[PROFILE_OP_COUNT] = { "add", "mul", "div", "cmp" };
+
+static thread_local ProfileSite* s_current_site = nullptr;
+
+//! @brief Never destroyed, since sites may record during static destruction.
+struct SiteRegistry {
+    std::mutex mutex;
+    std::vector<const ProfileSite*> sites;
+};
+
+static SiteRegistry& site_registry() {
+    static SiteRegistry* r = new SiteRegistry;
+    return *r;
+}
+
+static ProfileSite& UntaggedSite() {
+    static ProfileSite* site = new ProfileSite("(untagged)", "", 0);
+    return *site;
+}
+
+ProfileSite::ProfileSite(const char* name, const char* file, const int line) :
+    name_(name),
+    file_(file),
+    line_(line) {
+    Reset();
+    SiteRegistry& r = site_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.sites.push_back(this);
+}
+
+ProfileCounters ProfileSite::counters() const {
+    ProfileCounters c;
+    for (int i = 0; i < PROFILE_OP_COUNT; ++i) {
+        c.ops[i] = ops_[i].load(std::memory_order_relaxed);
+    }
+    c.allocations = allocations_.load(std::memory_order_relaxed);
+    c.peak_bits = peak_bits_.load(std::memory_order_relaxed);
+    return c;
+}
+
+void ProfileSite::Record(const ProfileOp op, const int bits,
+                         const int allocations) {
+    ops_[op].fetch_add(1, std::memory_order_relaxed);
+    RecordAllocations(allocations);
+    int peak = peak_bits_.load(std::memory_order_relaxed);
+    while (bits > peak &&
+           !peak_bits_.compare_exchange_weak(peak, bits,
+                                             std::memory_order_relaxed)) {}
+}
+
+void ProfileSite::RecordAllocations(const int allocations) {
+    if (allocations > 0) {
+        allocations_.fetch_add(allocations, std::memory_order_relaxed);
+    }
+}
+
+void ProfileSite::Reset() {
+    for (auto& op : ops_) {
+        op.store(0, std::memory_order_relaxed);
+    }
+    allocations_.store(0, std::memory_order_relaxed);
+    peak_bits_.store(0, std::memory_order_relaxed);
+}
+
+ProfileSiteScope::ProfileSiteScope(ProfileSite* site) :
+    previous_(s_current_site) {
+    s_current_site = site;
+}
+
+ProfileSiteScope::~ProfileSiteScope() {
+    s_current_site = previous_;
+}
+
+ProfileSite& CurrentProfileSite() {
+    return s_current_site ? *s_current_site : UntaggedSite();
+}
+
+std::vector<const ProfileSite*> ProfileSites() {
+    UntaggedSite();
+    SiteRegistry& r = site_registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.sites;
+}
+
+void ResetArithmeticProfile() {
+    for (auto site : ProfileSites()) {
+        const_cast<ProfileSite*>(site)->Reset();
+    }
+}
+
+void DumpArithmeticProfile(std::ostream& o) {
+    o << std::left << std::setw(32) << "site" << std::right
+      << std::setw(10) << "bits";
+    for (auto name : kOpNames) {
+        o << std::setw(12) << name;
+    }
+    o << std::setw(12) << "allocs" << "  location\n";
+
+    for (auto site : ProfileSites()) {
+        ProfileCounters c = site->counters();
+        uint64_t total = c.allocations;
+        for (auto n : c.ops) {
+            total += n;
+        }
+        if (total == 0) {
+            continue;
+        }
+        o << std::left << std::setw(32) << site->name() << std::right
+          << std::setw(10) << c.peak_bits;
+        for (auto n : c.ops) {
+            o << std::setw(12) << n;
+        }
+        o << std::setw(12) << c.allocations << "  " << site->file() << ":"
+          << site->line() << "\n";
+    }
+}
+
+} // namespace DDAD
@@ -0,0 +1,518 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Bit-complexity profiling of integer and rational arithmetic.
+ *
+ * Profiled<T> wraps mpz_class or mpq_class and reports every arithmetic
+ * operation, the bit length of its result and whether it had to allocate
+ * limbs to the innermost active ProfileSite of the calling thread. Build with
+ * DDAD_PROFILE_ARITHMETIC to make integer and rational profiled types and to
+ * enable the DDAD_PROFILE_SITE tags in the predicates and constructions; the
+ * measured peak bit lengths are what PredicateBits should be checked against.
+ */
+
+#ifndef GE_PROFILE_H
+#define GE_PROFILE_H
+
+#include "common.h"
+
+#include <atomic>
+#include <type_traits>
+
+namespace DDAD {
+
+//=============================================================================
+// Interface: ProfileSite
+//=============================================================================
+
+enum ProfileOp {
+    PROFILE_OP_ADD,
+    PROFILE_OP_MUL,
+    PROFILE_OP_DIV,
+    PROFILE_OP_COMPARE,
+    PROFILE_OP_COUNT
+};
+
+struct ProfileCounters {
+    uint64_t ops[PROFILE_OP_COUNT];
+    //! @brief Limb arrays allocated or grown by results and copies.
+    uint64_t allocations;
+    //! @brief Largest bit length of any result; for a rational, the larger
+    //! of numerator and denominator.
+    int peak_bits;
+};
+
+/*!
+ * @brief Counters for one tagged call site. Sites live for the whole run and
+ * are normally created by DDAD_PROFILE_SITE; counters are shared by all
+ * threads.
+ */
+class ProfileSite {
+public:
+    ProfileSite(const char* name, const char* file, const int line);
+
+    const char* name() const;
+    const char* file() const;
+    int line() const;
+    ProfileCounters counters() const;
+
+    void Record(const ProfileOp op, const int bits, const int allocations);
+    void RecordAllocations(const int allocations);
+    void Reset();
+
+private:
+    ProfileSite(const ProfileSite&);
+    ProfileSite& operator=(const ProfileSite&);
+
+    const char* name_;
+    const char* file_;
+    int line_;
+    std::atomic<uint64_t> ops_[PROFILE_OP_COUNT];
+    std::atomic<uint64_t> allocations_;
+    std::atomic<int> peak_bits_;
+};
+
+/*!
+ * @brief Makes site the current site of the calling thread until the scope
+ * ends. Scopes nest; operations are attributed to the innermost one only.
+ */
+class ProfileSiteScope {
+public:
+    explicit ProfileSiteScope(ProfileSite* site);
+    ~ProfileSiteScope();
+
+private:
+    ProfileSiteScope(const ProfileSiteScope&);
+    ProfileSiteScope& operator=(const ProfileSiteScope&);
+
+    ProfileSite* previous_;
+};
+
+//! @brief Innermost site of the calling thread, or the "untagged" site.
+ProfileSite& CurrentProfileSite();
+
+//! @brief All sites created so far, in order of creation.
+std::vector<const ProfileSite*> ProfileSites();
+
+void ResetArithmeticProfile();
+
+//! @brief Writes one line per site that recorded anything.
+void DumpArithmeticProfile(std::ostream& o);
+
+#ifdef DDAD_PROFILE_ARITHMETIC
+#define DDAD_PROFILE_SITE(name) \
+    static ::DDAD::ProfileSite ddad_profile_site(name, __FILE__, __LINE__); \
+    ::DDAD::ProfileSiteScope ddad_profile_scope(&ddad_profile_site)
+#else
+#define DDAD_PROFILE_SITE(name)
+#endif
+
+//=============================================================================
+// Interface: Profiled
+//=============================================================================
+
+/*!
+ * @brief Drop-in replacement for mpz_class (T = mpz_class) or mpq_class
+ * (T = mpq_class) that reports its arithmetic to CurrentProfileSite().
+ */
+template <class T>
+class Profiled {
+public:
+    Profiled();
+    Profiled(const int n);
+    Profiled(const long n);
+    Profiled(const unsigned int n);
+    Profiled(const unsigned long n);
+    Profiled(const double d);
+    explicit Profiled(const char* str, const int base = 10);
+    explicit Profiled(const std::string& str, const int base = 10);
+    Profiled(const T& value);
+    template <class A, class B>
+    Profiled(const __gmp_expr<A, B>& expr);
+    template <class U, typename std::enable_if<
+                  std::is_convertible<const U&, T>::value, int>::type = 0>
+    Profiled(const Profiled<U>& value);
+    template <class U, typename std::enable_if<
+                  !std::is_convertible<const U&, T>::value, int>::type = 0>
+    explicit Profiled(const Profiled<U>& value);
+    //! @brief Rational num/den; only for T = mpq_class.
+    Profiled(const Profiled<mpz_class>& num, const Profiled<mpz_class>& den);
+    Profiled(const Profiled& value);
+    Profiled(Profiled&& value);
+
+    Profiled& operator=(const Profiled& rhs);
+    Profiled& operator=(Profiled&& rhs);
+    Profiled& operator+=(const Profiled& rhs);
+    Profiled& operator-=(const Profiled& rhs);
+    Profiled& operator*=(const Profiled& rhs);
+    Profiled& operator/=(const Profiled& rhs);
+    Profiled operator-() const;
+
+    const T& value() const;
+    double get_d() const;
+    std::string get_str(const int base = 10) const;
+    void canonicalize();
+
+    // mpz_class interface
+    mpz_ptr get_mpz_t();
+    mpz_srcptr get_mpz_t() const;
+
+    // mpq_class interface
+    Profiled<mpz_class> get_num() const;
+    Profiled<mpz_class> get_den() const;
+    mpq_ptr get_mpq_t();
+    mpq_srcptr get_mpq_t() const;
+    mpz_srcptr get_num_mpz_t() const;
+    mpz_srcptr get_den_mpz_t() const;
+
+    friend Profiled operator+(const Profiled& lhs, const Profiled& rhs) {
+        return Profiled(lhs.value_+rhs.value_, PROFILE_OP_ADD);
+    }
+    friend Profiled operator-(const Profiled& lhs, const Profiled& rhs) {
+        return Profiled(lhs.value_-rhs.value_, PROFILE_OP_ADD);
+    }
+    friend Profiled operator*(const Profiled& lhs, const Profiled& rhs) {
+        return Profiled(lhs.value_*rhs.value_, PROFILE_OP_MUL);
+    }
+    friend Profiled operator/(const Profiled& lhs, const Profiled& rhs) {
+        return Profiled(lhs.value_/rhs.value_, PROFILE_OP_DIV);
+    }
+    friend int Compare(const Profiled& lhs, const Profiled& rhs) {
+        CurrentProfileSite().Record(PROFILE_OP_COMPARE, 0, 0);
+        return cmp(lhs.value_, rhs.value_);
+    }
+    friend bool operator==(const Profiled& lhs, const Profiled& rhs) {
+        return Compare(lhs, rhs) == 0;
+    }
+    friend bool operator!=(const Profiled& lhs, const Profiled& rhs) {
+        return Compare(lhs, rhs) != 0;
+    }
+    friend bool operator<(const Profiled& lhs, const Profiled& rhs) {
+        return Compare(lhs, rhs) < 0;
+    }
+    friend bool operator<=(const Profiled& lhs, const Profiled& rhs) {
+        return Compare(lhs, rhs) <= 0;
+    }
+    friend bool operator>(const Profiled& lhs, const Profiled& rhs) {
+        return Compare(lhs, rhs) > 0;
+    }
+    friend bool operator>=(const Profiled& lhs, const Profiled& rhs) {
+        return Compare(lhs, rhs) >= 0;
+    }
+    friend int sgn(const Profiled& x) {
+        return sgn(x.value_);
+    }
+    friend Profiled abs(const Profiled& x) {
+        return Profiled(abs(x.value_), PROFILE_OP_ADD);
+    }
+    friend std::ostream& operator<<(std::ostream& o, const Profiled& x) {
+        return o << x.value_;
+    }
+
+private:
+    template <class E>
+    Profiled(const E& expr, const ProfileOp op);
+
+    void Record(const ProfileOp op, const int limbs_before);
+
+    T value_;
+};
+
+//! @brief Number of limbs allocated by x.
+int AllocatedLimbs(const mpz_class& x);
+int AllocatedLimbs(const mpq_class& x);
+
+//! @brief Bit length of x, or of the larger of its numerator and
+//! denominator.
+int BitLength(const mpz_class& x);
+int BitLength(const mpq_class& x);
+
+Profiled<mpz_class> Floor(const Profiled<mpq_class>& x);
+Profiled<mpz_class> FloorKeepFraction(const Profiled<mpq_class>& x,
+                                      Profiled<mpq_class>* out_frac);
+Profiled<mpz_class> Ceil(const Profiled<mpq_class>& x);
+Profiled<mpz_class> CeilKeepFraction(const Profiled<mpq_class>& x,
+                                     Profiled<mpq_class>* out_frac);
+
+//=============================================================================
+// Implementation: ProfileSite
+//=============================================================================
+
+inline const char* ProfileSite::name() const {
+    return name_;
+}
+
+inline const char* ProfileSite::file() const {
+    return file_;
+}
+
+inline int ProfileSite::line() const {
+    return line_;
+}
+
+//=============================================================================
+// Implementation: Profiled
+//=============================================================================
+
+inline int AllocatedLimbs(const mpz_class& x) {
+    return x.get_mpz_t()->_mp_alloc;
+}
+
+inline int AllocatedLimbs(const mpq_class& x) {
+    return mpq_numref(x.get_mpq_t())->_mp_alloc+
+           mpq_denref(x.get_mpq_t())->_mp_alloc;
+}
+
+inline int BitLength(const mpz_class& x) {
+    return static_cast<int>(mpz_sizeinbase(x.get_mpz_t(), 2));
+}
+
+inline int BitLength(const mpq_class& x) {
+    return static_cast<int>(
+        std::max(mpz_sizeinbase(x.get_num_mpz_t(), 2),
+                 mpz_sizeinbase(x.get_den_mpz_t(), 2)));
+}
+
+template <class T>
+inline Profiled<T>::Profiled() {}
+
+template <class T>
+inline Profiled<T>::Profiled(const int n) :
+    value_(n) {}
+
+template <class T>
+inline Profiled<T>::Profiled(const long n) :
+    value_(n) {}
+
+template <class T>
+inline Profiled<T>::Profiled(const unsigned int n) :
+    value_(n) {}
+
+template <class T>
+inline Profiled<T>::Profiled(const unsigned long n) :
+    value_(n) {}
+
+template <class T>
+inline Profiled<T>::Profiled(const double d) :
+    value_(d) {}
+
+template <class T>
+inline Profiled<T>::Profiled(const char* str, const int base) :
+    value_(str, base) {}
+
+template <class T>
+inline Profiled<T>::Profiled(const std::string& str, const int base) :
+    value_(str, base) {}
+
+template <class T>
+inline Profiled<T>::Profiled(const T& value) :
+    value_(value) {
+    CurrentProfileSite().RecordAllocations(AllocatedLimbs(value_) > 0);
+}
+
+template <class T>
+template <class A, class B>
+inline Profiled<T>::Profiled(const __gmp_expr<A, B>& expr) :
+    value_(expr) {
+    CurrentProfileSite().RecordAllocations(AllocatedLimbs(value_) > 0);
+}
+
+template <class T>
+template <class U, typename std::enable_if<
+              std::is_convertible<const U&, T>::value, int>::type>
+inline Profiled<T>::Profiled(const Profiled<U>& value) :
+    value_(value.value()) {
+    CurrentProfileSite().RecordAllocations(AllocatedLimbs(value_) > 0);
+}
+
+template <class T>
+template <class U, typename std::enable_if<
+              !std::is_convertible<const U&, T>::value, int>::type>
+inline Profiled<T>::Profiled(const Profiled<U>& value) :
+    value_(value.value()) {
+    CurrentProfileSite().RecordAllocations(AllocatedLimbs(value_) > 0);
+}
+
+template <class T>
+inline Profiled<T>::Profiled(const Profiled<mpz_class>& num,
+                             const Profiled<mpz_class>& den) :
+    value_(num.value(), den.value()) {
+    CurrentProfileSite().RecordAllocations(AllocatedLimbs(value_) > 0);
+}
+
+template <class T>
+inline Profiled<T>::Profiled(const Profiled& value) :
+    value_(value.value_) {
+    CurrentProfileSite().RecordAllocations(AllocatedLimbs(value_) > 0);
+}
+
+//! @brief Takes over the limbs of value, so no allocation is recorded.
+template <class T>
+inline Profiled<T>::Profiled(Profiled&& value) :
+    value_(std::move(value.value_)) {}
+
+template <class T>
+template <class E>
+inline Profiled<T>::Profiled(const E& expr, const ProfileOp op) :
+    value_(expr) {
+    Record(op, 0);
+}
+
+template <class T>
+inline void Profiled<T>::Record(const ProfileOp op, const int limbs_before) {
+    CurrentProfileSite().Record(op, BitLength(value_),
+                                AllocatedLimbs(value_) > limbs_before);
+}
+
+template <class T>
+inline Profiled<T>& Profiled<T>::operator=(const Profiled& rhs) {
+    int before = AllocatedLimbs(value_);
+    value_ = rhs.value_;
+    CurrentProfileSite().RecordAllocations(AllocatedLimbs(value_) > before);
+    return *this;
+}
+
+template <class T>
+inline Profiled<T>& Profiled<T>::operator=(Profiled&& rhs) {
+    value_ = std::move(rhs.value_);
+    return *this;
+}
+
+template <class T>
+inline Profiled<T>& Profiled<T>::operator+=(const Profiled& rhs) {
+    int before = AllocatedLimbs(value_);
+    value_ += rhs.value_;
+    Record(PROFILE_OP_ADD, before);
+    return *this;
+}
+
+template <class T>
+inline Profiled<T>& Profiled<T>::operator-=(const Profiled& rhs) {
+    int before = AllocatedLimbs(value_);
+    value_ -= rhs.value_;
+    Record(PROFILE_OP_ADD, before);
+    return *this;
+}
+
+template <class T>
+inline Profiled<T>& Profiled<T>::operator*=(const Profiled& rhs) {
+    int before = AllocatedLimbs(value_);
+    value_ *= rhs.value_;
+    Record(PROFILE_OP_MUL, before);
+    return *this;
+}
+
+template <class T>
+inline Profiled<T>& Profiled<T>::operator/=(const Profiled& rhs) {
+    int before = AllocatedLimbs(value_);
+    value_ /= rhs.value_;
+    Record(PROFILE_OP_DIV, before);
+    return *this;
+}
+
+template <class T>
+inline Profiled<T> Profiled<T>::operator-() const {
+    return Profiled(-value_, PROFILE_OP_ADD);
+}
+
+// Accessors/Mutators =========================================================
+
+template <class T>
+inline const T& Profiled<T>::value() const {
+    return value_;
+}
+template <class T>
+inline double Profiled<T>::get_d() const {
+    return value_.get_d();
+}
+template <class T>
+inline std::string Profiled<T>::get_str(const int base) const {
+    return value_.get_str(base);
+}
+template <class T>
+inline void Profiled<T>::canonicalize() {
+    value_.canonicalize();
+}
+template <class T>
+inline mpz_ptr Profiled<T>::get_mpz_t() {
+    return value_.get_mpz_t();
+}
+template <class T>
+inline mpz_srcptr Profiled<T>::get_mpz_t() const {
+    return value_.get_mpz_t();
+}
+template <class T>
+inline Profiled<mpz_class> Profiled<T>::get_num() const {
+    return Profiled<mpz_class>(value_.get_num());
+}
+template <class T>
+inline Profiled<mpz_class> Profiled<T>::get_den() const {
+    return Profiled<mpz_class>(value_.get_den());
+}
+template <class T>
+inline mpq_ptr Profiled<T>::get_mpq_t() {
+    return value_.get_mpq_t();
+}
+template <class T>
+inline mpq_srcptr Profiled<T>::get_mpq_t() const {
+    return value_.get_mpq_t();
+}
+template <class T>
+inline mpz_srcptr Profiled<T>::get_num_mpz_t() const {
+    return value_.get_num_mpz_t();
+}
+template <class T>
+inline mpz_srcptr Profiled<T>::get_den_mpz_t() const {
+    return value_.get_den_mpz_t();
+}
+
+// Floor/Ceiling ==============================================================
+
+inline Profiled<mpz_class> Floor(const Profiled<mpq_class>& x) {
+    mpz_class out_int;
+    mpz_fdiv_q(out_int.get_mpz_t(), x.get_num_mpz_t(), x.get_den_mpz_t());
+    return out_int;
+}
+
+inline Profiled<mpz_class> FloorKeepFraction(const Profiled<mpq_class>& x,
+                                             Profiled<mpq_class>* out_frac) {
+    mpz_class out_int;
+    mpz_class out_frac_n;
+    mpz_fdiv_qr(out_int.get_mpz_t(), out_frac_n.get_mpz_t(),
+                x.get_num_mpz_t(), x.get_den_mpz_t());
+    *out_frac = mpq_class(out_frac_n, x.value().get_den());
+    return out_int;
+}
+
+inline Profiled<mpz_class> Ceil(const Profiled<mpq_class>& x) {
+    mpz_class out_int;
+    mpz_cdiv_q(out_int.get_mpz_t(), x.get_num_mpz_t(), x.get_den_mpz_t());
+    return out_int;
+}
+
+inline Profiled<mpz_class> CeilKeepFraction(const Profiled<mpq_class>& x,
+                                            Profiled<mpq_class>* out_frac) {
+    mpz_class out_int;
+    mpz_class out_frac_n;
+    mpz_cdiv_qr(out_int.get_mpz_t(), out_frac_n.get_mpz_t(),
+                x.get_num_mpz_t(), x.get_den_mpz_t());
+    *out_frac = mpq_class(out_frac_n, x.value().get_den());
+    return out_int;
+}
+
+} // namespace DDAD
+
+#endif // GE_PROFILE_H
@@ -0,0 +1,196 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Double-ended queue in a single power-of-two ring buffer.
+ *
+ * Unlike std::deque, which allocates a block every few hundred elements, a
+ * RingDeque that has been reserved to its final size never allocates, which
+ * is what hull construction needs: Melkman's deque never holds more than
+ * n+1 entries for an n-vertex chain. Growing past the capacity doubles it,
+ * so pushes are amortized O(1) either way. Elements are addressed from the
+ * front, as with std::deque.
+ */
+
+#ifndef GE_RINGDEQUE_H
+#define GE_RINGDEQUE_H
+
+#include "common.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Interface: RingDeque
+//=============================================================================
+
+template <class T>
+class RingDeque {
+public:
+    RingDeque();
+    explicit RingDeque(const size_t capacity);
+
+    void push_back(const T& value);
+    void push_front(const T& value);
+    void pop_back();
+    void pop_front();
+
+    //! @brief Makes room for capacity elements without further allocation.
+    void reserve(const size_t capacity);
+    void clear();
+
+    const T& operator[](const size_t i) const;
+    T& operator[](const size_t i);
+    const T& front() const;
+    const T& back() const;
+
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+
+private:
+    size_t slot(const size_t i) const;
+
+    std::vector<T> ring_;
+    size_t head_;
+    size_t size_;
+};
+
+//=============================================================================
+// Implementation: RingDeque
+//=============================================================================
+
+template <class T>
+inline RingDeque<T>::RingDeque() :
+    head_(0),
+    size_(0) {}
+
+template <class T>
+inline RingDeque<T>::RingDeque(const size_t capacity) :
+    head_(0),
+    size_(0) {
+    reserve(capacity);
+}
+
+template <class T>
+inline void RingDeque<T>::push_back(const T& value) {
+    if (size_ == ring_.size()) {
+        // value may live in the ring that is about to be replaced
+        T copy(value);
+        reserve(2*size_);
+        ring_[slot(size_)] = std::move(copy);
+    } else {
+        ring_[slot(size_)] = value;
+    }
+    ++size_;
+}
+
+template <class T>
+inline void RingDeque<T>::push_front(const T& value) {
+    if (size_ == ring_.size()) {
+        T copy(value);
+        reserve(2*size_);
+        head_ = (head_+ring_.size()-1) & (ring_.size()-1);
+        ring_[head_] = std::move(copy);
+    } else {
+        head_ = (head_+ring_.size()-1) & (ring_.size()-1);
+        ring_[head_] = value;
+    }
+    ++size_;
+}
+
+template <class T>
+inline void RingDeque<T>::pop_back() {
+    assert(size_ > 0);
+    --size_;
+}
+
+template <class T>
+inline void RingDeque<T>::pop_front() {
+    assert(size_ > 0);
+    head_ = (head_+1) & (ring_.size()-1);
+    --size_;
+}
+
+template <class T>
+void RingDeque<T>::reserve(const size_t capacity) {
+    size_t rounded = 4;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+    if (rounded <= ring_.size()) {
+        return;
+    }
+
+    std::vector<T> ring(rounded);
+    for (size_t i = 0; i < size_; ++i) {
+        ring[i] = std::move(ring_[slot(i)]);
+    }
+    ring_.swap(ring);
+    head_ = 0;
+}
+
+template <class T>
+inline void RingDeque<T>::clear() {
+    head_ = 0;
+    size_ = 0;
+}
+
+// Accessors/Mutators =========================================================
+
+template <class T>
+inline size_t RingDeque<T>::slot(const size_t i) const {
+    return (head_+i) & (ring_.size()-1);
+}
+
+template <class T>
+inline const T& RingDeque<T>::operator[](const size_t i) const {
+    assert(i < size_);
+    return ring_[slot(i)];
+}
+
+template <class T>
+inline T& RingDeque<T>::operator[](const size_t i) {
+    assert(i < size_);
+    return ring_[slot(i)];
+}
+
+template <class T>
+inline const T& RingDeque<T>::front() const {
+    return (*this)[0];
+}
+
+template <class T>
+inline const T& RingDeque<T>::back() const {
+    return (*this)[size_-1];
+}
+
+template <class T>
+inline size_t RingDeque<T>::size() const {
+    return size_;
+}
+
+template <class T>
+inline size_t RingDeque<T>::capacity() const {
+    return ring_.size();
+}
+
+template <class T>
+inline bool RingDeque<T>::empty() const {
+    return size_ == 0;
+}
+
+} // namespace DDAD
+
+#endif // GE_RINGDEQUE_H
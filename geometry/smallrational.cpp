@@ -0,0 +1,210 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "smallrational.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Implementation: SmallRational
+//=============================================================================
+
+// mpz_set_si/mpz_get_si take a long, which is 32 bits on Windows.
+
+static void MpzSetInt64(mpz_ptr z, const int64_t n) {
+    uint64_t u = n < 0 ? 0-static_cast<uint64_t>(n) : static_cast<uint64_t>(n);
+    mpz_import(z, 1, -1, sizeof(u), 0, 0, &u);
+    if (n < 0) {
+        mpz_neg(z, z);
+    }
+}
+
+static bool MpzFitsInt64(mpz_srcptr z) {
+    return mpz_sizeinbase(z, 2) <= 63;
+}
+
+static int64_t MpzGetInt64(mpz_srcptr z) {
+    assert(MpzFitsInt64(z));
+    uint64_t u = 0;
+    mpz_export(&u, nullptr, -1, sizeof(u), 0, 0, z);
+    return mpz_sgn(z) < 0 ? -static_cast<int64_t>(u) : static_cast<int64_t>(u);
+}
+
+static mpz_class ToMpz(const int64_t n) {
+    mpz_class z;
+    MpzSetInt64(z.get_mpz_t(), n);
+    return z;
+}
+
+void SmallRational::SetInt64(const int64_t n) {
+    if (n == std::numeric_limits<int64_t>::min()) {
+        SetMpz(ToMpz(n).get_mpz_t());
+    } else {
+        SetSmall(n, 1);
+    }
+}
+
+void SmallRational::SetUInt64(const uint64_t n) {
+    if (n > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+        mpz_class z;
+        mpz_import(z.get_mpz_t(), 1, -1, sizeof(n), 0, 0, &n);
+        SetMpz(z.get_mpz_t());
+    } else {
+        SetSmall(static_cast<int64_t>(n), 1);
+    }
+}
+
+void SmallRational::SetMpz(mpz_srcptr n) {
+    if (MpzFitsInt64(n)) {
+        SetSmall(MpzGetInt64(n), 1);
+        return;
+    }
+    if (!is_big_) {
+        mpq_init(big_);
+        is_big_ = true;
+    }
+    mpq_set_z(big_, n);
+}
+
+void SmallRational::SetMpq(mpq_srcptr q) {
+    if (MpzFitsInt64(mpq_numref(q)) && MpzFitsInt64(mpq_denref(q))) {
+        SetSmall(MpzGetInt64(mpq_numref(q)), MpzGetInt64(mpq_denref(q)));
+        return;
+    }
+    if (!is_big_) {
+        mpq_init(big_);
+        is_big_ = true;
+    }
+    mpq_set(big_, q);
+}
+
+//! @brief Writes the value into an initialized mpq_t.
+void SmallRational::LoadMpq(mpq_ptr q) const {
+    if (is_big_) {
+        mpq_set(q, big_);
+    } else {
+        MpzSetInt64(mpq_numref(q), small_.num);
+        MpzSetInt64(mpq_denref(q), small_.den);
+    }
+}
+
+/*!
+ * @brief Applies op in GMP arithmetic after an inline operation overflowed
+ * or when either operand is already stored as mpq_t.
+ */
+void SmallRational::SlowOp(const SmallRational& rhs,
+                           void (*op)(mpq_ptr, mpq_srcptr, mpq_srcptr)) {
+    mpq_t a, b;
+    mpq_init(a);
+    mpq_init(b);
+    LoadMpq(a);
+    rhs.LoadMpq(b);
+    op(a, a, b);
+    SetMpq(a);
+    mpq_clear(a);
+    mpq_clear(b);
+}
+
+int SmallRational::CompareSlow(const SmallRational& lhs,
+                               const SmallRational& rhs) {
+    mpq_t a, b;
+    mpq_init(a);
+    mpq_init(b);
+    lhs.LoadMpq(a);
+    rhs.LoadMpq(b);
+    int cmp = mpq_cmp(a, b);
+    mpq_clear(a);
+    mpq_clear(b);
+    return cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+}
+
+// Accessors/Mutators =========================================================
+
+mpz_class SmallRational::get_num() const {
+    if (is_big_) {
+        return mpz_class(mpq_numref(big_));
+    }
+    return ToMpz(small_.num);
+}
+
+mpz_class SmallRational::get_den() const {
+    if (is_big_) {
+        return mpz_class(mpq_denref(big_));
+    }
+    return ToMpz(small_.den);
+}
+
+mpq_class SmallRational::get_mpq() const {
+    mpq_class q;
+    LoadMpq(q.get_mpq_t());
+    return q;
+}
+
+std::string SmallRational::get_str(const int base) const {
+    if (!is_big_ && base == 10) {
+        std::stringstream ss;
+        ss << small_.num;
+        if (small_.den != 1) {
+            ss << "/" << small_.den;
+        }
+        return ss.str();
+    }
+    return get_mpq().get_str(base);
+}
+
+// Floor/Ceiling ==============================================================
+
+mpz_class Floor(const SmallRational& x) {
+    if (!x.is_big_) {
+        int64_t q = x.small_.num/x.small_.den;
+        if (x.small_.num%x.small_.den != 0 && x.small_.num < 0) {
+            --q;
+        }
+        return ToMpz(q);
+    }
+    mpq_class q = x.get_mpq();
+    mpz_class out_int;
+    mpz_fdiv_q(out_int.get_mpz_t(), q.get_num_mpz_t(), q.get_den_mpz_t());
+    return out_int;
+}
+
+mpz_class FloorKeepFraction(const SmallRational& x, SmallRational* out_frac) {
+    mpz_class out_int = Floor(x);
+    *out_frac = x-SmallRational(out_int);
+    return out_int;
+}
+
+mpz_class Ceil(const SmallRational& x) {
+    if (!x.is_big_) {
+        int64_t q = x.small_.num/x.small_.den;
+        if (x.small_.num%x.small_.den != 0 && x.small_.num > 0) {
+            ++q;
+        }
+        return ToMpz(q);
+    }
+    mpq_class q = x.get_mpq();
+    mpz_class out_int;
+    mpz_cdiv_q(out_int.get_mpz_t(), q.get_num_mpz_t(), q.get_den_mpz_t());
+    return out_int;
+}
+
+mpz_class CeilKeepFraction(const SmallRational& x, SmallRational* out_frac) {
+    mpz_class out_int = Ceil(x);
+    *out_frac = x-SmallRational(out_int);
+    return out_int;
+}
+
+} // namespace DDAD
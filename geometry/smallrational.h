@@ -0,0 +1,561 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Rational number with an inline 64-bit fast path.
+ */
+
+#ifndef GE_SMALLRATIONAL_H
+#define GE_SMALLRATIONAL_H
+
+#include "common.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Interface: SmallRational
+//=============================================================================
+
+/*!
+ * @brief The SmallRational class is an exact rational number that stores
+ * its numerator and denominator inline as int64_t and switches to an mpq_t
+ * only when a result no longer fits.
+ *
+ * Values are always canonical: the denominator is positive, numerator and
+ * denominator are coprime, and a value is stored as mpq_t if and only if it
+ * does not fit in the inline representation. Results of slow-path
+ * operations are demoted again whenever possible.
+ *
+ * The interface mirrors the subset of mpq_class used by the library so that
+ * building with DDAD_SMALL_RATIONAL defined can typedef rational to it.
+ */
+class SmallRational {
+public:
+    SmallRational();
+    SmallRational(const int n);
+    SmallRational(const long n);
+    SmallRational(const long long n);
+    SmallRational(const unsigned int n);
+    SmallRational(const unsigned long n);
+    SmallRational(const unsigned long long n);
+    SmallRational(const double d);
+    SmallRational(const mpz_class& n);
+    SmallRational(const mpz_class& n, const mpz_class& d);
+    SmallRational(const mpq_class& q);
+    template <class T, class U>
+    SmallRational(const __gmp_expr<T, U>& expr);
+    SmallRational(const SmallRational& q);
+    SmallRational(SmallRational&& q);
+    ~SmallRational();
+
+    SmallRational& operator=(const SmallRational& rhs);
+    SmallRational& operator=(SmallRational&& rhs);
+
+    SmallRational& operator+=(const SmallRational& rhs);
+    SmallRational& operator-=(const SmallRational& rhs);
+    SmallRational& operator*=(const SmallRational& rhs);
+    SmallRational& operator/=(const SmallRational& rhs);
+    SmallRational operator-() const;
+
+    //! @brief True if the value is held inline rather than as mpq_t.
+    bool is_small() const;
+    bool is_integer() const;
+    int sign() const;
+    double get_d() const;
+    mpz_class get_num() const;
+    mpz_class get_den() const;
+    mpq_class get_mpq() const;
+    std::string get_str(const int base = 10) const;
+    //! @brief No-op; values are kept canonical.
+    void canonicalize() {}
+
+    friend int Compare(const SmallRational& lhs, const SmallRational& rhs);
+    friend bool operator==(const SmallRational& lhs, const SmallRational& rhs);
+    friend mpz_class Floor(const SmallRational& x);
+    friend mpz_class Ceil(const SmallRational& x);
+
+private:
+    struct Small {
+        int64_t num;
+        int64_t den;
+    };
+
+    static bool CheckedAdd(const int64_t a, const int64_t b, int64_t& r);
+    static bool CheckedMul(const int64_t a, const int64_t b, int64_t& r);
+    static uint64_t Abs(const int64_t a);
+    static uint64_t Gcd(uint64_t a, uint64_t b);
+    static bool AddSmall(const Small& a, const Small& b, Small& out);
+    static bool MulSmall(const Small& a, const Small& b, Small& out);
+    static int CompareSlow(const SmallRational& lhs, const SmallRational& rhs);
+
+    void SetSmall(const int64_t num, const int64_t den);
+    void SetInt64(const int64_t n);
+    void SetUInt64(const uint64_t n);
+    void SetMpz(mpz_srcptr n);
+    void SetMpq(mpq_srcptr q);
+    void Clear();
+    void LoadMpq(mpq_ptr q) const;
+    void SlowOp(const SmallRational& rhs,
+                void (*op)(mpq_ptr, mpq_srcptr, mpq_srcptr));
+
+    bool is_big_;
+    union {
+        Small small_;
+        mpq_t big_;
+    };
+};
+
+SmallRational operator+(const SmallRational& lhs, const SmallRational& rhs);
+SmallRational operator-(const SmallRational& lhs, const SmallRational& rhs);
+SmallRational operator*(const SmallRational& lhs, const SmallRational& rhs);
+SmallRational operator/(const SmallRational& lhs, const SmallRational& rhs);
+
+int Compare(const SmallRational& lhs, const SmallRational& rhs);
+bool operator==(const SmallRational& lhs, const SmallRational& rhs);
+bool operator!=(const SmallRational& lhs, const SmallRational& rhs);
+bool operator<(const SmallRational& lhs, const SmallRational& rhs);
+bool operator<=(const SmallRational& lhs, const SmallRational& rhs);
+bool operator>(const SmallRational& lhs, const SmallRational& rhs);
+bool operator>=(const SmallRational& lhs, const SmallRational& rhs);
+
+int sgn(const SmallRational& q);
+SmallRational abs(const SmallRational& q);
+std::ostream& operator<<(std::ostream& o, const SmallRational& q);
+
+mpz_class Floor(const SmallRational& x);
+mpz_class FloorKeepFraction(const SmallRational& x, SmallRational* out_frac);
+mpz_class Ceil(const SmallRational& x);
+mpz_class CeilKeepFraction(const SmallRational& x, SmallRational* out_frac);
+
+//=============================================================================
+// Implementation: SmallRational
+//=============================================================================
+
+inline SmallRational::SmallRational() :
+    is_big_(false) {
+    SetSmall(0, 1);
+}
+
+inline SmallRational::SmallRational(const int n) :
+    is_big_(false) {
+    SetSmall(n, 1);
+}
+
+inline SmallRational::SmallRational(const long n) :
+    is_big_(false) {
+    SetInt64(n);
+}
+
+inline SmallRational::SmallRational(const long long n) :
+    is_big_(false) {
+    SetInt64(n);
+}
+
+inline SmallRational::SmallRational(const unsigned int n) :
+    is_big_(false) {
+    SetSmall(n, 1);
+}
+
+inline SmallRational::SmallRational(const unsigned long n) :
+    is_big_(false) {
+    SetUInt64(n);
+}
+
+inline SmallRational::SmallRational(const unsigned long long n) :
+    is_big_(false) {
+    SetUInt64(n);
+}
+
+inline SmallRational::SmallRational(const double d) :
+    is_big_(false) {
+    if (d < 9.2e18 && d > -9.2e18 &&
+        static_cast<double>(static_cast<int64_t>(d)) == d) {
+        SetSmall(static_cast<int64_t>(d), 1);
+    } else {
+        SetMpq(mpq_class(d).get_mpq_t());
+    }
+}
+
+inline SmallRational::SmallRational(const mpz_class& n) :
+    is_big_(false) {
+    SetMpz(n.get_mpz_t());
+}
+
+inline SmallRational::SmallRational(const mpz_class& n, const mpz_class& d) :
+    is_big_(false) {
+    mpq_class q(n, d);
+    q.canonicalize();
+    SetMpq(q.get_mpq_t());
+}
+
+inline SmallRational::SmallRational(const mpq_class& q) :
+    is_big_(false) {
+    SetMpq(q.get_mpq_t());
+}
+
+template <class T, class U>
+inline SmallRational::SmallRational(const __gmp_expr<T, U>& expr) :
+    is_big_(false) {
+    __gmp_expr<T, T> value(expr);
+    *this = SmallRational(value);
+}
+
+inline SmallRational::SmallRational(const SmallRational& q) :
+    is_big_(false) {
+    if (q.is_big_) {
+        SetMpq(q.big_);
+    } else {
+        small_ = q.small_;
+    }
+}
+
+inline SmallRational::SmallRational(SmallRational&& q) :
+    is_big_(q.is_big_) {
+    if (q.is_big_) {
+        // steal the limbs; q is left as 0
+        big_[0] = q.big_[0];
+        q.is_big_ = false;
+        q.SetSmall(0, 1);
+    } else {
+        small_ = q.small_;
+    }
+}
+
+inline SmallRational::~SmallRational() {
+    Clear();
+}
+
+inline SmallRational& SmallRational::operator=(const SmallRational& rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+    if (rhs.is_big_) {
+        SetMpq(rhs.big_);
+    } else {
+        Clear();
+        small_ = rhs.small_;
+    }
+    return *this;
+}
+
+inline SmallRational& SmallRational::operator=(SmallRational&& rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+    Clear();
+    if (rhs.is_big_) {
+        big_[0] = rhs.big_[0];
+        is_big_ = true;
+        rhs.is_big_ = false;
+        rhs.SetSmall(0, 1);
+    } else {
+        small_ = rhs.small_;
+    }
+    return *this;
+}
+
+inline SmallRational& SmallRational::operator+=(const SmallRational& rhs) {
+    if (!is_big_ && !rhs.is_big_ && AddSmall(small_, rhs.small_, small_)) {
+        return *this;
+    }
+    SlowOp(rhs, mpq_add);
+    return *this;
+}
+
+inline SmallRational& SmallRational::operator-=(const SmallRational& rhs) {
+    if (!is_big_ && !rhs.is_big_) {
+        Small neg = { -rhs.small_.num, rhs.small_.den };
+        if (AddSmall(small_, neg, small_)) {
+            return *this;
+        }
+    }
+    SlowOp(rhs, mpq_sub);
+    return *this;
+}
+
+inline SmallRational& SmallRational::operator*=(const SmallRational& rhs) {
+    if (!is_big_ && !rhs.is_big_ && MulSmall(small_, rhs.small_, small_)) {
+        return *this;
+    }
+    SlowOp(rhs, mpq_mul);
+    return *this;
+}
+
+inline SmallRational& SmallRational::operator/=(const SmallRational& rhs) {
+    assert(rhs.sign() != 0);
+    if (!is_big_ && !rhs.is_big_) {
+        Small inv = rhs.small_.num < 0 ?
+                    Small{ -rhs.small_.den, -rhs.small_.num } :
+                    Small{ rhs.small_.den, rhs.small_.num };
+        if (MulSmall(small_, inv, small_)) {
+            return *this;
+        }
+    }
+    SlowOp(rhs, mpq_div);
+    return *this;
+}
+
+inline SmallRational SmallRational::operator-() const {
+    SmallRational result(*this);
+    if (result.is_big_) {
+        mpq_neg(result.big_, result.big_);
+    } else {
+        result.small_.num = -result.small_.num;
+    }
+    return result;
+}
+
+inline bool SmallRational::is_small() const {
+    return !is_big_;
+}
+
+inline bool SmallRational::is_integer() const {
+    return is_big_ ? mpz_cmp_ui(mpq_denref(big_), 1) == 0 : small_.den == 1;
+}
+
+inline int SmallRational::sign() const {
+    if (is_big_) {
+        return mpq_sgn(big_);
+    }
+    return small_.num > 0 ? 1 : (small_.num < 0 ? -1 : 0);
+}
+
+inline double SmallRational::get_d() const {
+    if (is_big_) {
+        return mpq_get_d(big_);
+    } else if (small_.den == 1) {
+        return static_cast<double>(small_.num);
+    }
+    return static_cast<double>(small_.num)/static_cast<double>(small_.den);
+}
+
+inline bool SmallRational::CheckedAdd(const int64_t a, const int64_t b,
+                                      int64_t& r) {
+#if defined(__GNUC__)
+    if (__builtin_add_overflow(a, b, &r)) {
+        return false;
+    }
+#else
+    if ((b > 0 && a > std::numeric_limits<int64_t>::max()-b) ||
+        (b < 0 && a < std::numeric_limits<int64_t>::min()-b)) {
+        return false;
+    }
+    r = a+b;
+#endif
+    // INT64_MIN cannot be negated, keep it out of the inline range
+    return r != std::numeric_limits<int64_t>::min();
+}
+
+inline bool SmallRational::CheckedMul(const int64_t a, const int64_t b,
+                                      int64_t& r) {
+#if defined(__GNUC__)
+    if (__builtin_mul_overflow(a, b, &r)) {
+        return false;
+    }
+    return r != std::numeric_limits<int64_t>::min();
+#else
+    if (a != 0 && Abs(b) > static_cast<uint64_t>(
+            std::numeric_limits<int64_t>::max())/Abs(a)) {
+        return false;
+    }
+    r = a*b;
+    return true;
+#endif
+}
+
+inline uint64_t SmallRational::Abs(const int64_t a) {
+    return a < 0 ? static_cast<uint64_t>(-a) : static_cast<uint64_t>(a);
+}
+
+inline uint64_t SmallRational::Gcd(uint64_t a, uint64_t b) {
+    while (b != 0) {
+        uint64_t t = a%b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/*!
+ * @brief a+b for inline values. Leaves out untouched and returns false if
+ * an intermediate overflows; out may alias a or b.
+ */
+inline bool SmallRational::AddSmall(const Small& a, const Small& b,
+                                    Small& out) {
+    int64_t num, den;
+    if (a.den == b.den) {
+        if (!CheckedAdd(a.num, b.num, num)) {
+            return false;
+        }
+        den = a.den;
+        if (den != 1) {
+            int64_t g = static_cast<int64_t>(Gcd(Abs(num), den));
+            num /= g;
+            den /= g;
+        }
+    } else {
+        // Knuth, TAOCP vol. 2, 4.5.1
+        int64_t g = static_cast<int64_t>(Gcd(a.den, b.den));
+        int64_t t1, t2, t;
+        if (!CheckedMul(a.num, b.den/g, t1) ||
+            !CheckedMul(b.num, a.den/g, t2) ||
+            !CheckedAdd(t1, t2, t)) {
+            return false;
+        }
+        if (t == 0) {
+            num = 0;
+            den = 1;
+        } else {
+            int64_t g2 = static_cast<int64_t>(Gcd(Abs(t), g));
+            if (!CheckedMul(a.den/g, b.den/g2, den)) {
+                return false;
+            }
+            num = t/g2;
+        }
+    }
+    out.num = num;
+    out.den = den;
+    return true;
+}
+
+//! @brief a*b for inline values; see AddSmall.
+inline bool SmallRational::MulSmall(const Small& a, const Small& b,
+                                    Small& out) {
+    if (a.num == 0 || b.num == 0) {
+        out.num = 0;
+        out.den = 1;
+        return true;
+    }
+    int64_t num, den;
+    if (a.den == 1 && b.den == 1) {
+        if (!CheckedMul(a.num, b.num, num)) {
+            return false;
+        }
+        den = 1;
+    } else {
+        int64_t g1 = static_cast<int64_t>(Gcd(Abs(a.num), b.den));
+        int64_t g2 = static_cast<int64_t>(Gcd(Abs(b.num), a.den));
+        if (!CheckedMul(a.num/g1, b.num/g2, num) ||
+            !CheckedMul(a.den/g2, b.den/g1, den)) {
+            return false;
+        }
+    }
+    out.num = num;
+    out.den = den;
+    return true;
+}
+
+inline void SmallRational::SetSmall(const int64_t num, const int64_t den) {
+    Clear();
+    small_.num = num;
+    small_.den = den;
+}
+
+inline void SmallRational::Clear() {
+    if (is_big_) {
+        mpq_clear(big_);
+        is_big_ = false;
+    }
+}
+
+inline SmallRational operator+(const SmallRational& lhs,
+                               const SmallRational& rhs) {
+    SmallRational result(lhs);
+    result += rhs;
+    return result;
+}
+
+inline SmallRational operator-(const SmallRational& lhs,
+                               const SmallRational& rhs) {
+    SmallRational result(lhs);
+    result -= rhs;
+    return result;
+}
+
+inline SmallRational operator*(const SmallRational& lhs,
+                               const SmallRational& rhs) {
+    SmallRational result(lhs);
+    result *= rhs;
+    return result;
+}
+
+inline SmallRational operator/(const SmallRational& lhs,
+                               const SmallRational& rhs) {
+    SmallRational result(lhs);
+    result /= rhs;
+    return result;
+}
+
+inline int Compare(const SmallRational& lhs, const SmallRational& rhs) {
+    if (!lhs.is_big_ && !rhs.is_big_) {
+        if (lhs.small_.den == rhs.small_.den) {
+            return lhs.small_.num < rhs.small_.num ? -1 :
+                   (lhs.small_.num > rhs.small_.num ? 1 : 0);
+        }
+#if defined(__SIZEOF_INT128__)
+        __int128 l = static_cast<__int128>(lhs.small_.num)*rhs.small_.den;
+        __int128 r = static_cast<__int128>(rhs.small_.num)*lhs.small_.den;
+        return l < r ? -1 : (l > r ? 1 : 0);
+#endif
+    }
+    return SmallRational::CompareSlow(lhs, rhs);
+}
+
+inline bool operator==(const SmallRational& lhs, const SmallRational& rhs) {
+    if (!lhs.is_big_ && !rhs.is_big_) {
+        return lhs.small_.num == rhs.small_.num &&
+               lhs.small_.den == rhs.small_.den;
+    } else if (lhs.is_big_ && rhs.is_big_) {
+        return mpq_equal(lhs.big_, rhs.big_) != 0;
+    }
+    // canonical: a value that fits is never stored as mpq_t
+    return false;
+}
+
+inline bool operator!=(const SmallRational& lhs, const SmallRational& rhs) {
+    return !(lhs == rhs);
+}
+
+inline bool operator<(const SmallRational& lhs, const SmallRational& rhs) {
+    return Compare(lhs, rhs) < 0;
+}
+
+inline bool operator<=(const SmallRational& lhs, const SmallRational& rhs) {
+    return Compare(lhs, rhs) <= 0;
+}
+
+inline bool operator>(const SmallRational& lhs, const SmallRational& rhs) {
+    return Compare(lhs, rhs) > 0;
+}
+
+inline bool operator>=(const SmallRational& lhs, const SmallRational& rhs) {
+    return Compare(lhs, rhs) >= 0;
+}
+
+inline int sgn(const SmallRational& q) {
+    return q.sign();
+}
+
+inline SmallRational abs(const SmallRational& q) {
+    return q.sign() < 0 ? -q : q;
+}
+
+inline std::ostream& operator<<(std::ostream& o, const SmallRational& q) {
+    return o << q.get_str();
+}
+
+} // namespace DDAD
+
+#endif // GE_SMALLRATIONAL_H
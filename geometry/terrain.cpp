@@ -31,13 +31,27 @@ RegionalTerrain_3r DelaunayTerrain(const PointSet_3r& samples,
 
     terrain.Initialize(AABB_2r(samples));
 
-    for (auto sample : samples.points()) {
+    for (auto& sample : samples.points()) {
         terrain.AddSample(*sample);
     }
 
     return terrain;
 }
 
+RegionalTerrain_3r DelaunayTerrain(const PointBufferView_3r& samples,
+                                   IGeometryObserver* obs) {
+    RegionalTerrain_3r terrain;
+    terrain.AddObserver(obs);
+
+    terrain.Initialize(AABB_2r(samples));
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        terrain.AddSample(samples.point(i));
+    }
+
+    return terrain;
+}
+
 //=============================================================================
 // Implementation: RegionalTerrain_3r
 //=============================================================================
@@ -88,6 +102,10 @@ void RegionalTerrain_3r::Initialize(const AABB_2r& region) {
     // add edge across diagonal
     terrain_->makeFaceEdge(left, v1, v3);
 
+    if (!observed()) {
+        return;
+    }
+
     // draw vertices
     QuadEdge::CellVertexIterator terrain_verts(terrain_);
     QuadEdge::Vertex *v;
@@ -116,7 +134,9 @@ void RegionalTerrain_3r::AddSample(const Point_3r& sample) {
     SharedPoint_3r sample_r = std::make_shared<Point_3r>(
         sample.x(), sample.y(), sample.z()-1
     );
-    SigRegisterPoint_3r(*sample_r);
+    if (observed()) {
+        SigRegisterPoint_3r(*sample_r);
+    }
 
     // find the triangle containing the sample
     QuadEdge::Edge *e1 = LocalizePoint(*sample_r);
@@ -149,9 +169,9 @@ QuadEdge::Edge* RegionalTerrain_3r::LocalizePoint(const Point_3r& sample) {
         QuadEdge::Vertex *v1 = e1->Org();
         QuadEdge::Vertex *v2 = e1->Dest();
         QuadEdge::Vertex *v3 = e2->Dest();
-        if (Predicate::Orient2D(*v1->pos, *v2->pos, sample) >= 0 &&
-            Predicate::Orient2D(*v2->pos, *v3->pos, sample) >= 0 &&
-            Predicate::Orient2D(*v3->pos, *v1->pos, sample) >= 0) {
+        if (Predicate::Orient2DSign(*v1->pos, *v2->pos, sample) >= SIGN_ZERO &&
+            Predicate::Orient2DSign(*v2->pos, *v3->pos, sample) >= SIGN_ZERO &&
+            Predicate::Orient2DSign(*v3->pos, *v1->pos, sample) >= SIGN_ZERO) {
             return e1;
         }
     }
@@ -171,7 +191,8 @@ void RegionalTerrain_3r::TestAndSwapEdges(std::vector<QuadEdge::Edge*>& edges,
         QuadEdge::Edge *e4 = e1->Rnext();
         QuadEdge::Edge *e5 = e1->Rprev();
 
-        if (Predicate::InCircle(*v1->pos, *v2->pos, *v3->pos, sample) > 0) {
+        if (Predicate::InCircleSign(*v1->pos, *v2->pos, *v3->pos, sample) ==
+            SIGN_POSITIVE) {
             QuadEdge::Face *left = e1->Left();
             KillFaceEdge(e1);
             MakeFaceEdge(left, e2->Dest(), e5->Dest());
@@ -184,14 +205,23 @@ void RegionalTerrain_3r::TestAndSwapEdges(std::vector<QuadEdge::Edge*>& edges,
 // Visualization Methods ======================================================
 
 void RegionalTerrain_3r::SigPushVertex(QuadEdge::Vertex *v) {
+    if (!observed()) {
+        return;
+    }
     SigPushVisualPoint_3r(*v->pos, Visual::Point(mat_vertex_));
 }
 
 void RegionalTerrain_3r::SigPopVertex(QuadEdge::Vertex *v) {
+    if (!observed()) {
+        return;
+    }
     SigPopVisualPoint_3r(*v->pos);
 }
 
 void RegionalTerrain_3r::SigPushEdge(QuadEdge::Edge* e) {
+    if (!observed()) {
+        return;
+    }
     Segment_3r s1(e->Org()->pos, e->Dest()->pos);
     Segment_3r s2(e->Dest()->pos, e->Org()->pos);
     SigPushVisualSegment_3r(s1, Visual::Segment(mat_edge_));
@@ -199,6 +229,9 @@ void RegionalTerrain_3r::SigPushEdge(QuadEdge::Edge* e) {
 }
 
 void RegionalTerrain_3r::SigPopEdge(QuadEdge::Edge* e) {
+    if (!observed()) {
+        return;
+    }
     Segment_3r s1(e->Org()->pos, e->Dest()->pos);
     Segment_3r s2(e->Dest()->pos, e->Org()->pos);
     SigPopVisualSegment_3r(s1);
@@ -206,6 +239,9 @@ void RegionalTerrain_3r::SigPopEdge(QuadEdge::Edge* e) {
 }
 
 void RegionalTerrain_3r::SigPushFace(QuadEdge::Face* f) {
+    if (!observed()) {
+        return;
+    }
 
     // ignore loop, sliver, and quadrilateral topology
     if (EdgeCount(f) != 3) {
@@ -221,6 +257,9 @@ void RegionalTerrain_3r::SigPushFace(QuadEdge::Face* f) {
 }
 
 void RegionalTerrain_3r::SigPopFace(QuadEdge::Face* f) {
+    if (!observed()) {
+        return;
+    }
 
     // ignore loop, sliver, and quadrilateral topology
     if (EdgeCount(f) != 3) {
@@ -238,6 +277,12 @@ QuadEdge::Edge* RegionalTerrain_3r::MakeVertexEdge(QuadEdge::Vertex *v,
                                                    QuadEdge::Face *left,
                                                    QuadEdge::Face *right,
                                                    SharedPoint_3r vnew_pos) {
+    // without observers only the topology needs to change
+    if (!observed()) {
+        QuadEdge::Edge* enew = terrain_->makeVertexEdge(v, left, right);
+        enew->Dest()->pos = vnew_pos;
+        return enew;
+    }
 
     // we need to pop all faces and edges on the ccw traveral from the left
     // face to the right face in v's orbit. the vertexedgeiterator will begin
@@ -307,6 +352,11 @@ QuadEdge::Edge* RegionalTerrain_3r::MakeFaceEdge(QuadEdge::Face *f,
 }
 
 void RegionalTerrain_3r::KillVertexEdge(QuadEdge::Edge *e) {
+    if (!observed()) {
+        terrain_->killVertexEdge(e);
+        return;
+    }
+
     QuadEdge::Face *left = e->Left();
     QuadEdge::Face *right = e->Right();
     QuadEdge::Vertex *v = e->Org();
@@ -86,6 +86,8 @@ private:
 };
 
 RegionalTerrain_3r DelaunayTerrain(const PointSet_3r&, IGeometryObserver* obs);
+RegionalTerrain_3r DelaunayTerrain(const PointBufferView_3r& samples,
+                                   IGeometryObserver* obs);
 
 } // namespace DDAD
 
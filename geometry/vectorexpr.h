@@ -0,0 +1,594 @@
+/*
+ * This file is part of DDAD.
+ *
+ * DDAD is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * DDAD is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with DDAD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * @brief Expression templates for exact vector arithmetic.
+ *
+ * The operators in vector.h are eager: every +, - or * builds a complete
+ * Vector or Point, and each of its coordinates allocates. Wrapping the
+ * operands in Expr() instead builds a tree of references that is evaluated
+ * only when it is assigned, one coordinate at a time, through the compound
+ * operators of the scalar type. Intermediate values live in a per-thread
+ * stack of scratch scalars that keep their limbs from one evaluation to the
+ * next, and finished coordinates are moved into the destination, so
+ *
+ *     Assign(p, Expr(o)+Expr(u)*t);
+ *     rational d = Dot(Expr(q)-Expr(p), Expr(r)-Expr(p));
+ *
+ * allocate nothing beyond the result once the scratch has grown to the size
+ * of the operands. Any type with operator[] and an elements() array, i.e. all
+ * of the Point and Vector classes, can be an operand, and Points and Vectors
+ * mix freely. Expressions hold references, so they must be evaluated in the
+ * statement that builds them.
+ */
+
+#ifndef GE_VECTOREXPR_H
+#define GE_VECTOREXPR_H
+
+#include <deque>
+#include <type_traits>
+
+#include "common.h"
+#include "vector.h"
+
+namespace DDAD {
+
+//=============================================================================
+// Interface: ExprScratch
+//=============================================================================
+
+/*!
+ * @brief Stack of scalars reused by expression evaluation. Slots are never
+ * destroyed while the stack lives, so each keeps the limbs it has grown to.
+ */
+template <class T>
+class ExprScratch {
+public:
+    ExprScratch();
+
+    T& Acquire();
+    void Release();
+    //! @brief Frees all slots; only valid while none is acquired.
+    void Clear();
+
+    //! @brief The stack of the calling thread.
+    static ExprScratch& Local();
+
+private:
+    ExprScratch(const ExprScratch&);
+    ExprScratch& operator=(const ExprScratch&);
+
+    std::deque<T> slots_;
+    size_t depth_;
+};
+
+//! @brief Holds a slot of an ExprScratch for the lifetime of the object.
+template <class T>
+class ScratchSlot {
+public:
+    explicit ScratchSlot(ExprScratch<T>& scratch);
+    ~ScratchSlot();
+
+    T& operator*();
+
+private:
+    ScratchSlot(const ScratchSlot&);
+    ScratchSlot& operator=(const ScratchSlot&);
+
+    ExprScratch<T>& scratch_;
+    T& slot_;
+};
+
+//=============================================================================
+// Interface: VectorExpr
+//=============================================================================
+
+/*!
+ * @brief Base of all vector expression nodes. E provides the Scalar type,
+ * the kDimension, and Evaluate(i, out, scratch), which stores coordinate i
+ * of the expression in out. out never aliases an operand.
+ */
+template <class E>
+struct VectorExpr {
+    const E& self() const;
+};
+
+//! @brief Scalar type and dimension of a Point or Vector class.
+template <class V>
+struct VectorTraits {
+    typedef typename std::decay<
+        decltype(std::declval<const V&>().elements())>::type Elements;
+    typedef typename Elements::value_type Scalar;
+    static const size_t kDimension = std::tuple_size<Elements>::value;
+};
+
+//! @brief Leaf: a reference to a Point or Vector.
+template <class V>
+class VectorRef : public VectorExpr<VectorRef<V>> {
+public:
+    typedef typename VectorTraits<V>::Scalar Scalar;
+    static const size_t kDimension = VectorTraits<V>::kDimension;
+
+    explicit VectorRef(const V& v);
+
+    const Scalar& operator[](const size_t i) const;
+    void Evaluate(const size_t i, Scalar& out,
+                  ExprScratch<Scalar>& scratch) const;
+
+private:
+    const V& v_;
+};
+
+template <class L, class R>
+class VectorSum : public VectorExpr<VectorSum<L, R>> {
+public:
+    typedef typename L::Scalar Scalar;
+    static const size_t kDimension = L::kDimension;
+
+    VectorSum(const L& lhs, const R& rhs);
+
+    void Evaluate(const size_t i, Scalar& out,
+                  ExprScratch<Scalar>& scratch) const;
+
+private:
+    const L& lhs_;
+    const R& rhs_;
+};
+
+template <class L, class R>
+class VectorDifference : public VectorExpr<VectorDifference<L, R>> {
+public:
+    typedef typename L::Scalar Scalar;
+    static const size_t kDimension = L::kDimension;
+
+    VectorDifference(const L& lhs, const R& rhs);
+
+    void Evaluate(const size_t i, Scalar& out,
+                  ExprScratch<Scalar>& scratch) const;
+
+private:
+    const L& lhs_;
+    const R& rhs_;
+};
+
+template <class E>
+class VectorNegation : public VectorExpr<VectorNegation<E>> {
+public:
+    typedef typename E::Scalar Scalar;
+    static const size_t kDimension = E::kDimension;
+
+    explicit VectorNegation(const E& e);
+
+    void Evaluate(const size_t i, Scalar& out,
+                  ExprScratch<Scalar>& scratch) const;
+
+private:
+    const E& e_;
+};
+
+//! @brief Product (or, if divide, quotient) of a vector and a scalar.
+template <class E>
+class VectorScale : public VectorExpr<VectorScale<E>> {
+public:
+    typedef typename E::Scalar Scalar;
+    static const size_t kDimension = E::kDimension;
+
+    VectorScale(const E& e, const Scalar& s, const bool divide);
+
+    void Evaluate(const size_t i, Scalar& out,
+                  ExprScratch<Scalar>& scratch) const;
+
+private:
+    const E& e_;
+    const Scalar& s_;
+    bool divide_;
+};
+
+template <class L, class R>
+class VectorCross : public VectorExpr<VectorCross<L, R>> {
+public:
+    typedef typename L::Scalar Scalar;
+    static const size_t kDimension = 3;
+
+    VectorCross(const L& lhs, const R& rhs);
+
+    void Evaluate(const size_t i, Scalar& out,
+                  ExprScratch<Scalar>& scratch) const;
+
+private:
+    const L& lhs_;
+    const R& rhs_;
+};
+
+template <class V>
+VectorRef<V> Expr(const V& v);
+
+template <class L, class R>
+VectorSum<L, R> operator+(const VectorExpr<L>& lhs, const VectorExpr<R>& rhs);
+template <class L, class R>
+VectorDifference<L, R> operator-(const VectorExpr<L>& lhs,
+                                 const VectorExpr<R>& rhs);
+template <class E>
+VectorNegation<E> operator-(const VectorExpr<E>& e);
+template <class E>
+VectorScale<E> operator*(const VectorExpr<E>& e,
+                         const typename E::Scalar& s);
+template <class E>
+VectorScale<E> operator*(const typename E::Scalar& s,
+                         const VectorExpr<E>& e);
+template <class E>
+VectorScale<E> operator/(const VectorExpr<E>& e,
+                         const typename E::Scalar& s);
+template <class L, class R>
+VectorCross<L, R> Cross(const VectorExpr<L>& lhs, const VectorExpr<R>& rhs);
+
+template <class L, class R>
+typename L::Scalar Dot(const VectorExpr<L>& lhs, const VectorExpr<R>& rhs);
+template <class L, class R>
+void AssignDot(typename L::Scalar& out, const VectorExpr<L>& lhs,
+               const VectorExpr<R>& rhs);
+
+template <class V, class E>
+V& Assign(V& v, const VectorExpr<E>& e);
+template <class V, class E>
+V Evaluate(const VectorExpr<E>& e);
+
+//=============================================================================
+// Implementation: ExprScratch
+//=============================================================================
+
+template <class T>
+inline ExprScratch<T>::ExprScratch() :
+    depth_(0) {}
+
+template <class T>
+inline T& ExprScratch<T>::Acquire() {
+    if (depth_ == slots_.size()) {
+        slots_.emplace_back();
+    }
+    return slots_[depth_++];
+}
+
+template <class T>
+inline void ExprScratch<T>::Release() {
+    assert(depth_ > 0);
+    --depth_;
+}
+
+template <class T>
+inline void ExprScratch<T>::Clear() {
+    assert(depth_ == 0);
+    slots_.clear();
+}
+
+template <class T>
+inline ExprScratch<T>& ExprScratch<T>::Local() {
+    static thread_local ExprScratch<T> scratch;
+    return scratch;
+}
+
+template <class T>
+inline ScratchSlot<T>::ScratchSlot(ExprScratch<T>& scratch) :
+    scratch_(scratch),
+    slot_(scratch.Acquire()) {}
+
+template <class T>
+inline ScratchSlot<T>::~ScratchSlot() {
+    scratch_.Release();
+}
+
+template <class T>
+inline T& ScratchSlot<T>::operator*() {
+    return slot_;
+}
+
+//=============================================================================
+// Implementation: VectorExpr
+//=============================================================================
+
+template <class E>
+inline const E& VectorExpr<E>::self() const {
+    return static_cast<const E&>(*this);
+}
+
+/*
+ * Operands are combined through these helpers, which read leaves in place
+ * and evaluate anything else into a scratch slot first.
+ */
+
+template <class E, class T>
+inline void ExprAddTo(T& out, const VectorExpr<E>& e, const size_t i,
+                  ExprScratch<T>& scratch) {
+    ScratchSlot<T> t(scratch);
+    e.self().Evaluate(i, *t, scratch);
+    out += *t;
+}
+
+template <class V, class T>
+inline void ExprAddTo(T& out, const VectorRef<V>& e, const size_t i,
+                  ExprScratch<T>&) {
+    out += e[i];
+}
+
+template <class E, class T>
+inline void ExprSubtractFrom(T& out, const VectorExpr<E>& e, const size_t i,
+                         ExprScratch<T>& scratch) {
+    ScratchSlot<T> t(scratch);
+    e.self().Evaluate(i, *t, scratch);
+    out -= *t;
+}
+
+template <class V, class T>
+inline void ExprSubtractFrom(T& out, const VectorRef<V>& e, const size_t i,
+                         ExprScratch<T>&) {
+    out -= e[i];
+}
+
+template <class E, class T>
+inline void ExprMultiplyBy(T& out, const VectorExpr<E>& e, const size_t i,
+                       ExprScratch<T>& scratch) {
+    ScratchSlot<T> t(scratch);
+    e.self().Evaluate(i, *t, scratch);
+    out *= *t;
+}
+
+template <class V, class T>
+inline void ExprMultiplyBy(T& out, const VectorRef<V>& e, const size_t i,
+                       ExprScratch<T>&) {
+    out *= e[i];
+}
+
+//! @brief out = lhs[i]*rhs[j]
+template <class L, class R, class T>
+inline void ExprProduct(T& out, const VectorExpr<L>& lhs, const size_t i,
+                    const VectorExpr<R>& rhs, const size_t j,
+                    ExprScratch<T>& scratch) {
+    lhs.self().Evaluate(i, out, scratch);
+    ExprMultiplyBy(out, rhs.self(), j, scratch);
+}
+
+//=============================================================================
+// Implementation: VectorRef
+//=============================================================================
+
+template <class V>
+inline VectorRef<V>::VectorRef(const V& v) :
+    v_(v) {}
+
+template <class V>
+inline const typename VectorRef<V>::Scalar& VectorRef<V>::operator[](
+        const size_t i) const {
+    return v_.elements()[i];
+}
+
+template <class V>
+inline void VectorRef<V>::Evaluate(const size_t i, Scalar& out,
+                                   ExprScratch<Scalar>&) const {
+    out = v_.elements()[i];
+}
+
+//=============================================================================
+// Implementation: VectorSum, VectorDifference, VectorNegation
+//=============================================================================
+
+template <class L, class R>
+inline VectorSum<L, R>::VectorSum(const L& lhs, const R& rhs) :
+    lhs_(lhs),
+    rhs_(rhs) {}
+
+template <class L, class R>
+inline void VectorSum<L, R>::Evaluate(const size_t i, Scalar& out,
+                                      ExprScratch<Scalar>& scratch) const {
+    lhs_.Evaluate(i, out, scratch);
+    ExprAddTo(out, rhs_, i, scratch);
+}
+
+template <class L, class R>
+inline VectorDifference<L, R>::VectorDifference(const L& lhs, const R& rhs) :
+    lhs_(lhs),
+    rhs_(rhs) {}
+
+template <class L, class R>
+inline void VectorDifference<L, R>::Evaluate(
+        const size_t i, Scalar& out, ExprScratch<Scalar>& scratch) const {
+    lhs_.Evaluate(i, out, scratch);
+    ExprSubtractFrom(out, rhs_, i, scratch);
+}
+
+template <class E>
+inline VectorNegation<E>::VectorNegation(const E& e) :
+    e_(e) {}
+
+template <class E>
+inline void VectorNegation<E>::Evaluate(const size_t i, Scalar& out,
+                                        ExprScratch<Scalar>& scratch) const {
+    e_.Evaluate(i, out, scratch);
+    out = -out;
+}
+
+//=============================================================================
+// Implementation: VectorScale
+//=============================================================================
+
+template <class E>
+inline VectorScale<E>::VectorScale(const E& e, const Scalar& s,
+                                   const bool divide) :
+    e_(e),
+    s_(s),
+    divide_(divide) {}
+
+template <class E>
+inline void VectorScale<E>::Evaluate(const size_t i, Scalar& out,
+                                     ExprScratch<Scalar>& scratch) const {
+    e_.Evaluate(i, out, scratch);
+    if (divide_) {
+        out /= s_;
+    } else {
+        out *= s_;
+    }
+}
+
+//=============================================================================
+// Implementation: VectorCross
+//=============================================================================
+
+template <class L, class R>
+inline VectorCross<L, R>::VectorCross(const L& lhs, const R& rhs) :
+    lhs_(lhs),
+    rhs_(rhs) {}
+
+//! @brief (l x r)_i = l_j*r_k-l_k*r_j with (i, j, k) a cyclic permutation.
+template <class L, class R>
+inline void VectorCross<L, R>::Evaluate(const size_t i, Scalar& out,
+                                        ExprScratch<Scalar>& scratch) const {
+    const size_t j = (i+1)%3;
+    const size_t k = (i+2)%3;
+    ExprProduct(out, lhs_, j, rhs_, k, scratch);
+    ScratchSlot<Scalar> t(scratch);
+    ExprProduct(*t, lhs_, k, rhs_, j, scratch);
+    out -= *t;
+}
+
+//=============================================================================
+// Implementation: Building expressions
+//=============================================================================
+
+template <class V>
+inline VectorRef<V> Expr(const V& v) {
+    return VectorRef<V>(v);
+}
+
+template <class L, class R>
+inline VectorSum<L, R> operator+(const VectorExpr<L>& lhs,
+                                 const VectorExpr<R>& rhs) {
+    static_assert(L::kDimension == R::kDimension, "dimension mismatch");
+    return VectorSum<L, R>(lhs.self(), rhs.self());
+}
+
+template <class L, class R>
+inline VectorDifference<L, R> operator-(const VectorExpr<L>& lhs,
+                                        const VectorExpr<R>& rhs) {
+    static_assert(L::kDimension == R::kDimension, "dimension mismatch");
+    return VectorDifference<L, R>(lhs.self(), rhs.self());
+}
+
+template <class E>
+inline VectorNegation<E> operator-(const VectorExpr<E>& e) {
+    return VectorNegation<E>(e.self());
+}
+
+template <class E>
+inline VectorScale<E> operator*(const VectorExpr<E>& e,
+                                const typename E::Scalar& s) {
+    return VectorScale<E>(e.self(), s, false);
+}
+
+template <class E>
+inline VectorScale<E> operator*(const typename E::Scalar& s,
+                                const VectorExpr<E>& e) {
+    return VectorScale<E>(e.self(), s, false);
+}
+
+template <class E>
+inline VectorScale<E> operator/(const VectorExpr<E>& e,
+                                const typename E::Scalar& s) {
+    return VectorScale<E>(e.self(), s, true);
+}
+
+template <class L, class R>
+inline VectorCross<L, R> Cross(const VectorExpr<L>& lhs,
+                               const VectorExpr<R>& rhs) {
+    static_assert(L::kDimension == 3 && R::kDimension == 3,
+                  "cross product of non-3D vectors");
+    return VectorCross<L, R>(lhs.self(), rhs.self());
+}
+
+//=============================================================================
+// Implementation: Evaluating expressions
+//=============================================================================
+
+template <class L, class R>
+inline void AssignDot(typename L::Scalar& out, const VectorExpr<L>& lhs,
+                      const VectorExpr<R>& rhs) {
+    typedef typename L::Scalar Scalar;
+    static_assert(L::kDimension == R::kDimension, "dimension mismatch");
+    ExprScratch<Scalar>& scratch = ExprScratch<Scalar>::Local();
+    ScratchSlot<Scalar> sum(scratch);
+    ExprProduct(*sum, lhs, 0, rhs, 0, scratch);
+    ScratchSlot<Scalar> t(scratch);
+    for (size_t i = 1; i < L::kDimension; ++i) {
+        ExprProduct(*t, lhs, i, rhs, i, scratch);
+        *sum += *t;
+    }
+    out = std::move(*sum);
+}
+
+template <class L, class R>
+inline typename L::Scalar Dot(const VectorExpr<L>& lhs,
+                              const VectorExpr<R>& rhs) {
+    typename L::Scalar out;
+    AssignDot(out, lhs, rhs);
+    return out;
+}
+
+template <class V, class T>
+inline void ExprSetElements(V& v, const std::array<T*, 2>& elements) {
+    v.set_x(std::move(*elements[0]));
+    v.set_y(std::move(*elements[1]));
+}
+
+template <class V, class T>
+inline void ExprSetElements(V& v, const std::array<T*, 3>& elements) {
+    v.set_x(std::move(*elements[0]));
+    v.set_y(std::move(*elements[1]));
+    v.set_z(std::move(*elements[2]));
+}
+
+/*!
+ * All coordinates are evaluated before any is stored, so v may appear in e.
+ * Coordinates are moved in; for the GMP types that swaps them with the old
+ * ones, so the scratch slots take over the limbs they replace.
+ */
+template <class V, class E>
+inline V& Assign(V& v, const VectorExpr<E>& e) {
+    typedef typename E::Scalar Scalar;
+    static_assert(std::is_same<Scalar,
+                      typename VectorTraits<V>::Scalar>::value,
+                  "scalar type mismatch");
+    static_assert(E::kDimension == VectorTraits<V>::kDimension,
+                  "dimension mismatch");
+    ExprScratch<Scalar>& scratch = ExprScratch<Scalar>::Local();
+    std::array<Scalar*, E::kDimension> elements;
+    for (size_t i = 0; i < E::kDimension; ++i) {
+        elements[i] = &scratch.Acquire();
+        e.self().Evaluate(i, *elements[i], scratch);
+    }
+    ExprSetElements(v, elements);
+    for (size_t i = 0; i < E::kDimension; ++i) {
+        scratch.Release();
+    }
+    return v;
+}
+
+template <class V, class E>
+inline V Evaluate(const VectorExpr<E>& e) {
+    V v;
+    Assign(v, e);
+    return v;
+}
+
+} // namespace DDAD
+
+#endif // GE_VECTOREXPR_H
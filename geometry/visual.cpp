@@ -100,8 +100,16 @@ void Geometry::SlotUpdate() {
     SigUpdate();
 }
 
+//! @note Null observers are ignored, and so is every observer in a
+//! DDAD_HEADLESS build.
 void Geometry::AddObserver(IGeometryObserver* geom_observer) {
-    observers_.push_back(geom_observer);
+#ifndef DDAD_HEADLESS
+    if (geom_observer) {
+        observers_.push_back(geom_observer);
+    }
+#else
+    (void)geom_observer;
+#endif
 }
 
 void Geometry::RemoveObserver(IGeometryObserver* geom_observer) {
@@ -376,10 +376,26 @@ public:
 
     void SigUpdate() const override;
 
+    /*!
+     * @brief True if any observer is attached. Algorithms test this before
+     * building the arguments of a signal, so that unobserved geometry does
+     * no visualization work. Always false in a DDAD_HEADLESS build, where
+     * the guarded code compiles away.
+     */
+    bool observed() const;
+
 protected:
     std::vector<IGeometryObserver*> observers_;
 };
 
+inline bool Geometry::observed() const {
+#ifdef DDAD_HEADLESS
+    return false;
+#else
+    return !observers_.empty();
+#endif
+}
+
 } // namespace Visual
 
 } // namespace DDAD
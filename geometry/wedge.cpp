@@ -17,6 +17,7 @@
 #include "arithmetic.h"
 #include "line.h"
 #include "wedge.h"
+#include "vectorexpr.h"
 
 namespace DDAD {
 
@@ -36,17 +37,42 @@ Wedge_2r::Wedge_2r(const Vector_2r& u, const Vector_2r& v) :
 
 Wedge_2r::~Wedge_2r() {}
 
+/*!
+ * @note A wedge attached while nobody watched it has neither registered its
+ * points nor built its segment keys; the first observer gets both here, so
+ * that a later AttachToOrigin can pop what it pushed.
+ */
+void Wedge_2r::AddObserver(Visual::IGeometryObserver* geom_observer) {
+    bool was_observed = observed();
+    Geometry::AddObserver(geom_observer);
+    if(attached_ && !was_observed && observed()) {
+        RegisterCorners();
+    }
+}
+
+void Wedge_2r::RegisterCorners() {
+    if(!ou_->unique_id()) {
+        SigRegisterPoint_2r(*ou_);
+    }
+    if(!ov_->unique_id()) {
+        SigRegisterPoint_2r(*ov_);
+    }
+    if(!ouv_->unique_id()) {
+        SigRegisterPoint_2r(*ouv_);
+    }
+    u_segment_ = Segment_2r(o_, ou_);
+    v_segment_ = Segment_2r(o_, ov_);
+}
+
 void Wedge_2r::AttachToOrigin(SharedPoint_2r o) {
     if(!attached_) {
         o_ = o;
         ou_ = std::make_shared<Point_2r>(*o_+u_);
         ov_ = std::make_shared<Point_2r>(*o_+v_);
         ouv_ = std::make_shared<Point_2r>(*o_+u_+v_);
-        SigRegisterPoint_2r(*ou_);
-        SigRegisterPoint_2r(*ov_);
-        SigRegisterPoint_2r(*ouv_);
-        u_segment_ = Segment_2r(o_, ou_);
-        v_segment_ = Segment_2r(o_, ov_);
+        if (observed()) {
+            RegisterCorners();
+        }
         u_tri_.set_a(o_);
         u_tri_.set_b(ou_);
         u_tri_.set_c(ouv_);
@@ -54,6 +80,13 @@ void Wedge_2r::AttachToOrigin(SharedPoint_2r o) {
         v_tri_.set_b(ouv_);
         v_tri_.set_c(ov_);
         attached_ = true;
+    } else if (!observed()) {
+        o_ = o;
+        Assign(*ou_, Expr(*o_)+Expr(u_));
+        Assign(*ov_, Expr(*o_)+Expr(v_));
+        Assign(*ouv_, Expr(*o_)+Expr(u_)+Expr(v_));
+        u_tri_.set_a(o_);
+        v_tri_.set_a(o_);
     } else {
         SigPopVisualSegment_2r(u_segment_);
         SigPopVisualSegment_2r(v_segment_);
@@ -61,11 +94,11 @@ void Wedge_2r::AttachToOrigin(SharedPoint_2r o) {
         SigPopVisualTriangle_2r(v_tri_);
 
         o_ = o;
-        ou_->set_elements((*o_+u_).elements());
+        Assign(*ou_, Expr(*o_)+Expr(u_));
         ou_->SigPositionChanged();
-        ov_->set_elements((*o_+v_).elements());
+        Assign(*ov_, Expr(*o_)+Expr(v_));
         ov_->SigPositionChanged();
-        ouv_->set_elements((*o_+u_+v_).elements());
+        Assign(*ouv_, Expr(*o_)+Expr(u_)+Expr(v_));
         ouv_->SigPositionChanged();
 
         u_segment_ = Segment_2r(o_, ou_);
@@ -122,10 +155,33 @@ WedgeStack_2r::WedgeStack_2r(SharedPoint_2r origin) :
 
 WedgeStack_2r::~WedgeStack_2r() {}
 
+//! @note Wedges are only watched while the stack itself is observed.
+void WedgeStack_2r::AddObserver(Visual::IGeometryObserver* geom_observer) {
+    bool was_observed = observed();
+    Geometry::AddObserver(geom_observer);
+    if(!was_observed && observed()) {
+        if(origin_ && !origin_->unique_id()) {
+            SigRegisterPoint_2r(*origin_);
+        }
+        for(auto i = begin(wedge_stack_); i != end(wedge_stack_); ++i) {
+            (*i)->AddObserver(this);
+        }
+    }
+}
+
+void WedgeStack_2r::RemoveObserver(Visual::IGeometryObserver* geom_observer) {
+    Geometry::RemoveObserver(geom_observer);
+    if(!observed()) {
+        for(auto i = begin(wedge_stack_); i != end(wedge_stack_); ++i) {
+            (*i)->RemoveObserver(this);
+        }
+    }
+}
+
 //! \note assumes origin is already registered
 void WedgeStack_2r::AttachToOrigin(SharedPoint_2r origin) {
     origin_ = origin;
-    if(!origin_->unique_id()) {
+    if(observed() && !origin_->unique_id()) {
         SigRegisterPoint_2r(*origin_);
     }
     for(auto i = begin(wedge_stack_); i != end(wedge_stack_); ++i) {
@@ -142,7 +198,9 @@ void WedgeStack_2r::Push(std::shared_ptr<Wedge_2r> w) {
     wedge_stack_.push_back(w);
 
     // start watching the wedge for signals
-    wedge_stack_.back()->AddObserver(this);
+    if(observed()) {
+        wedge_stack_.back()->AddObserver(this);
+    }
 
     // inform the wedge of where this stack is located
     if(origin_) {
@@ -34,6 +34,8 @@ public:
     Wedge_2r(const Vector_2r& u, const Vector_2r& v);
     ~Wedge_2r();
 
+    void AddObserver(Visual::IGeometryObserver* geom_observer) override;
+
     void AttachToOrigin(SharedPoint_2r origin);
 
     const Vector_2r& u() const;
@@ -44,6 +46,7 @@ public:
     SharedPoint_2r ou_sptr() { return ou_; }
     SharedPoint_2r ov_sptr() { return ov_; }
     SharedPoint_2r ouv_sptr() { return ouv_; }
+    //! @brief Segment keys of the visualization, only kept while observed.
     const Segment_2r& u_segment() const;
     const Segment_2r& v_segment() const;
     const Triangle_2r& u_tri() const { return u_tri_; }
@@ -52,6 +55,9 @@ public:
     bool attached() const;
 
 private:
+    //! @brief Registers ou, ov and ouv and builds the segment keys.
+    void RegisterCorners();
+
     Vector_2r u_;
     Vector_2r v_;
     Segment_2r u_segment_;
@@ -76,6 +82,9 @@ public:
     WedgeStack_2r(SharedPoint_2r origin);
     ~WedgeStack_2r();
 
+    void AddObserver(Visual::IGeometryObserver* geom_observer) override;
+    void RemoveObserver(Visual::IGeometryObserver* geom_observer) override;
+
     /*
     void Push(const Wedge_2r& w);
     Wedge_2r Pop();
@@ -17,6 +17,7 @@
 #include "ui_point_set_creation_method.h"
 
 #include "common.h"
+#include "../geometry/pointbuffer.h"
 
 PointSetCreationMethod::PointSetCreationMethod(QWidget *parent) :
     QGroupBox(parent),
@@ -68,25 +69,26 @@ void PointSetCreationMethod::on_file_button_generate_clicked() {
     LOG(INFO) << "on_generate_clicked with file "
               << ui->file_name->text().toStdString();
 
-    QFile file(ui->file_name->text());
+    std::ifstream file(ui->file_name->text().toStdString());
 
     // error check
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file) {
         LOG(ERROR) << "Unable to open point set file.";
         return;
     }
 
     LOG(INFO) << "Successfully opened point set file. Continuing.";
 
+    DDAD::PointBuffer_3f buffer;
+    if (!DDAD::ReadPointBuffer(file, buffer)) {
+        LOG(WARNING) << "Point set file is malformed after "
+                     << buffer.size() << " points.";
+    }
+
     QVector<QVector3D> points;
-    QTextStream in(&file);
-
-    while (!in.atEnd()) {
-        QString line = in.readLine();
-        auto tokens = line.split(QRegularExpression("\\s+"), QString::SkipEmptyParts);
-        points.push_back(QVector3D(tokens.at(0).toFloat(),
-                                   tokens.at(1).toFloat(),
-                                   tokens.at(2).toFloat()));
+    points.reserve(static_cast<int>(buffer.size()));
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        points.push_back(QVector3D(buffer.x(i), buffer.y(i), buffer.z(i)));
     }
 
     emit CreatePointSet(points);
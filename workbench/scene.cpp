@@ -26,6 +26,8 @@
 #include "../geometry/matrix.h"
 #include "../geometry/line.h"
 #include "../geometry/intersection.h"
+#include "../geometry/mempool.h"
+#include "../geometry/approx.h"
 
 #include <ctime>
 
@@ -48,7 +50,26 @@ SceneObserver::~SceneObserver() {
     scene_objects_.clear();
 }
 
+//! @brief Converts the points that moved since the last snapshot together.
+void SceneObserver::RefreshApproxPoints() {
+    if (dirty_approx_points_.empty()) {
+        return;
+    }
+    std::vector<const Point_3r*> exact;
+    exact.reserve(dirty_approx_points_.size());
+    for (auto approx : dirty_approx_points_) {
+        exact.push_back(&approx->exact());
+    }
+    std::vector<float> coords(3*exact.size());
+    ApproxPoints(exact.data(), exact.size(), coords.data());
+    for (size_t i = 0; i < dirty_approx_points_.size(); ++i) {
+        dirty_approx_points_[i]->set_approx(&coords[3*i]);
+    }
+    dirty_approx_points_.clear();
+}
+
 void SceneObserver::GenerateVboPoints() {
+    RefreshApproxPoints();
     QVector<GL::Vertex> points;
     for (auto i = viz_points_.begin(); i != viz_points_.end(); ++i) {
         GL::Vertex v(approx_points_.value(i.key())->approx());
@@ -61,6 +82,7 @@ void SceneObserver::GenerateVboPoints() {
 }
 
 void SceneObserver::GenerateVboLines() {
+    RefreshApproxPoints();
     QVector<GL::Vertex> lines;
     for (auto i = viz_segments_.begin(); i != viz_segments_.end(); ++i) {
         GL::Vertex p(approx_points_.value(i.key().first)->approx());
@@ -76,6 +98,7 @@ void SceneObserver::GenerateVboLines() {
 }
 
 void SceneObserver::GenerateVboTriangles() {
+    RefreshApproxPoints();
     QVector<GL::Vertex> triangles;
     for (auto i = viz_triangles_.begin(); i != viz_triangles_.end(); ++i) {
         auto current_vt = i.value().top();
@@ -108,9 +131,8 @@ void SceneObserver::SlotRegisterPoint_2r(Point_2r &p) {
         p.set_unique_id(cur_point_uid_++);
     }
     if (!approx_points_.contains(p.unique_id())) {
-        auto approx = QSharedPointer<ApproxPoint_3f>(new ApproxPoint_3f(p));
+        auto approx = QSharedPointer<ApproxPoint_3f>(new ApproxPoint_3f(p, &dirty_approx_points_));
         approx_points_.insert(p.unique_id(), approx);
-        p.AddObserver(approx.data());
     }
 }
 
@@ -201,9 +223,8 @@ void SceneObserver::SlotRegisterPoint_3r(Point_3r &p) {
         p.set_unique_id(cur_point_uid_++);
     }
     if (!approx_points_.contains(p.unique_id())) {
-        auto approx = QSharedPointer<ApproxPoint_3f>(new ApproxPoint_3f(p));
+        auto approx = QSharedPointer<ApproxPoint_3f>(new ApproxPoint_3f(p, &dirty_approx_points_));
         approx_points_.insert(p.unique_id(), approx);
-        p.AddObserver(approx.data());
     }
 }
 
@@ -324,14 +345,30 @@ void SceneObserver::onEndCreatePolyline() {
                                      SelectedObject()->name());
 }
 
+//! @brief Logs the arithmetic pool counters of the run that just finished.
+static void LogArithmeticPoolStats(const char* algorithm) {
+    ArithmeticPoolStats stats = arithmetic_pool_stats();
+    LOG(DEBUG) << algorithm << ": " << stats.pooled_allocations
+               << " pooled allocations (" << stats.recycled_allocations
+               << " recycled), " << stats.system_allocations
+               << " system allocations, peak " << stats.peak_bytes
+               << " bytes";
+}
+
 void SceneObserver::onExecuteMelkman() {
+    ArithmeticPoolScope pool;
+    ResetArithmeticPoolStats();
     // TODO: capture resulting polygon to create scene object
     DDAD::Melkman(SelectedPolyline_2()->model_polyline(), this);
+    LogArithmeticPoolStats("Melkman");
 }
 
 void SceneObserver::onComputeMelkmanForSelectedPolyline() {
+    ArithmeticPoolScope pool;
+    ResetArithmeticPoolStats();
     // TODO: capture resulting polygon to create scene object
     DDAD::Melkman(SelectedPolyline_2()->model_polyline(), this);
+    LogArithmeticPoolStats("Melkman");
 }
 
 //=============================================================================
@@ -420,7 +457,10 @@ void SceneObserver::onCreatePointSet(const QVector<QVector3D>& data) {
 void SceneObserver::onComputeTerrainMeshForSelectedPointSet() {
     LOG(DEBUG) << "computing terrain mesh for selected point set...";
 
+    ArithmeticPoolScope pool;
+    ResetArithmeticPoolStats();
     DDAD::DelaunayTerrain(SelectedPointSet_3()->model_point_set(), this);
+    LogArithmeticPoolStats("DelaunayTerrain");
 }
 
 //=============================================================================
@@ -656,29 +696,71 @@ static Point_2f ToPoint_2f(const QVector2D &v, bool snap) {
 // ApproximatePoint_3f
 //=============================================================================
 
-ApproxPoint_3f::ApproxPoint_3f() {}
-
-ApproxPoint_3f::ApproxPoint_3f(const Point_2r &p) {
-    approx_.set_x(p.x().get_d());
-    approx_.set_y(p.y().get_d());
-    approx_.set_z(0);
+ApproxPoint_3f::ApproxPoint_3f() :
+    dirty_(nullptr),
+    unique_id_(0),
+    planar_(false),
+    queued_(false) {}
+
+//! @note Converts right away, since a point may be registered long before
+//! the next snapshot.
+ApproxPoint_3f::ApproxPoint_3f(const Point_2r &p,
+                               std::vector<ApproxPoint_3f*>* dirty) :
+    approx_(ApproxFloat(p.x()), ApproxFloat(p.y()), 0.0f),
+    exact_(p.x(), p.y(), rational(0)),
+    dirty_(dirty),
+    unique_id_(p.unique_id()),
+    planar_(true),
+    queued_(false) {
+    AddPointObserver(unique_id_, this);
+}
+
+ApproxPoint_3f::ApproxPoint_3f(const Point_3r &p,
+                               std::vector<ApproxPoint_3f*>* dirty) :
+    approx_(ApproxFloat(p.x()), ApproxFloat(p.y()), ApproxFloat(p.z())),
+    exact_(p.x(), p.y(), p.z()),
+    dirty_(dirty),
+    unique_id_(p.unique_id()),
+    planar_(false),
+    queued_(false) {
+    AddPointObserver(unique_id_, this);
+}
+
+ApproxPoint_3f::~ApproxPoint_3f() {
+    RemovePointObserver(unique_id_, this);
+    if (queued_) {
+        dirty_->erase(std::remove(dirty_->begin(), dirty_->end(), this),
+                      dirty_->end());
+    }
 }
 
-ApproxPoint_3f::ApproxPoint_3f(const Point_3r &p) {
-    approx_.set_x(p.x().get_d());
-    approx_.set_y(p.y().get_d());
-    approx_.set_z(p.z().get_d());
+void ApproxPoint_3f::MarkDirty() {
+    if (!queued_) {
+        dirty_->push_back(this);
+        queued_ = true;
+    }
 }
 
 void ApproxPoint_3f::SlotPositionChanged_2r(const Point_2r &p) {
-    approx_.set_x(p.x().get_d());
-    approx_.set_y(p.y().get_d());
+    exact_.set_x(p.x());
+    exact_.set_y(p.y());
+    MarkDirty();
 }
 
 void ApproxPoint_3f::SlotPositionChanged_3r(const Point_3r& p) {
-    approx_.set_x(p.x().get_d());
-    approx_.set_y(p.y().get_d());
-    approx_.set_z(p.z().get_d());
+    exact_.set_x(p.x());
+    exact_.set_y(p.y());
+    exact_.set_z(p.z());
+    MarkDirty();
+}
+
+void ApproxPoint_3f::set_approx(const float* xyz) {
+    approx_.set_x(xyz[0]);
+    approx_.set_y(xyz[1]);
+    if (!planar_) {
+        approx_.set_z(xyz[2]);
+    }
+    queued_ = false;
 }
 
 const Point_3f& ApproxPoint_3f::approx() const {
@@ -45,20 +45,43 @@ namespace DDAD {
 // Interface: ApproximatePoint_3f
 //=============================================================================
 
+/*!
+ * @brief Float position of an observed point for rendering. A position
+ * change only records the exact position and queues this point on the dirty
+ * list of its SceneObserver, which converts the queued points in one pass
+ * when it builds a snapshot. 2D points take their z from the z order.
+ * Observes the point it was built from for its lifetime.
+ */
 class ApproxPoint_3f : public IPointObserver {
 public:
     ApproxPoint_3f();
-    ApproxPoint_3f(const Point_2r& p);
-    ApproxPoint_3f(const Point_3r& p);
+    ApproxPoint_3f(const Point_2r& p, std::vector<ApproxPoint_3f*>* dirty);
+    ApproxPoint_3f(const Point_3r& p, std::vector<ApproxPoint_3f*>* dirty);
+    ~ApproxPoint_3f();
 
     void SlotPositionChanged_2r(const Point_2r& p) override;
     void SlotPositionChanged_3r(const Point_3r& p) override;
     void set_z_order(const int32_t z_order) { approx_.set_z(z_order); }
 
+    //! @brief As of the last call to set_approx.
     const Point_3f& approx() const;
+    //! @brief Exact position as of the last position change.
+    const Point_3r& exact() const { return exact_; }
+    //! @brief Takes x, y and, for 3D points, z from xyz.
+    void set_approx(const float* xyz);
 
 private:
+    void MarkDirty();
+
     Point_3f approx_;
+    Point_3r exact_;
+    std::vector<ApproxPoint_3f*>* dirty_;
+    uint32_t unique_id_;
+    bool planar_;
+    bool queued_;
+
+    ApproxPoint_3f(const ApproxPoint_3f&);
+    ApproxPoint_3f& operator=(const ApproxPoint_3f&);
 };
 
 //=============================================================================
@@ -483,6 +506,7 @@ signals:
                                      const QString& selected_obj_name);
 
 private:
+    void RefreshApproxPoints();
     void GenerateVboPoints();
     void GenerateVboLines();
     void GenerateVboTriangles();
@@ -500,6 +524,9 @@ private:
     QVector<QSharedPointer<ISceneObject>> selected_objects_;
 
     quint32 cur_point_uid_;
+    // declared before approx_points_ so that it outlives the points, which
+    // erase themselves from it when destroyed while queued
+    std::vector<ApproxPoint_3f*> dirty_approx_points_;
     QHash<uint32_t, QSharedPointer<ApproxPoint_3f>> approx_points_;
     QHash<uint32_t, QStack<Visual::Point>> viz_points_;
     QMap<QPair<uint32_t, uint32_t>, QStack<Visual::Segment>> viz_segments_;